@@ -28,38 +28,14 @@
 #include "veins/base/connectionManager/NicEntryDirect.h"
 #include "veins/base/modules/BaseWorldUtility.h"
 #include "veins/base/utils/FindModule.h"
+#include "veins/modules/mobility/traci/TraCIScenarioManager.h"
 
-using namespace veins;
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
 
-namespace {
-/**
- * On a torus the end and the begin of the axes are connected so you
- * get a circle. On a circle the distance between two points can't be greater
- * than half of the circumference.
- * If the normal distance between two points on one axis is bigger than
- * half of the size there must be a "shorter way" over the border on this axis
- */
-static double dist(double coord1, double coord2, double size)
-{
-    double difference = fabs(coord1 - coord2);
-    if (difference == 0)
-        // NOTE: event if size is zero
-        return 0;
-    else {
-        ASSERT(size != 0);
-        double dist = FWMath::modulo(difference, size);
-        return std::min(dist, size - dist);
-    }
-}
-
-double sqrTorusDist(Coord c, Coord b, Coord size)
-{
-    double xDist = dist(c.x, b.x, size.x);
-    double yDist = dist(c.y, b.y, size.y);
-    double zDist = dist(c.z, b.z, size.z);
-    return xDist * xDist + yDist * yDist + zDist * zDist;
-}
-} // namespace
+using namespace veins;
 
 void BaseConnectionManager::initialize(int stage)
 {
@@ -82,237 +58,466 @@ void BaseConnectionManager::initialize(int stage)
         else
             sendDirect = false;
 
-        maxInterferenceDistance = calcInterfDist();
-        maxDistSquared = maxInterferenceDistance * maxInterferenceDistance;
+        batchUpdates = hasPar("batchConnectionUpdates") ? par("batchConnectionUpdates").boolValue() : false;
+        if (batchUpdates) {
+            getSimulation()->getSystemModule()->subscribe(TraCIScenarioManager::traciTimestepEndSignal, this);
 
-        // ----initialize node grid-----
-        // step 1 - calculate dimension of grid
-        // one cell should have at least the size of maxInterferenceDistance
-        // but also should divide the playground in equal parts
-        Coord dim((*playgroundSize) / maxInterferenceDistance);
-        gridDim = GridCoord(dim);
-
-        // A grid smaller or equal to 3x3 would mean that every cell has every
-        // other cell as direct neighbor (if our playground is a torus, even if
-        // not the most of the cells are direct neighbors of each other. So we
-        // reduce the grid size to 1x1.
-        if ((gridDim.x <= 3) && (gridDim.y <= 3) && (gridDim.z <= 3)) {
-            gridDim.x = 1;
-            gridDim.y = 1;
-            gridDim.z = 1;
+            int numThreads = hasPar("connectionUpdateThreads") ? par("connectionUpdateThreads").intValue() : 1;
+            if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+            if (numThreads < 0) throw cRuntimeError("connectionUpdateThreads must not be negative");
+            workerPool.start(numThreads);
+            threadDiffs.resize(numThreads);
         }
-        else {
-            gridDim.x = std::max(1, gridDim.x);
-            gridDim.y = std::max(1, gridDim.y);
-            gridDim.z = std::max(1, gridDim.z);
+        spatialPartitioning = batchUpdates && hasPar("spatialPartitioning") && par("spatialPartitioning").boolValue();
+
+        collectStatistics = hasPar("collectStatistics") ? par("collectStatistics").boolValue() : false;
+        statisticsReportFile = hasPar("statisticsReportFile") ? par("statisticsReportFile").stdstringValue() : "";
+        if (collectStatistics) {
+            int maxFanOut = par("statisticsMaxFanOut").intValue();
+            if (maxFanOut < 0) throw cRuntimeError("statisticsMaxFanOut must not be negative");
+            statistics.configureFanOut(maxFanOut);
         }
+        wallClockStart = std::chrono::steady_clock::now();
 
-        // step 2 - initialize the matrix which represents our grid
-        NicEntries entries;
-        RowVector row;
-        NicMatrix matrix;
+        kineticUpdates = hasPar("kineticConnectionUpdates") ? par("kineticConnectionUpdates").boolValue() : false;
+        if (kineticUpdates && !batchUpdates) throw cRuntimeError("kineticConnectionUpdates requires batchConnectionUpdates");
 
-        for (int i = 0; i < gridDim.z; ++i) {
-            row.push_back(entries); // copy empty NicEntries to RowVector
+        maxInterferenceDistance = calcInterfDist();
+        maxDistSquared = maxInterferenceDistance * maxInterferenceDistance;
+
+        // ----initialize node grid-----
+        // the neighborhood of a cell covers maxInterferenceDistance
+        // (plus the margin in kinetic mode, which determines how often neighborhoods are scanned)
+        double kineticCellMargin = 0;
+        if (kineticUpdates) {
+            kineticMaxSpeed = par("kineticMaxSpeed").doubleValue();
+            kineticCellMargin = par("kineticCellMargin").doubleValue();
+            if (kineticMaxSpeed <= 0) throw cRuntimeError("kineticMaxSpeed must be positive");
+            if (kineticCellMargin <= 0) throw cRuntimeError("kineticCellMargin must be positive");
         }
-        for (int i = 0; i < gridDim.y; ++i) { // fill the ColVector with copies of
-            matrix.push_back(row); // the RowVector.
+        double cellSizeFactor = hasPar("gridCellSizeFactor") ? par("gridCellSizeFactor").doubleValue() : 1;
+        if (cellSizeFactor <= 0 || cellSizeFactor > 1) throw cRuntimeError("gridCellSizeFactor must be in (0, 1]");
+        nicGrid.configure(*playgroundSize, maxInterferenceDistance + kineticCellMargin, useTorus, cellSizeFactor);
+        int subdivisions = hasPar("gridSubdivisions") ? par("gridSubdivisions").intValue() : 1;
+        if (subdivisions < 1) throw cRuntimeError("gridSubdivisions must be positive");
+        if (subdivisions > 1) {
+            int threshold = par("gridSubdivisionThreshold").intValue();
+            if (threshold < 0) throw cRuntimeError("gridSubdivisionThreshold must not be negative");
+            nicGrid.configureSubdivision(subdivisions, threshold);
         }
-        for (int i = 0; i < gridDim.x; ++i) { // fill the grid with copies of
-            nicGrid.push_back(matrix); // the matrix.
+        EV_TRACE << " using " << nicGrid.getDimX() << "x" << nicGrid.getDimY() << "x" << nicGrid.getDimZ() << " grid" << endl;
+        EV_TRACE << "cell size is " << nicGrid.getCellSize().info() << endl;
+
+        if (kineticUpdates) {
+            // nics outside the neighborhood of a nic are beyond the enlarged reach (or there are none)
+            kineticRescanInterval = (nicGrid.getMinOutsideDistance() - maxInterferenceDistance) / (2 * kineticMaxSpeed);
+            EV_TRACE << "kinetic rescan interval is " << kineticRescanInterval << " s" << endl;
         }
-        EV_TRACE << " using " << gridDim.x << "x" << gridDim.y << "x" << gridDim.z << " grid" << endl;
-
-        // step 3 -    calculate the factor which maps the coordinate of a node
-        //            to the grid cell
-        // if we use a 1x1 grid every coordinate is mapped to (0,0, 0)
-        findDistance = Coord(std::max(playgroundSize->x, maxInterferenceDistance), std::max(playgroundSize->y, maxInterferenceDistance), std::max(playgroundSize->z, maxInterferenceDistance));
-        // otherwise we divide the playground into cells of size of the maximum
-        // interference distance
-        if (gridDim.x != 1) findDistance.x = playgroundSize->x / gridDim.x;
-        if (gridDim.y != 1) findDistance.y = playgroundSize->y / gridDim.y;
-        if (gridDim.z != 1) findDistance.z = playgroundSize->z / gridDim.z;
-
-        // since the upper playground borders (at pg-size) are part of the
-        // playground we have to assure that they are mapped to a valid
-        // (the last) grid cell we do this by increasing the find distance
-        // by a small value.
-        // This also assures that findDistance is never zero.
-        const auto epsilon = 0.001;
-        findDistance += Coord(epsilon, epsilon, epsilon);
-
-        // findDistance (equals cell size) has to be greater or equal
-        // maxInt-distance
-        ASSERT(findDistance.x >= maxInterferenceDistance);
-        ASSERT(findDistance.y >= maxInterferenceDistance);
-        ASSERT(findDistance.z >= maxInterferenceDistance);
-
-        // playGroundSize has to be part of the playGround
-        ASSERT(GridCoord(*playgroundSize, findDistance).x == gridDim.x - 1);
-        ASSERT(GridCoord(*playgroundSize, findDistance).y == gridDim.y - 1);
-        ASSERT(GridCoord(*playgroundSize, findDistance).z == gridDim.z - 1);
-        EV_TRACE << "findDistance is " << findDistance.info() << endl;
     }
     else if (stage == 1) {
     }
 }
 
-BaseConnectionManager::GridCoord BaseConnectionManager::getCellForCoordinate(const Coord& c)
+void BaseConnectionManager::finish()
 {
-    return GridCoord(c, findDistance);
+    if (batchUpdates) {
+        getSimulation()->getSystemModule()->unsubscribe(TraCIScenarioManager::traciTimestepEndSignal, this);
+        workerPool.stop();
+    }
+
+    if (!collectStatistics) return;
+
+    recordScalar("positionUpdates", statistics.positionUpdates);
+    recordScalar("batchUpdates", statistics.batchUpdates);
+    recordScalar("connects", statistics.connects);
+    recordScalar("disconnects", statistics.disconnects);
+    recordScalar("rangeTests", statistics.rangeTests);
+    recordScalar("cellsVisited", statistics.cellsVisited);
+    for (int i = 0; i < ConnectionManagerStatistics::NUM_PHASES; i++) {
+        auto phase = static_cast<ConnectionManagerStatistics::Phase>(i);
+        recordScalar((std::string(ConnectionManagerStatistics::getPhaseName(phase)) + "Seconds").c_str(), statistics.getPhaseSeconds(phase), "s");
+        recordScalar((std::string(ConnectionManagerStatistics::getPhaseName(phase)) + "Calls").c_str(), statistics.getPhaseCalls(phase));
+    }
+
+    const StreamingHistogram& fanOut = statistics.getFanOut();
+    recordScalar("transmissions", fanOut.getCount());
+    recordScalar("fanOutFrames", fanOut.getSum());
+    recordScalar("fanOutCulled", statistics.getFanOutCulled());
+    recordScalar("fanOutMean", fanOut.getMean());
+    recordScalar("fanOutMax", fanOut.getMax());
+
+    if (!statisticsReportFile.empty()) {
+        std::ofstream report(statisticsReportFile);
+        if (!report) throw cRuntimeError("Could not open statistics report file '%s'", statisticsReportFile.c_str());
+        statistics.writeJson(report, std::chrono::duration<double>(std::chrono::steady_clock::now() - wallClockStart).count());
+    }
 }
 
-void BaseConnectionManager::updateConnections(int nicID, Coord oldPos, Coord newPos)
+void BaseConnectionManager::finish(cComponent* component, simsignal_t signalID)
 {
-    GridCoord oldCell = getCellForCoordinate(oldPos);
-    GridCoord newCell = getCellForCoordinate(newPos);
+    cListener::finish(component, signalID);
+}
 
-    checkGrid(oldCell, newCell, nicID);
+void BaseConnectionManager::receiveSignal(cComponent* source, simsignal_t signalID, const SimTime& t, cObject* details)
+{
+    if (signalID == TraCIScenarioManager::traciTimestepEndSignal) {
+        applyPendingMoves();
+    }
 }
 
-BaseConnectionManager::NicEntries& BaseConnectionManager::getCellEntries(BaseConnectionManager::GridCoord& cell)
+void BaseConnectionManager::updateConnections(int nicID, Coord oldPos, Coord newPos)
 {
-    return nicGrid[cell.x][cell.y][cell.z];
+    ConnectionManagerStatistics::PhaseTimer timer(getStatistics(), ConnectionManagerStatistics::POSITION_UPDATE);
+    statistics.positionUpdates++;
+
+    NicEntry* nic = nics[nicID];
+
+    // no cells are in use between updates, so sparse cells can be merged now
+    nicGrid.rebalance();
+
+    // move nic to its new position in the grid
+    int oldCell = nicGrid.getCell(nic->gridSlot);
+    nicGrid.move(nic->gridSlot, newPos);
+
+    // in batch mode, the connections are updated later
+    if (batchUpdates) {
+        if (kineticUpdates) {
+            // nics keeping to the speed bound are covered by their certificates
+            double now = simTime().dbl();
+            double maxMove = kineticMaxSpeed * (now - slotLastMoveTime[nic->gridSlot]);
+            bool keepsSpeedBound = slotLastMoveTime[nic->gridSlot] >= 0 && oldPos.sqrdist(newPos) <= maxMove * maxMove;
+            slotLastMoveTime[nic->gridSlot] = now;
+            if (keepsSpeedBound) return;
+        }
+        if (slotPendingIndex[nic->gridSlot] == -1) {
+            slotPendingIndex[nic->gridSlot] = static_cast<int>(pendingSlots.size());
+            pendingSlots.push_back(nic->gridSlot);
+        }
+        return;
+    }
+
+    int newCell = nicGrid.getCell(nic->gridSlot);
+
+    // find union of grid cells around old and new position
+    cellBuffer.clear();
+    nicGrid.addNeighborCells(oldCell, cellBuffer);
+    if (oldCell != newCell) {
+        nicGrid.addNeighborCells(newCell, cellBuffer);
+    }
+
+    statistics.cellsVisited += cellBuffer.size();
+    for (size_t i = 0; i < cellBuffer.size(); i++) {
+        EV_TRACE << "Update cons in [" << cellBuffer[i] << "]" << endl;
+        updateNicConnections(nicGrid.getCellSlots(cellBuffer[i]), nic);
+    }
 }
 
 void BaseConnectionManager::registerNicExt(int nicID)
 {
-    NicEntries::mapped_type nicEntry = nics[nicID];
+    NicEntry* nicEntry = nics[nicID];
+
+    // add to grid
+    nicEntry->gridSlot = nicGrid.insert(nicID, nicEntry->pos);
+    if (gridNics.size() <= static_cast<size_t>(nicEntry->gridSlot)) {
+        gridNics.resize(nicEntry->gridSlot + 1);
+        slotPendingIndex.resize(nicEntry->gridSlot + 1, -1);
+        slotEpoch.resize(nicEntry->gridSlot + 1, 0);
+        slotLastMoveTime.resize(nicEntry->gridSlot + 1);
+    }
+    gridNics[nicEntry->gridSlot] = nicEntry;
+    slotLastMoveTime[nicEntry->gridSlot] = -1;
+
+    EV_TRACE << " registering (ext) nic at cell " << nicGrid.getCell(nicEntry->gridSlot) << std::endl;
+}
+
+bool BaseConnectionManager::isInRange(const NicEntry* pFromNic, const NicEntry* pToNic)
+{
+    return nicGrid.sqrDist(pFromNic->gridSlot, pToNic->gridSlot) <= maxDistSquared;
+}
 
-    GridCoord cell = getCellForCoordinate(nicEntry->pos);
+void BaseConnectionManager::updateNicConnections(const std::vector<int>& cellSlots, NicEntry* nic)
+{
+    int slot = nic->gridSlot;
+
+    for (int otherSlot : cellSlots) {
+        // no recursive connections
+        if (otherSlot == slot) continue;
 
-    EV_TRACE << " registering (ext) nic at loc " << cell.info() << std::endl;
+        NicEntry* nic_i = gridNics[otherSlot];
 
-    // add to matrix
-    NicEntries& cellEntries = getCellEntries(cell);
-    cellEntries[nicID] = nicEntry;
+        statistics.rangeTests++;
+        bool inRange = isInRange(nic, nic_i);
+        bool connected = nic->isConnected(nic_i);
+
+        if (inRange && !connected) {
+            // nodes within communication range: connect
+            // nodes within communication range && not yet connected
+            EV_TRACE << "nic #" << nic->nicId << " and #" << nic_i->nicId << " are in range" << endl;
+            statistics.connects++;
+            nic->connectTo(nic_i);
+            nic_i->connectTo(nic);
+        }
+        else if (!inRange && connected) {
+            // out of range: disconnect
+            // out of range, and still connected
+            EV_TRACE << "nic #" << nic->nicId << " and #" << nic_i->nicId << " are NOT in range" << endl;
+            disconnectNics(nic, nic_i);
+        }
+    }
 }
 
-void BaseConnectionManager::checkGrid(BaseConnectionManager::GridCoord& oldCell, BaseConnectionManager::GridCoord& newCell, int id)
+void BaseConnectionManager::disconnectNics(NicEntry* nic, NicEntry* other)
+{
+    statistics.disconnects++;
+    nic->disconnectFrom(other);
+    other->disconnectFrom(nic);
+}
 
+/**
+ * Every pair of nics of which at least one has moved is evaluated once, by
+ * the moved nic coming first in pendingSlots: its current connections are
+ * checked for nics now out of range, and the nics in its neighborhood for
+ * nics now in range. As the connections are only read while computing the
+ * changes, the moved nics can be distributed over several threads.
+ */
+void BaseConnectionManager::updatePendingConnections()
 {
+    if (kineticUpdates) {
+        updateKineticConnections();
+        return;
+    }
 
-    // structure to find union of grid squares
-    CoordSet gridUnion(74);
+    EV_TRACE << "updating connections of " << pendingSlots.size() << " moved nics" << endl;
+    statistics.batchUpdates++;
 
-    // find nic at old position
-    NicEntries& oldCellEntries = getCellEntries(oldCell);
-    NicEntries::iterator it = oldCellEntries.find(id);
-    NicEntries::mapped_type nic = it->second;
+    {
+        ConnectionManagerStatistics::PhaseTimer timer(getStatistics(), ConnectionManagerStatistics::COMPUTE_DIFFS);
 
-    // move nic to a new position in matrix
-    if (oldCell != newCell) {
-        oldCellEntries.erase(it);
-        getCellEntries(newCell)[id] = nic;
+        for (auto& diffs : threadDiffs) {
+            diffs.toConnect.clear();
+            diffs.toDisconnect.clear();
+            diffs.rangeTests = 0;
+            diffs.cellsVisited = 0;
+        }
+
+        if (spatialPartitioning) partitionPendingSlots();
+
+        // hand out moved nics in chunks, as their neighborhoods differ in size
+        const size_t chunkSize = 64;
+        if (workerPool.getNumThreads() == 1 || pendingSlots.size() <= chunkSize) {
+            for (size_t i = 0; i < pendingSlots.size(); i++) computePendingDiffs(i, threadDiffs[0]);
+        }
+        else {
+            std::atomic<size_t> nextChunk(0);
+            workerPool.run([&](size_t threadIndex) {
+                while (true) {
+                    size_t begin = nextChunk.fetch_add(chunkSize);
+                    if (begin >= pendingSlots.size()) return;
+                    size_t end = std::min(begin + chunkSize, pendingSlots.size());
+                    for (size_t i = begin; i < end; i++) computePendingDiffs(i, threadDiffs[threadIndex]);
+                }
+            });
+        }
+
+        for (auto& diffs : threadDiffs) {
+            statistics.rangeTests += diffs.rangeTests;
+            statistics.cellsVisited += diffs.cellsVisited;
+        }
     }
 
-    if ((gridDim.x == 1) && (gridDim.y == 1) && (gridDim.z == 1)) {
-        gridUnion.add(oldCell);
+    {
+        ConnectionManagerStatistics::PhaseTimer timer(getStatistics(), ConnectionManagerStatistics::APPLY_DIFFS);
+
+        // apply the changes in a deterministic order
+        mergeDiffs(&ThreadDiffs::toDisconnect);
+        statistics.disconnects += mergedDiffs.size();
+        applyMergedDiffs(false);
+        mergeDiffs(&ThreadDiffs::toConnect);
+        statistics.connects += mergedDiffs.size();
+        applyMergedDiffs(true);
     }
-    else {
-        // add grid around oldPos
-        fillUnionWithNeighbors(gridUnion, oldCell);
 
-        if (oldCell != newCell) {
-            // add grid around newPos
-            fillUnionWithNeighbors(gridUnion, newCell);
-        }
+    for (int slot : pendingSlots) {
+        slotPendingIndex[slot] = -1;
+    }
+    pendingSlots.clear();
+}
+
+void BaseConnectionManager::partitionPendingSlots()
+{
+    pendingOrder.clear();
+    for (int slot : pendingSlots) {
+        pendingOrder.push_back(std::make_pair(nicGrid.getSpatialKey(slot), slot));
     }
+    std::sort(pendingOrder.begin(), pendingOrder.end());
 
-    GridCoord* c = gridUnion.next();
-    while (c != nullptr) {
-        EV_TRACE << "Update cons in [" << c->info() << "]" << endl;
-        updateNicConnections(getCellEntries(*c), nic);
-        c = gridUnion.next();
+    for (size_t i = 0; i < pendingOrder.size(); i++) {
+        int slot = pendingOrder[i].second;
+        pendingSlots[i] = slot;
+        slotPendingIndex[slot] = static_cast<int>(i);
     }
 }
 
-int BaseConnectionManager::wrapIfTorus(int value, int max)
+void BaseConnectionManager::computePendingDiffs(size_t pendingIndex, ThreadDiffs& diffs)
 {
-    if (value < 0) {
-        if (useTorus) {
-            return max + value;
-        }
-        else {
-            return -1;
-        }
+    int slot = pendingSlots[pendingIndex];
+    NicEntry* nic = gridNics[slot];
+
+    // pairs with a moved nic coming earlier in pendingSlots are evaluated by that nic
+    auto evaluatedByOther = [&](int otherSlot) {
+        int otherIndex = slotPendingIndex[otherSlot];
+        return otherIndex != -1 && static_cast<size_t>(otherIndex) < pendingIndex;
+    };
+
+    // connections to nics out of range
+    for (auto& connection : nic->getGateList()) {
+        int otherSlot = connection.nic->gridSlot;
+        if (evaluatedByOther(otherSlot)) continue;
+        diffs.rangeTests++;
+        if (!isInRange(nic, connection.nic)) diffs.toDisconnect.push_back(ConnectionDiff(nic, gridNics[otherSlot]));
     }
-    else if (value >= max) {
-        if (useTorus) {
-            return value - max;
-        }
-        else {
-            return -1;
+
+    // nics in range not connected yet
+    diffs.cells.clear();
+    nicGrid.addNeighborCells(nicGrid.getCell(slot), diffs.cells);
+    diffs.cellsVisited += diffs.cells.size();
+    for (size_t i = 0; i < diffs.cells.size(); i++) {
+        for (int otherSlot : nicGrid.getCellSlots(diffs.cells[i])) {
+            if (otherSlot == slot || evaluatedByOther(otherSlot)) continue;
+
+            NicEntry* other = gridNics[otherSlot];
+            diffs.rangeTests++;
+            if (isInRange(nic, other) && !nic->isConnected(other)) diffs.toConnect.push_back(ConnectionDiff(nic, other));
         }
     }
-    else {
-        return value;
+}
+
+void BaseConnectionManager::mergeDiffs(std::vector<ConnectionDiff> ThreadDiffs::*member)
+{
+    mergedDiffs.clear();
+    for (auto& diffs : threadDiffs) {
+        mergedDiffs.insert(mergedDiffs.end(), (diffs.*member).begin(), (diffs.*member).end());
     }
+    std::sort(mergedDiffs.begin(), mergedDiffs.end());
 }
 
-void BaseConnectionManager::fillUnionWithNeighbors(CoordSet& gridUnion, GridCoord cell)
+void BaseConnectionManager::applyMergedDiffs(bool connect)
 {
-    for (int iz = (int) cell.z - 1; iz <= (int) cell.z + 1; iz++) {
-        int cz = wrapIfTorus(iz, gridDim.z);
-        if (cz == -1) {
-            continue;
+    gateListChanges.clear();
+    for (auto& diff : mergedDiffs) {
+        EV_TRACE << "nic #" << diff.nicA->nicId << " and #" << diff.nicB->nicId << (connect ? " are in range" : " are NOT in range") << endl;
+        gateListChanges.push_back(std::make_pair(diff.nicA, diff.nicB));
+        gateListChanges.push_back(std::make_pair(diff.nicB, diff.nicA));
+    }
+    std::sort(gateListChanges.begin(), gateListChanges.end(), [](const std::pair<NicEntry*, NicEntry*>& a, const std::pair<NicEntry*, NicEntry*>& b) {
+        if (a.first->nicId != b.first->nicId) return a.first->nicId < b.first->nicId;
+        return a.second->nicId < b.second->nicId;
+    });
+
+    for (size_t begin = 0; begin < gateListChanges.size();) {
+        NicEntry* nic = gateListChanges[begin].first;
+        gateListChangeNics.clear();
+        size_t end = begin;
+        for (; end < gateListChanges.size() && gateListChanges[end].first == nic; end++) {
+            gateListChangeNics.push_back(gateListChanges[end].second);
         }
-        for (int ix = (int) cell.x - 1; ix <= (int) cell.x + 1; ix++) {
-            int cx = wrapIfTorus(ix, gridDim.x);
-            if (cx == -1) {
-                continue;
-            }
-            for (int iy = (int) cell.y - 1; iy <= (int) cell.y + 1; iy++) {
-                int cy = wrapIfTorus(iy, gridDim.y);
-                if (cy != -1) {
-                    gridUnion.add(GridCoord(cx, cy, cz));
-                }
-            }
+        if (connect) {
+            nic->connectToAll(gateListChangeNics);
         }
+        else {
+            nic->disconnectFromAll(gateListChangeNics);
+        }
+        begin = end;
     }
 }
 
-bool BaseConnectionManager::isInRange(BaseConnectionManager::NicEntries::mapped_type pFromNic, BaseConnectionManager::NicEntries::mapped_type pToNic)
+void BaseConnectionManager::updateKineticConnections()
 {
-    double dDistance = 0.0;
+    ConnectionManagerStatistics::PhaseTimer timer(getStatistics(), ConnectionManagerStatistics::KINETIC_UPDATE);
+    statistics.batchUpdates++;
 
-    if (useTorus) {
-        dDistance = sqrTorusDist(pFromNic->pos, pToNic->pos, *playgroundSize);
+    double now = simTime().dbl();
+
+    // nics which are new or have violated the speed bound
+    for (int slot : pendingSlots) {
+        scanKineticNeighborhood(slot, now);
+        slotPendingIndex[slot] = -1;
     }
-    else {
-        dDistance = pFromNic->pos.sqrdist(pToNic->pos);
+    pendingSlots.clear();
+
+    // expired certificates (certificates issued while handling them expire at the next update at the earliest)
+    expiredCertificates.clear();
+    while (!kineticCertificates.empty() && kineticCertificates.top().expiry <= now) {
+        expiredCertificates.push_back(kineticCertificates.top());
+        kineticCertificates.pop();
+    }
+    EV_TRACE << "re-checking " << expiredCertificates.size() << " expired kinetic certificates" << endl;
+
+    for (auto& certificate : expiredCertificates) {
+        if (slotEpoch[certificate.slotA] != certificate.epochA) continue;
+        if (certificate.slotB == -1) {
+            scanKineticNeighborhood(certificate.slotA, now);
+        }
+        else if (slotEpoch[certificate.slotB] == certificate.epochB) {
+            checkKineticPair(certificate.slotA, certificate.slotB, now);
+        }
     }
-    return (dDistance <= maxDistSquared);
 }
 
-void BaseConnectionManager::updateNicConnections(NicEntries& nmap, BaseConnectionManager::NicEntries::mapped_type nic)
+void BaseConnectionManager::scanKineticNeighborhood(int slot, double now)
 {
-    int id = nic->nicId;
+    // outdates all certificates of the nic
+    slotEpoch[slot]++;
 
-    for (NicEntries::iterator i = nmap.begin(); i != nmap.end(); ++i) {
-        NicEntries::mapped_type nic_i = i->second;
+    NicEntry* nic = gridNics[slot];
 
-        // no recursive connections
-        if (nic_i->nicId == id) continue;
-
-        bool inRange = isInRange(nic, nic_i);
-        bool connected = nic->isConnected(nic_i);
+    // connections to nics outside of the neighborhood (e.g., after a jump)
+    kineticConnectionsToDrop.clear();
+    statistics.rangeTests += nic->getGateList().size();
+    for (auto& connection : nic->getGateList()) {
+        if (!isInRange(nic, connection.nic)) kineticConnectionsToDrop.push_back(gridNics[connection.nic->gridSlot]);
+    }
+    for (NicEntry* other : kineticConnectionsToDrop) {
+        EV_TRACE << "nic #" << nic->nicId << " and #" << other->nicId << " are NOT in range" << endl;
+        disconnectNics(nic, other);
+    }
 
-        if (inRange && !connected) {
-            // nodes within communication range: connect
-            // nodes within communication range && not yet connected
-            EV_TRACE << "nic #" << id << " and #" << nic_i->nicId << " are in range" << endl;
-            nic->connectTo(nic_i);
-            nic_i->connectTo(nic);
-        }
-        else if (!inRange && connected) {
-            // out of range: disconnect
-            // out of range, and still connected
-            EV_TRACE << "nic #" << id << " and #" << nic_i->nicId << " are NOT in range" << endl;
-            nic->disconnectFrom(nic_i);
-            nic_i->disconnectFrom(nic);
+    cellBuffer.clear();
+    nicGrid.addNeighborCells(nicGrid.getCell(slot), cellBuffer);
+    statistics.cellsVisited += cellBuffer.size();
+    for (size_t i = 0; i < cellBuffer.size(); i++) {
+        for (int otherSlot : nicGrid.getCellSlots(cellBuffer[i])) {
+            if (otherSlot != slot) checkKineticPair(slot, otherSlot, now);
         }
     }
+
+    if (kineticRescanInterval != std::numeric_limits<double>::infinity()) {
+        kineticCertificates.push({now + kineticRescanInterval, slot, -1, slotEpoch[slot], 0});
+    }
+}
+
+void BaseConnectionManager::checkKineticPair(int slotA, int slotB, double now)
+{
+    NicEntry* nicA = gridNics[slotA];
+    NicEntry* nicB = gridNics[slotB];
+
+    statistics.rangeTests++;
+    bool inRange = isInRange(nicA, nicB);
+    bool connected = nicA->isConnected(nicB);
+    if (inRange && !connected) {
+        EV_TRACE << "nic #" << nicA->nicId << " and #" << nicB->nicId << " are in range" << endl;
+        statistics.connects++;
+        nicA->connectTo(nicB);
+        nicB->connectTo(nicA);
+    }
+    else if (!inRange && connected) {
+        EV_TRACE << "nic #" << nicA->nicId << " and #" << nicB->nicId << " are NOT in range" << endl;
+        disconnectNics(nicA, nicB);
+    }
+
+    double distance = sqrt(nicGrid.sqrDist(slotA, slotB));
+    double expiry = now + fabs(distance - maxInterferenceDistance) / (2 * kineticMaxSpeed);
+    kineticCertificates.push({expiry, slotA, slotB, slotEpoch[slotA], slotEpoch[slotB]});
 }
 
 bool BaseConnectionManager::registerNic(cModule* nic, ChannelAccess* chAccess, Coord nicPos, Heading heading)
@@ -365,34 +570,29 @@ bool BaseConnectionManager::unregisterNic(cModule* nicModule)
     ASSERT(nics.find(nicID) != nics.end());
     NicEntries::mapped_type nicEntry = nics[nicID];
 
-    // get all affected grid squares
-    CoordSet gridUnion(74);
-    GridCoord cell = getCellForCoordinate(nicEntry->pos);
-    if ((gridDim.x == 1) && (gridDim.y == 1) && (gridDim.z == 1)) {
-        gridUnion.add(cell);
-    }
-    else {
-        fillUnionWithNeighbors(gridUnion, cell);
-    }
-
-    // disconnect from all NICs in these grid squares
-    GridCoord* c = gridUnion.next();
-    while (c != nullptr) {
-        EV_TRACE << "Update cons in [" << c->info() << "]" << endl;
-        NicEntries& nmap = getCellEntries(*c);
-        for (NicEntries::iterator i = nmap.begin(); i != nmap.end(); ++i) {
-            NicEntries::mapped_type other = i->second;
-            if (other == nicEntry) continue;
-            if (!other->isConnected(nicEntry)) continue;
-            other->disconnectFrom(nicEntry);
-            nicEntry->disconnectFrom(other);
-        }
-        c = gridUnion.next();
+    // outdate its kinetic certificates
+    slotEpoch[nicEntry->gridSlot]++;
+
+    // forget pending moves of the nic
+    int pendingIndex = slotPendingIndex[nicEntry->gridSlot];
+    if (pendingIndex != -1) {
+        pendingSlots.erase(pendingSlots.begin() + pendingIndex);
+        for (size_t i = pendingIndex; i < pendingSlots.size(); i++) slotPendingIndex[pendingSlots[i]] = static_cast<int>(i);
+        slotPendingIndex[nicEntry->gridSlot] = -1;
+    }
+
+    // disconnect from all connected NICs
+    std::vector<const NicEntry*> connected;
+    for (auto& connection : nicEntry->getGateList()) {
+        connected.push_back(connection.nic);
+    }
+    for (const NicEntry* other : connected) {
+        disconnectNics(gridNics[other->gridSlot], nicEntry);
     }
 
     // erase from grid
-    NicEntries& cellEntries = getCellEntries(cell);
-    cellEntries.erase(nicID);
+    nicGrid.remove(nicEntry->gridSlot);
+    gridNics[nicEntry->gridSlot] = nullptr;
 
     // erase from list of known nics
     nics.erase(nicID);
@@ -414,22 +614,45 @@ void BaseConnectionManager::updateNicPos(int nicID, Coord newPos, Heading headin
     updateConnections(nicID, oldPos, newPos);
 }
 
-const NicEntry::GateList& BaseConnectionManager::getGateList(int nicID) const
+const NicEntry::GateList& BaseConnectionManager::getGateList(int nicID)
 {
+    applyPendingMoves();
+
     NicEntries::const_iterator ItNic = nics.find(nicID);
     if (ItNic == nics.end()) throw cRuntimeError("No nic with this ID (%d) is registered with this ConnectionManager.", nicID);
 
     return ItNic->second->getGateList();
 }
 
-const cGate* BaseConnectionManager::getOutGateTo(const NicEntry* nic, const NicEntry* targetNic) const
+const cGate* BaseConnectionManager::getOutGateTo(const NicEntry* nic, const NicEntry* targetNic)
 {
+    applyPendingMoves();
+
     NicEntries::const_iterator ItNic = nics.find(nic->nicId);
     if (ItNic == nics.end()) throw cRuntimeError("No nic with this ID (%d) is registered with this ConnectionManager.", nic->nicId);
 
     return ItNic->second->getOutGateTo(targetNic);
 }
 
+void BaseConnectionManager::getNicsInRange(int nicID, double range, std::vector<const NicEntry*>& result)
+{
+    applyPendingMoves();
+
+    NicEntries::const_iterator ItNic = nics.find(nicID);
+    if (ItNic == nics.end()) throw cRuntimeError("No nic with this ID (%d) is registered with this ConnectionManager.", nicID);
+    if (range > maxInterferenceDistance) throw cRuntimeError("Range %f m exceeds the maximum interference distance of %f m.", range, maxInterferenceDistance);
+
+    int slot = ItNic->second->gridSlot;
+    double rangeSquared = range * range;
+
+    result.clear();
+    statistics.rangeTests += ItNic->second->getGateList().size();
+    for (auto& connection : ItNic->second->getGateList()) {
+        const NicEntry* other = connection.nic;
+        if (nicGrid.sqrDist(slot, other->gridSlot) <= rangeSquared) result.push_back(other);
+    }
+}
+
 BaseConnectionManager::~BaseConnectionManager()
 {
     for (NicEntries::iterator ne = nics.begin(); ne != nics.end(); ne++) {
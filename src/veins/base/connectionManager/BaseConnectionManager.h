@@ -24,10 +24,17 @@
 
 #pragma once
 
+#include <chrono>
+#include <functional>
+#include <queue>
+
 #include "veins/veins.h"
 
 #include "veins/base/utils/AntennaPosition.h"
 #include "veins/base/connectionManager/NicEntry.h"
+#include "veins/base/connectionManager/NicGrid.h"
+#include "veins/base/connectionManager/ConnectionManagerStatistics.h"
+#include "veins/base/utils/WorkerPool.h"
 #include "veins/base/utils/Heading.h"
 
 namespace veins {
@@ -50,199 +57,7 @@ class ChannelAccess;
  * @author Christoph Sommer ("unregisterNic()"-method)
  * @sa ChannelAccess
  */
-class VEINS_API BaseConnectionManager : public cSimpleModule {
-private:
-    /**
-     * @brief Represents a position inside a grid.
-     *
-     * Internal helper class of BaseConnectionManager.
-     * This class provides some converting functions from a Coord
-     * to a GridCoord.
-     */
-    class VEINS_API GridCoord {
-    public:
-        /** @name Coordinates in the grid.*/
-        /*@{*/
-        int x;
-        int y;
-        int z;
-        /*@}*/
-
-    public:
-        /**
-         * @brief Initialize this GridCoord with the origin.
-         * Creates a 3-dimensional coord.
-         */
-        GridCoord()
-            : x(0)
-            , y(0)
-            , z(0){};
-
-        /**
-         * @brief Initialize a 2-dimensional GridCoord with x and y.
-         */
-        GridCoord(int x, int y)
-            : x(x)
-            , y(y)
-            , z(0){};
-
-        /**
-         * @brief Initialize a 3-dimensional GridCoord with x, y and z.
-         */
-        GridCoord(int x, int y, int z)
-            : x(x)
-            , y(y)
-            , z(z){};
-
-        /**
-         * @brief Simple copy-constructor.
-         */
-        GridCoord(const GridCoord& o)
-        {
-            x = o.x;
-            y = o.y;
-            z = o.z;
-        }
-
-        /**
-         * @brief Creates a GridCoord from a given Coord by dividing the
-         * x,y and z-values by "gridCellWidth".
-         * The dimension of the GridCoord depends on the Coord.
-         */
-        GridCoord(const Coord& c, const Coord& gridCellSize = Coord(1.0, 1.0, 1.0))
-        {
-            x = static_cast<int>(c.x / gridCellSize.x);
-            y = static_cast<int>(c.y / gridCellSize.y);
-            z = static_cast<int>(c.z / gridCellSize.z);
-        }
-
-        /** @brief Output string for this coordinate.*/
-        std::string info() const
-        {
-            std::stringstream os;
-            os << "(" << x << "," << y << "," << z << ")";
-            return os.str();
-        }
-
-        /** @brief Comparison operator for coordinates.*/
-        friend bool operator==(const GridCoord& a, const GridCoord& b)
-        {
-            return a.x == b.x && a.y == b.y && a.z == b.z;
-        }
-
-        /** @brief Comparison operator for coordinates.*/
-        friend bool operator!=(const GridCoord& a, const GridCoord& b)
-        {
-            return !(a == b);
-        }
-    };
-
-    /**
-     * @brief Represents an minimalistic (hash)set of GridCoords.
-     *
-     * It is a workaround because c++ doesn't come with an hash set.
-     */
-    class VEINS_API CoordSet {
-    protected:
-        /** @brief Holds the hash table.*/
-        std::vector<GridCoord*> data;
-        /** @brief maximum size of the hash table.*/
-        unsigned maxSize;
-        /** @brief Current number of entries in the hash table.*/
-        unsigned size;
-        /** @brief Holds the current element when iterating over this table.*/
-        unsigned current;
-
-    protected:
-        /**
-         * @brief Tries to insert a GridCoord at the specified position.
-         *
-         * If the same Coord already exists there nothing happens.
-         * If an other Coord already exists there calculate
-         * a new Position to insert end recursively call this Method again.
-         * If the spot is empty the Coord is inserted.
-         */
-        void insert(const GridCoord& c, unsigned pos)
-        {
-            if (data[pos] == nullptr) {
-                data[pos] = new GridCoord(c);
-                size++;
-            }
-            else {
-                if (*data[pos] != c) {
-                    insert(c, (pos + 2) % maxSize);
-                }
-            }
-        }
-
-    public:
-        /**
-         * @brief Initializes the set (hashtable) with the a specified size.
-         */
-        CoordSet(unsigned sz)
-            : maxSize(sz)
-            , size(0)
-            , current(0)
-        {
-            data.resize(maxSize);
-        }
-
-        /**
-         * @brief Delete every created GridCoord
-         */
-        ~CoordSet()
-        {
-            for (unsigned i = 0; i < maxSize; i++) {
-                if (data[i] != nullptr) {
-                    delete data[i];
-                }
-            }
-        }
-
-        /**
-         * @brief Adds a GridCoord to the set.
-         * If a GridCoord with the same value already exists in the set
-         * nothing happens.
-         */
-        void add(const GridCoord& c)
-        {
-            unsigned hash = (c.x * 10000 + c.y * 100 + c.z) % maxSize;
-            insert(c, hash);
-        }
-
-        /**
-         * @brief Returns the next GridCoord in the set.
-         * You can iterate through the set only one time with this function!
-         */
-        GridCoord* next()
-        {
-            for (; current < maxSize; current++) {
-                if (data[current] != nullptr) {
-                    return data[current++];
-                }
-            }
-            return nullptr;
-        }
-
-        /**
-         * @brief Returns the number of GridCoords currently saved in this set.
-         */
-        unsigned getSize()
-        {
-            return size;
-        }
-
-        /**
-         * @brief Returns the maximum number of elements which can be stored inside
-         * this set.
-         * To prevent collisions the set should never be more than 75% filled.
-         */
-        unsigned getmaxSize()
-        {
-            return maxSize;
-        }
-    };
-
+class VEINS_API BaseConnectionManager : public cSimpleModule, public cListener {
 protected:
     /** @brief Type for map from nic-module id to nic-module pointer.*/
     typedef std::map<int, NicEntry*> NicEntries;
@@ -270,65 +85,188 @@ protected:
      * TkEnv.*/
     bool drawMIR;
 
-    /** @brief Type for 1-dimensional array of NicEntries.*/
-    using RowVector = std::vector<NicEntries>;
-    /** @brief Type for 2-dimensional array of NicEntries.*/
-    using NicMatrix = std::vector<RowVector>;
-    /** @brief Type for 3-dimensional array of NicEntries.*/
-    using NicCube = std::vector<NicMatrix>;
-
     /**
      * @brief Register of all nics
      *
-     * This matrix keeps all nics according to their position.  It
+     * This grid keeps all nics according to their position.  It
      * allows to restrict the position update to a subset of all nics.
      */
-    NicCube nicGrid;
+    NicGrid nicGrid;
+
+    /** @brief Cells to visit for the connection update of a single nic (re-used buffer) */
+    NicGrid::CellSet cellBuffer;
+
+    /** @brief The nic of each slot of nicGrid */
+    std::vector<NicEntry*> gridNics;
 
     /**
-     * @brief Distance that helps to find a node under a certain
-     * position.
+     * @brief Are connections updated once per TraCI timestep instead of on every position update?
      *
-     * Can be larger then @see maxInterferenceDistance to
-     * allow nodes to be placed into the same square if the playground
-     * is too small for the grid speedup to work.
+     * In batch mode, moved nics are only re-binned into the grid and remembered.
+     * Their connections are updated at the end of the timestep (or, at the latest,
+     * when connections are queried) in a single pass that evaluates every pair of
+     * nics once. The pairs to connect and disconnect are computed on
+     * connectionUpdateThreads threads and applied in order of nic ids, so the
+     * result does not depend on the number of threads.
      */
-    Coord findDistance;
+    bool batchUpdates;
 
-    /** @brief The size of the grid */
-    GridCoord gridDim;
+    /** @brief Batch mode: slots of the nics moved since connections were last updated */
+    std::vector<int> pendingSlots;
 
-private:
-    /** @brief Manages the connections of a registered nic. */
-    void updateNicConnections(NicEntries& nmap, NicEntries::mapped_type nic);
+    /** @brief Batch mode: index of each slot of nicGrid in pendingSlots, -1 if it has not moved */
+    std::vector<int> slotPendingIndex;
 
     /**
-     * @brief Check connections of a nic in the grid
+     * @brief Batch mode: are moved nics handed out to threads in spatial regions?
+     *
+     * pendingSlots is sorted along a Z-order curve over the grid cells before
+     * the connection changes are computed, so each chunk a thread takes covers a
+     * compact region of the playground and the neighborhoods it scans overlap.
+     * The connection changes do not depend on it.
      */
-    void checkGrid(GridCoord& oldCell, GridCoord& newCell, int id);
+    bool spatialPartitioning;
 
-    /**
-     * @brief Calculates the corresponding cell of a coordinate.
-     */
-    GridCoord getCellForCoordinate(const Coord& c);
+    /** @brief Batch mode: spatial key and slot of each moved nic (re-used buffer) */
+    std::vector<std::pair<uint64_t, int>> pendingOrder;
 
-    /**
-     * @brief Returns the NicEntries of the cell with specified
-     * coordinate.
-     */
-    NicEntries& getCellEntries(GridCoord& cell);
+    /** @brief A pair of nics to connect or disconnect, the one with the smaller id first */
+    struct ConnectionDiff {
+        NicEntry* nicA;
+        NicEntry* nicB;
+
+        ConnectionDiff(NicEntry* nic, NicEntry* other)
+            : nicA(nic->nicId < other->nicId ? nic : other)
+            , nicB(nic->nicId < other->nicId ? other : nic)
+        {
+        }
+
+        bool operator<(const ConnectionDiff& other) const
+        {
+            if (nicA->nicId != other.nicA->nicId) return nicA->nicId < other.nicA->nicId;
+            return nicB->nicId < other.nicB->nicId;
+        }
+    };
+
+    /** @brief Batch mode: connection changes computed by one thread */
+    struct ThreadDiffs {
+        std::vector<ConnectionDiff> toConnect;
+        std::vector<ConnectionDiff> toDisconnect;
+        NicGrid::CellSet cells;
+        uint64_t rangeTests = 0;
+        uint64_t cellsVisited = 0;
+    };
+
+    /** @brief Batch mode: one entry per thread of workerPool */
+    std::vector<ThreadDiffs> threadDiffs;
+
+    /** @brief Batch mode: the changes of all threads, in order of nic ids */
+    std::vector<ConnectionDiff> mergedDiffs;
+
+    /** @brief Batch mode: both directions of mergedDiffs, grouped by the nic whose gate list changes */
+    std::vector<std::pair<NicEntry*, NicEntry*>> gateListChanges;
+
+    /** @brief Batch mode: the nics to connect to or disconnect from of one nic (re-used buffer) */
+    std::vector<NicEntry*> gateListChangeNics;
+
+    /** @brief Batch mode: threads computing the connection changes */
+    WorkerPool workerPool;
 
     /**
-     * If the value is outside of its bounds (zero and max) this function
-     * returns -1 if useTorus is false and the wrapped value if useTorus is true.
-     * Otherwise its just returns the value unchanged.
+     * @brief Are pairs of nics only re-checked when their kinetic certificate expires?
+     *
+     * Kinetic mode (on top of batch mode) assumes no nic moves faster than
+     * kineticMaxSpeed. The in-range status of a pair at distance d then cannot
+     * change before |d - maxInterferenceDistance| / (2 * kineticMaxSpeed) has
+     * passed, so each pair is only re-checked when this certificate expires.
+     * Cells are enlarged by a margin, so nics outside the neighborhood of a nic
+     * cannot come into range before kineticRescanInterval, after which the
+     * neighborhood is scanned again. A nic violating the speed bound (or newly
+     * registered) is scanned immediately.
      */
-    int wrapIfTorus(int value, int max);
+    bool kineticUpdates;
+
+    /** @brief Kinetic mode: upper bound of the speed of any nic (in m/s) */
+    double kineticMaxSpeed;
+
+    /** @brief Kinetic mode: time (in s) after which the neighborhood of a nic has to be scanned again */
+    double kineticRescanInterval;
+
+    /** @brief Kinetic mode: time until which a pair of nics (or, if slotB is -1, the neighborhood of a nic) need not be checked */
+    struct KineticCertificate {
+        double expiry;
+        int slotA;
+        int slotB;
+        unsigned long epochA; ///< certificates issued before the nic was scanned the last time are outdated
+        unsigned long epochB;
+
+        bool operator>(const KineticCertificate& other) const
+        {
+            if (expiry != other.expiry) return expiry > other.expiry;
+            if (slotA != other.slotA) return slotA > other.slotA;
+            return slotB > other.slotB;
+        }
+    };
+
+    /** @brief Kinetic mode: all certificates, earliest expiry first (may hold outdated ones) */
+    std::priority_queue<KineticCertificate, std::vector<KineticCertificate>, std::greater<KineticCertificate>> kineticCertificates;
+
+    /** @brief Kinetic mode: re-used buffers of the expired certificates and the connections to drop when scanning */
+    std::vector<KineticCertificate> expiredCertificates;
+    std::vector<NicEntry*> kineticConnectionsToDrop;
+
+    /** @brief Kinetic mode: number of scans of each slot of nicGrid */
+    std::vector<unsigned long> slotEpoch;
+
+    /** @brief Kinetic mode: time of the last position update of each slot of nicGrid, -1 if it has not been scanned yet */
+    std::vector<double> slotLastMoveTime;
+
+    /** @brief Are timings and the fan-out of transmissions collected and reported at the end of the run? */
+    bool collectStatistics;
+
+    /** @brief File the statistics are written to as JSON at the end of the run, empty for none */
+    std::string statisticsReportFile;
+
+    /** @brief Counters of the connection updates, plus timings and fan-out if collectStatistics is set */
+    ConnectionManagerStatistics statistics;
+
+    /** @brief Start of the run (wall-clock), the timings are reported relative to it */
+    std::chrono::steady_clock::time_point wallClockStart;
+
+private:
+    /** @brief Manages the connections of a registered nic with the nics of a grid cell. */
+    void updateNicConnections(const std::vector<int>& cellSlots, NicEntry* nic);
+
+    /** @brief Disconnect the two nics in both directions */
+    void disconnectNics(NicEntry* nic, NicEntry* other);
+
+    /** @brief Batch mode: updates the connections of all nics in pendingSlots in one pass */
+    void updatePendingConnections();
+
+    /** @brief Batch mode: sorts pendingSlots (and updates slotPendingIndex) by the spatial key of the nics */
+    void partitionPendingSlots();
 
     /**
-     * @brief Adds every direct Neighbor of a GridCoord to a union of coords.
+     * @brief Batch mode: computes the connection changes of the nic at the given index of pendingSlots.
+     *
+     * Only reads the connection state, so it is safe to call from several threads at once.
      */
-    void fillUnionWithNeighbors(CoordSet& gridUnion, GridCoord cell);
+    void computePendingDiffs(size_t pendingIndex, ThreadDiffs& diffs);
+
+    /** @brief Batch mode: collects the diffs selected by member of all threads into mergedDiffs, sorted */
+    void mergeDiffs(std::vector<ConnectionDiff> ThreadDiffs::*member);
+
+    /** @brief Batch mode: connects (or disconnects) all pairs of mergedDiffs, changing the gate list of each nic once */
+    void applyMergedDiffs(bool connect);
+
+    /** @brief Kinetic mode: scans the moved nics and re-checks the pairs whose certificates have expired */
+    void updateKineticConnections();
+
+    /** @brief Kinetic mode: re-checks all pairs of the nic in the given slot and issues new certificates */
+    void scanKineticNeighborhood(int slot, double now);
+
+    /** @brief Kinetic mode: connects or disconnects the nics in the given slots and issues a new certificate */
+    void checkKineticPair(int slotA, int slotB, double now);
 
 protected:
     /**
@@ -377,11 +315,13 @@ protected:
      * This function will be used to decide if two nic's shall be connected or not. It
      * is simple to overload this function to enhance the decision for connection or not.
      *
+     * In batch mode, it is called from several threads at once, so it must not modify any state.
+     *
      * @param pFromNic Nic source point which should be checked.
      * @param pToNic   Nic target point which should be checked.
      * @return true if the nic's are in range and can be connected, false if not.
      */
-    virtual bool isInRange(NicEntries::mapped_type pFromNic, NicEntries::mapped_type pToNic);
+    virtual bool isInRange(const NicEntry* pFromNic, const NicEntry* pToNic);
 
 public:
     ~BaseConnectionManager() override;
@@ -398,6 +338,24 @@ public:
      **/
     void initialize(int stage) override;
 
+    /** @brief Records the statistics (if collected) and writes the report file */
+    void finish() override;
+    void finish(cComponent* component, simsignal_t signalID) override;
+
+    /** @brief Batch mode: updates the connections at the end of every TraCI timestep */
+    void receiveSignal(cComponent* source, simsignal_t signalID, const SimTime& t, cObject* details) override;
+
+    /**
+     * @brief Batch mode: updates the connections of all nics moved since the last update.
+     *
+     * Called automatically before connections are queried, so the connections
+     * returned are always up to date.
+     */
+    void applyPendingMoves()
+    {
+        if (!pendingSlots.empty() || (kineticUpdates && !kineticCertificates.empty() && kineticCertificates.top().expiry <= simTime().dbl())) updatePendingConnections();
+    }
+
     /**
      * @brief Registers a nic to have its connections managed by ConnectionManager.
      *
@@ -424,10 +382,34 @@ public:
     void updateNicPos(int nicID, Coord newPos, Heading heading);
 
     /** @brief Returns the ingates of all nics in range*/
-    const NicEntry::GateList& getGateList(int nicID) const;
+    const NicEntry::GateList& getGateList(int nicID);
 
     /** @brief Returns the ingate of the with id==targetID, or 0 if not in range*/
-    const cGate* getOutGateTo(const NicEntry* nic, const NicEntry* targetNic) const;
+    const cGate* getOutGateTo(const NicEntry* nic, const NicEntry* targetNic);
+
+    /** @brief Returns the statistics to collect timings and transmissions into, nullptr if they are not collected */
+    ConnectionManagerStatistics* getStatistics()
+    {
+        return collectStatistics ? &statistics : nullptr;
+    }
+
+    /** @brief Returns the biggest interference distance in the network, i.e., the range up to which nics are connected */
+    double getMaxInterferenceDistance() const
+    {
+        return maxInterferenceDistance;
+    }
+
+    /**
+     * @brief Collects all nics within the given distance of the nic with id==nicID.
+     *
+     * Only the nics currently connected to the nic (found via the grid) are considered,
+     * so range must not exceed the maximum interference distance.
+     *
+     * @param nicID the id of the NicEntry
+     * @param range the distance (in m) up to which nics are collected
+     * @param result cleared and filled with the nics in range, in order of their ids
+     */
+    void getNicsInRange(int nicID, double range, std::vector<const NicEntry*>& result);
 };
 
 } // namespace veins
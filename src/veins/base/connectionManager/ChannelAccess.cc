@@ -83,53 +83,50 @@ void ChannelAccess::initialize(int stage)
 void ChannelAccess::sendToChannel(cPacket* msg)
 {
     const NicEntry::GateList& gateList = cc->getGateList(getParentModule()->getId());
-    NicEntry::GateList::const_iterator i = gateList.begin();
+
+    fanOutTargets.clear();
+    for (auto& connection : gateList) {
+        if (canReach(msg, connection.nic)) {
+            fanOutTargets.push_back(&connection);
+        }
+        else {
+            numFanOutCulled++;
+        }
+    }
+    numFanOutFrames += fanOutTargets.size();
+    if (ConnectionManagerStatistics* statistics = cc->getStatistics()) {
+        statistics->collectTransmission(fanOutTargets.size(), gateList.size() - fanOutTargets.size());
+    }
+
+    if (fanOutTargets.empty()) {
+        if (gateList.empty()) EV_WARN << "Nic is not connected to any gates!" << endl;
+        delete msg;
+        return;
+    }
 
     if (useSendDirect) {
         // use Andras stuff
-        if (i != gateList.end()) {
-            simtime_t delay = SIMTIME_ZERO;
-            for (; i != --gateList.end(); ++i) {
-                // calculate delay (Propagation) to this receiving nic
-                delay = calculatePropagationDelay(i->first);
-
-                int radioStart = i->second->getId();
-                int radioEnd = radioStart + i->second->size();
-                for (int g = radioStart; g != radioEnd; ++g) sendDirect(static_cast<cPacket*>(msg->dup()), delay, msg->getDuration(), i->second->getOwnerModule(), g);
-            }
+        const NicEntry::GateList::Entry* last = fanOutTargets.back();
+        for (const NicEntry::GateList::Entry* target : fanOutTargets) {
             // calculate delay (Propagation) to this receiving nic
-            delay = calculatePropagationDelay(i->first);
+            simtime_t delay = calculatePropagationDelay(target->nic);
 
-            int radioStart = i->second->getId();
-            int radioEnd = radioStart + i->second->size();
-            for (int g = radioStart; g != --radioEnd; ++g) sendDirect(static_cast<cPacket*>(msg->dup()), delay, msg->getDuration(), i->second->getOwnerModule(), g);
-
-            sendDirect(msg, delay, msg->getDuration(), i->second->getOwnerModule(), radioEnd);
-        }
-        else {
-            EV_WARN << "Nic is not connected to any gates!" << endl;
-            delete msg;
+            for (int g = target->gateIdBegin; g != target->gateIdEnd; ++g) {
+                // the last receiving gate gets the original
+                cPacket* copy = (target == last && g == target->gateIdEnd - 1) ? msg : static_cast<cPacket*>(msg->dup());
+                sendDirect(copy, delay, msg->getDuration(), target->ownerModule, g);
+            }
         }
     }
     else {
         // use our stuff
         EV_TRACE << "sendToChannel: sending to gates\n";
-        if (i != gateList.end()) {
-            simtime_t delay = SIMTIME_ZERO;
-            for (; i != --gateList.end(); ++i) {
-                // calculate delay (Propagation) to this receiving nic
-                delay = calculatePropagationDelay(i->first);
-
-                sendDelayed(static_cast<cPacket*>(msg->dup()), delay, i->second);
-            }
+        const NicEntry::GateList::Entry* last = fanOutTargets.back();
+        for (const NicEntry::GateList::Entry* target : fanOutTargets) {
             // calculate delay (Propagation) to this receiving nic
-            delay = calculatePropagationDelay(i->first);
+            simtime_t delay = calculatePropagationDelay(target->nic);
 
-            sendDelayed(msg, delay, i->second);
-        }
-        else {
-            EV_WARN << "Nic is not connected to any gates!" << endl;
-            delete msg;
+            sendDelayed(target == last ? msg : static_cast<cPacket*>(msg->dup()), delay, target->gate);
         }
     }
 }
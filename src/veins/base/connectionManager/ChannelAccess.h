@@ -37,6 +37,7 @@
 #include "veins/base/utils/FindModule.h"
 #include "veins/base/modules/BaseMobility.h"
 #include "veins/base/utils/Heading.h"
+#include "veins/base/connectionManager/NicEntry.h"
 
 namespace veins {
 
@@ -90,6 +91,15 @@ protected:
     /** @brief Offset of antenna orientation (yaw, in rad) with respect to what a BaseMobility module will tell us */
     double antennaOffsetYaw = 0;
 
+    /** @brief Receivers of the frame currently sent by sendToChannel() (re-used buffer) */
+    std::vector<const NicEntry::GateList::Entry*> fanOutTargets;
+
+    /** @brief Number of frame copies sent to the channel */
+    long numFanOutFrames = 0;
+
+    /** @brief Number of frame copies not sent because canReach() ruled the receiver out */
+    long numFanOutCulled = 0;
+
 protected:
     /**
      * @brief Calculates the propagation delay to the passed receiving nic.
@@ -104,9 +114,27 @@ protected:
      *
      * depending on which ConnectionManager module is used, the messages are
      * send via sendDirect() or to the respective gates.
+     *
+     * Every receiver gets its own copy of the frame, but the copies share
+     * the encapsulated packet and the power levels of an AirFrame's Signal
+     * until a receiver changes (e.g., attenuates or decapsulates) them.
      **/
     void sendToChannel(cPacket* msg);
 
+    /**
+     * @brief Decides if the passed frame needs to be delivered to the passed
+     * receiving nic at all.
+     *
+     * Called by sendToChannel() for every connected nic. Returning false
+     * skips the receiver, so this may only return false if the frame
+     * provably does not matter at the receiver. The default delivers to all
+     * connected nics.
+     */
+    virtual bool canReach(cPacket* msg, const NicEntry* nic)
+    {
+        return true;
+    }
+
 public:
     /**
      * @brief Returns a pointer to the ConnectionManager responsible for the
@@ -0,0 +1,83 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/base/connectionManager/ConnectionManagerStatistics.h"
+
+#include <algorithm>
+
+namespace veins {
+
+const char* ConnectionManagerStatistics::getPhaseName(Phase phase)
+{
+    switch (phase) {
+    case POSITION_UPDATE:
+        return "positionUpdate";
+    case COMPUTE_DIFFS:
+        return "computeDiffs";
+    case APPLY_DIFFS:
+        return "applyDiffs";
+    case KINETIC_UPDATE:
+        return "kineticUpdate";
+    default:
+        throw cRuntimeError("Unknown connection manager phase %d", phase);
+    }
+}
+
+ConnectionManagerStatistics::ConnectionManagerStatistics()
+{
+    std::fill(phaseSeconds, phaseSeconds + NUM_PHASES, 0.0);
+    std::fill(phaseCalls, phaseCalls + NUM_PHASES, 0);
+}
+
+void ConnectionManagerStatistics::configureFanOut(size_t maxFanOut)
+{
+    // bin k counts transmissions to k receivers
+    fanOut.configure(1, maxFanOut + 1, -0.5);
+}
+
+void ConnectionManagerStatistics::writeJson(std::ostream& os, double wallClockSeconds) const
+{
+    os << "{\"wallClockSeconds\": " << wallClockSeconds;
+
+    os << ", \"counters\": {\"positionUpdates\": " << positionUpdates << ", \"batchUpdates\": " << batchUpdates << ", \"connects\": " << connects << ", \"disconnects\": " << disconnects << ", \"rangeTests\": " << rangeTests << ", \"cellsVisited\": " << cellsVisited << "}";
+
+    os << ", \"phases\": {";
+    for (int i = 0; i < NUM_PHASES; i++) {
+        Phase phase = static_cast<Phase>(i);
+        if (i > 0) os << ", ";
+        os << "\"" << getPhaseName(phase) << "\": {\"calls\": " << phaseCalls[i] << ", \"seconds\": " << phaseSeconds[i] << "}";
+    }
+    os << "}";
+
+    os << ", \"fanOut\": {\"transmissions\": " << fanOut.getCount() << ", \"frames\": " << static_cast<uint64_t>(fanOut.getSum()) << ", \"culled\": " << fanOutCulled;
+    os << ", \"mean\": " << fanOut.getMean() << ", \"min\": " << fanOut.getMin() << ", \"max\": " << fanOut.getMax() << ", \"overflow\": " << fanOut.getOverflowCount();
+    // counts[k] is the number of transmissions to k receivers
+    os << ", \"counts\": [";
+    for (size_t i = 0; i < fanOut.getUsedBins(); i++) {
+        if (i > 0) os << ", ";
+        os << fanOut.getBinCount(i);
+    }
+    os << "]}}" << std::endl;
+}
+
+} // namespace veins
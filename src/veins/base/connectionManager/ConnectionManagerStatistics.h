@@ -0,0 +1,144 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+#include "veins/veins.h"
+
+#include "veins/modules/utility/StreamingHistogram.h"
+
+namespace veins {
+
+/**
+ * @brief Counters and timings of a connection manager and of the
+ * transmissions of the nics registered with it.
+ *
+ * The counters are plain integers updated by the connection manager in any
+ * case. Timings and the fan-out histogram are only collected if enabled, as
+ * they need a clock or more than an increment.
+ *
+ * @ingroup connectionManager
+ */
+class VEINS_API ConnectionManagerStatistics {
+public:
+    /** @brief Parts of the connection updates which are timed separately */
+    enum Phase {
+        POSITION_UPDATE, ///< handling a position update (in batch mode only queueing the nic)
+        COMPUTE_DIFFS, ///< batch mode: finding the connections to change
+        APPLY_DIFFS, ///< batch mode: changing the connections
+        KINETIC_UPDATE, ///< kinetic mode: scanning moved nics and re-checking expired certificates
+        NUM_PHASES
+    };
+
+    static const char* getPhaseName(Phase phase);
+
+    /**
+     * @brief Adds the wall-clock time of its lifetime to a phase.
+     *
+     * Does nothing (not even reading the clock) if no statistics are passed.
+     */
+    class VEINS_API PhaseTimer {
+    public:
+        PhaseTimer(ConnectionManagerStatistics* statistics, Phase phase)
+            : statistics(statistics)
+            , phase(phase)
+        {
+            if (statistics) start = std::chrono::steady_clock::now();
+        }
+
+        ~PhaseTimer()
+        {
+            if (statistics) statistics->addPhaseTime(phase, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+    private:
+        ConnectionManagerStatistics* statistics;
+        Phase phase;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    ConnectionManagerStatistics();
+
+    /** @brief Counts the fan-out of transmissions to up to maxFanOut receivers exactly, larger ones as overflow */
+    void configureFanOut(size_t maxFanOut);
+
+    /** @brief Counts a transmission to the given number of receivers, after culledReceivers connected nics were skipped */
+    void collectTransmission(size_t receivers, size_t culledReceivers)
+    {
+        fanOut.collect(receivers);
+        fanOutCulled += culledReceivers;
+    }
+
+    void addPhaseTime(Phase phase, double seconds)
+    {
+        phaseSeconds[phase] += seconds;
+        phaseCalls[phase]++;
+    }
+
+    double getPhaseSeconds(Phase phase) const
+    {
+        return phaseSeconds[phase];
+    }
+
+    uint64_t getPhaseCalls(Phase phase) const
+    {
+        return phaseCalls[phase];
+    }
+
+    const StreamingHistogram& getFanOut() const
+    {
+        return fanOut;
+    }
+
+    uint64_t getFanOutCulled() const
+    {
+        return fanOutCulled;
+    }
+
+    /**
+     * @brief Writes all counters, timings and the non-empty part of the
+     * fan-out histogram as a single JSON object.
+     *
+     * @param wallClockSeconds wall-clock time of the whole run, to relate the timings to
+     */
+    void writeJson(std::ostream& os, double wallClockSeconds) const;
+
+    uint64_t positionUpdates = 0; ///< position updates handled
+    uint64_t batchUpdates = 0; ///< batch mode: times the moved nics were handled together
+    uint64_t connects = 0; ///< pairs of nics connected
+    uint64_t disconnects = 0; ///< pairs of nics disconnected
+    uint64_t rangeTests = 0; ///< distance checks of pairs of nics
+    uint64_t cellsVisited = 0; ///< grid cells searched for nics
+
+private:
+    StreamingHistogram fanOut;
+    uint64_t fanOutCulled = 0;
+    double phaseSeconds[NUM_PHASES];
+    uint64_t phaseCalls[NUM_PHASES];
+};
+
+} // namespace veins
@@ -27,7 +27,8 @@
 
 #pragma once
 
-#include <map>
+#include <algorithm>
+#include <vector>
 
 #include "veins/veins.h"
 
@@ -48,18 +49,145 @@ class ChannelAccess;
  * @sa ConnectionManager
  */
 class VEINS_API NicEntry : public HasLogProxy {
-protected:
-    class VEINS_API NicEntryComparator {
+public:
+    /**
+     * @brief Outgoing connections of a nic, sorted by the nicId of the
+     * receiving nic.
+     *
+     * Kept in a flat vector, so sending a frame to all receivers walks
+     * contiguous memory in the same order in every run. Each entry holds
+     * what is needed to send to the receiver, so no gate or module has to
+     * be looked up on the way.
+     */
+    class VEINS_API GateList {
     public:
-        bool operator()(const NicEntry* nic1, const NicEntry* nic2) const
+        struct Entry {
+            /** @brief the receiving nic */
+            const NicEntry* nic;
+            /** @brief gate to send to the receiving nic */
+            cGate* gate;
+            /** @brief owner module of gate, i.e., the receiving module for sendDirect */
+            cModule* ownerModule;
+            /** @brief range of gate ids [gateIdBegin, gateIdEnd) of gate (one per element if it is a vector gate) */
+            int gateIdBegin;
+            int gateIdEnd;
+
+            Entry(const NicEntry* nic, cGate* gate)
+                : nic(nic)
+                , gate(gate)
+                , ownerModule(gate->getOwnerModule())
+                , gateIdBegin(gate->getId())
+                , gateIdEnd(gate->getId() + gate->size())
+            {
+            }
+        };
+
+        using const_iterator = std::vector<Entry>::const_iterator;
+
+        const_iterator begin() const
         {
-            return nic1->nicId < nic2->nicId;
+            return entries.begin();
         }
-    };
 
-public:
-    /** @brief Type for map from NicEntry pointer to a gate.*/
-    typedef std::map<const NicEntry*, cGate*, NicEntryComparator> GateList;
+        const_iterator end() const
+        {
+            return entries.end();
+        }
+
+        size_t size() const
+        {
+            return entries.size();
+        }
+
+        bool empty() const
+        {
+            return entries.empty();
+        }
+
+        /** @brief Returns the connection to nic, nullptr if there is none */
+        const Entry* find(const NicEntry* nic) const
+        {
+            auto it = lowerBound(nic->nicId);
+            return (it != entries.end() && it->nic == nic) ? &*it : nullptr;
+        }
+
+        /** @brief Adds (or replaces) the connection to nic */
+        void insert(const NicEntry* nic, cGate* gate)
+        {
+            auto it = lowerBound(nic->nicId);
+            if (it != entries.end() && it->nic == nic) {
+                *it = Entry(nic, gate);
+            }
+            else {
+                entries.insert(it, Entry(nic, gate));
+            }
+        }
+
+        /** @brief Removes the connection to nic, returns false if there is none */
+        bool erase(const NicEntry* nic)
+        {
+            auto it = lowerBound(nic->nicId);
+            if (it == entries.end() || it->nic != nic) return false;
+            entries.erase(it);
+            return true;
+        }
+
+        /**
+         * @brief Adds the passed connections in a single pass.
+         *
+         * added has to be sorted by nicId and must not contain nics
+         * which are already connected. The merge runs in place from the
+         * back, so no second list of the size of the gate list is needed.
+         */
+        void insert(const std::vector<Entry>& added)
+        {
+            for (auto it = added.begin(); it != added.end(); ++it) {
+                if (it != added.begin() && (it - 1)->nic->nicId >= it->nic->nicId) throw cRuntimeError("GateList: added connections are not sorted by nicId or contain nic #%d twice", it->nic->nicId);
+                if (find(it->nic)) throw cRuntimeError("GateList: nic #%d is already connected", it->nic->nicId);
+            }
+
+            size_t i = entries.size();
+            size_t j = added.size();
+            entries.insert(entries.end(), added.begin(), added.end());
+            size_t k = entries.size();
+            while (j > 0) {
+                if (i > 0 && entries[i - 1].nic->nicId > added[j - 1].nic->nicId) {
+                    entries[--k] = entries[--i];
+                }
+                else {
+                    entries[--k] = added[--j];
+                }
+            }
+        }
+
+        /**
+         * @brief Removes the connections to the passed nics in a single pass.
+         *
+         * removed has to be sorted by nicId.
+         */
+        void erase(const std::vector<NicEntry*>& removed)
+        {
+            auto next = removed.begin();
+            auto last = std::remove_if(entries.begin(), entries.end(), [&](const Entry& entry) {
+                while (next != removed.end() && (*next)->nicId < entry.nic->nicId) ++next;
+                return next != removed.end() && *next == entry.nic;
+            });
+            entries.erase(last, entries.end());
+        }
+
+    private:
+        std::vector<Entry>::iterator lowerBound(int nicId)
+        {
+            return std::lower_bound(entries.begin(), entries.end(), nicId, [](const Entry& entry, int id) { return entry.nic->nicId < id; });
+        }
+
+        std::vector<Entry>::const_iterator lowerBound(int nicId) const
+        {
+            return std::lower_bound(entries.begin(), entries.end(), nicId, [](const Entry& entry, int id) { return entry.nic->nicId < id; });
+        }
+
+        std::vector<Entry> entries;
+    };
 
     /** @brief module id of the nic for which information is stored*/
     int nicId;
@@ -79,13 +207,14 @@ public:
     /** @brief Points to this nics ChannelAccess module */
     ChannelAccess* chAccess;
 
+    /** @brief Slot of this nic in the grid of the connection manager */
+    int gridSlot;
+
 protected:
     /** @brief Outgoing connections of this nic
      *
-     * This map stores all connection for this nic to other nics
-     *
-     * The first entry is the module id of the nic the connection is
-     * going to and the second the gate to send the msg to
+     * This list stores all connection for this nic to other nics,
+     * together with the gate to send the msg to
      **/
     GateList outConns;
 
@@ -97,7 +226,8 @@ public:
         : HasLogProxy(owner)
         , nicId(0)
         , nicPtr(nullptr)
-        , hostId(0){};
+        , hostId(0)
+        , gridSlot(-1){};
 
     /**
      * @brief Destructor -- needs to be there...
@@ -112,6 +242,24 @@ public:
     /** @brief Disconnect two nics */
     virtual void disconnectFrom(NicEntry*) = 0;
 
+    /** @brief Connect to all passed nics, sorted by nicId
+     *
+     * Subclasses may override this to update the gate list in one go.
+     */
+    virtual void connectToAll(const std::vector<NicEntry*>& others)
+    {
+        for (NicEntry* other : others) connectTo(other);
+    }
+
+    /** @brief Disconnect from all passed nics, sorted by nicId
+     *
+     * Subclasses may override this to update the gate list in one go.
+     */
+    virtual void disconnectFromAll(const std::vector<NicEntry*>& others)
+    {
+        for (NicEntry* other : others) disconnectFrom(other);
+    }
+
     /** @brief return the actual gateList*/
     const GateList& getGateList()
     {
@@ -121,7 +269,7 @@ public:
     /** @brief Checks if this nic is connected to the "other" nic*/
     bool isConnected(const NicEntry* other)
     {
-        return (outConns.find(other) != outConns.end());
+        return outConns.find(other) != nullptr;
     };
 
     /**
@@ -134,7 +282,8 @@ public:
      */
     const cGate* getOutGateTo(const NicEntry* to)
     {
-        return outConns[to];
+        const GateList::Entry* connection = outConns.find(to);
+        return connection ? connection->gate : nullptr;
     };
 };
 
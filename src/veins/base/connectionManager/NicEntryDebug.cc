@@ -41,7 +41,7 @@ void NicEntryDebug::connectTo(NicEntry* other)
 
     cGate* localoutgate = requestOutGate();
     localoutgate->connectTo(otherNic->requestInGate());
-    outConns[other] = localoutgate->getPathStartGate();
+    outConns.insert(other, localoutgate->getPathStartGate());
 }
 
 void NicEntryDebug::disconnectFrom(NicEntry* other)
@@ -51,11 +51,11 @@ void NicEntryDebug::disconnectFrom(NicEntry* other)
     NicEntryDebug* otherNic = (NicEntryDebug*) other;
 
     // search the connection in the outConns list
-    GateList::iterator p = outConns.find(other);
+    const GateList::Entry* p = outConns.find(other);
     // no need to check whether entry is valid; is already check by ConnectionManager isConnected
     // get the hostGate
     // order is phyGate->nicGate->hostGate
-    cGate* hostGate = p->second->getNextGate()->getNextGate();
+    cGate* hostGate = p->gate->getNextGate()->getNextGate();
 
     // release local out gate
     freeOutGates.push_back(hostGate);
@@ -68,7 +68,7 @@ void NicEntryDebug::disconnectFrom(NicEntry* other)
     hostGate->disconnect();
 
     // delete the connection
-    outConns.erase(p);
+    outConns.erase(other);
 }
 
 int NicEntryDebug::collectGates(const char* pattern, GateStack& gates)
@@ -40,7 +40,7 @@ void NicEntryDirect::connectTo(NicEntry* other)
     cGate* radioGate = nullptr;
     if ((radioGate = otherPtr->gate("radioIn")) == nullptr) throw cRuntimeError("Nic has no radioIn gate!");
 
-    outConns[other] = radioGate->getPathStartGate();
+    outConns.insert(other, radioGate->getPathStartGate());
 }
 
 void NicEntryDirect::disconnectFrom(NicEntry* other)
@@ -48,3 +48,25 @@ void NicEntryDirect::disconnectFrom(NicEntry* other)
     EV_TRACE << "disconnecting nic #" << nicId << " and #" << other->nicId << endl;
     outConns.erase(other);
 }
+
+void NicEntryDirect::connectToAll(const std::vector<NicEntry*>& others)
+{
+    addedConns.clear();
+    for (NicEntry* other : others) {
+        EV_TRACE << "connecting nic #" << nicId << " and #" << other->nicId << endl;
+
+        cGate* radioGate = nullptr;
+        if ((radioGate = other->nicPtr->gate("radioIn")) == nullptr) throw cRuntimeError("Nic has no radioIn gate!");
+
+        addedConns.push_back(GateList::Entry(other, radioGate->getPathStartGate()));
+    }
+    outConns.insert(addedConns);
+}
+
+void NicEntryDirect::disconnectFromAll(const std::vector<NicEntry*>& others)
+{
+    for (const NicEntry* other : others) {
+        EV_TRACE << "disconnecting nic #" << nicId << " and #" << other->nicId << endl;
+    }
+    outConns.erase(others);
+}
@@ -72,6 +72,16 @@ public:
      * @param other reference to remote nic (other NicEntry)
      */
     void disconnectFrom(NicEntry*) override;
+
+    /** @brief Connect to all passed nics, merging them into the gate list at once */
+    void connectToAll(const std::vector<NicEntry*>& others) override;
+
+    /** @brief Disconnect from all passed nics, removing them from the gate list at once */
+    void disconnectFromAll(const std::vector<NicEntry*>& others) override;
+
+protected:
+    /** @brief re-used buffer of the batched connect */
+    std::vector<GateList::Entry> addedConns;
 };
 
 } // namespace veins
@@ -0,0 +1,454 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/base/connectionManager/NicGrid.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace veins;
+
+namespace {
+/**
+ * On a torus the end and the begin of the axes are connected so you
+ * get a circle. On a circle the distance between two points can't be greater
+ * than half of the circumference.
+ * If the normal distance between two points on one axis is bigger than
+ * half of the size there must be a "shorter way" over the border on this axis
+ */
+double torusDist(double coord1, double coord2, double size)
+{
+    double difference = fabs(coord1 - coord2);
+    if (difference == 0)
+        // NOTE: event if size is zero
+        return 0;
+    else {
+        ASSERT(size != 0);
+        double dist = FWMath::modulo(difference, size);
+        return std::min(dist, size - dist);
+    }
+}
+} // namespace
+
+NicGrid::NicGrid()
+    : useTorus(false)
+    , dimX(1)
+    , dimY(1)
+    , dimZ(1)
+    , reach(0)
+    , neighborOffsets(1, CellOffset{0, 0, 0})
+    , neighborOffsetsWrap(false)
+    , minOutsideDistance(std::numeric_limits<double>::infinity())
+    , cells(1)
+    , numCoarseCells(1)
+    , subDimX(1)
+    , subDimY(1)
+    , subDimZ(1)
+    , subCellsPerBlock(1)
+    , subdivisionThreshold(0)
+    , coarseCellSize(1, 0)
+    , coarseCellBlock(1, -1)
+{
+}
+
+void NicGrid::configure(const Coord& playgroundSize, double reach, bool useTorus, double cellSizeFactor)
+{
+    ASSERT(cellSizeFactor > 0 && cellSizeFactor <= 1);
+
+    this->playgroundSize = playgroundSize;
+    this->useTorus = useTorus;
+    this->reach = reach;
+    double minCellSize = reach * cellSizeFactor;
+
+    // one cell should have at least the size of minCellSize
+    // but also should divide the playground in equal parts
+    dimX = static_cast<int>(playgroundSize.x / minCellSize);
+    dimY = static_cast<int>(playgroundSize.y / minCellSize);
+    dimZ = static_cast<int>(playgroundSize.z / minCellSize);
+
+    if ((playgroundSize.x / reach < 4) && (playgroundSize.y / reach < 4) && (playgroundSize.z / reach < 4)) {
+        dimX = 1;
+        dimY = 1;
+        dimZ = 1;
+    }
+    else {
+        dimX = std::max(1, dimX);
+        dimY = std::max(1, dimY);
+        dimZ = std::max(1, dimZ);
+    }
+
+    // if we use a single cell along an axis every coordinate is mapped to it,
+    // otherwise we divide the playground into equal cells
+    cellSize = Coord(std::max(playgroundSize.x, minCellSize), std::max(playgroundSize.y, minCellSize), std::max(playgroundSize.z, minCellSize));
+    if (dimX != 1) cellSize.x = playgroundSize.x / dimX;
+    if (dimY != 1) cellSize.y = playgroundSize.y / dimY;
+    if (dimZ != 1) cellSize.z = playgroundSize.z / dimZ;
+
+    // since the upper playground borders (at pg-size) are part of the
+    // playground we have to assure that they are mapped to a valid
+    // (the last) grid cell we do this by increasing the cell size
+    // by a small value.
+    // This also assures that the cell size is never zero.
+    const auto epsilon = 0.001;
+    cellSize += Coord(epsilon, epsilon, epsilon);
+
+    ASSERT(cellSize.x >= minCellSize);
+    ASSERT(cellSize.y >= minCellSize);
+    ASSERT(cellSize.z >= minCellSize);
+
+    // the cells at offset d along an axis are at least (|d| - 1) cell widths away,
+    // the neighborhood holds all offsets for which this distance is within the reach
+    auto maxOffset = [&](int dim, double size) {
+        if (dim == 1) return 0;
+        int offset = static_cast<int>(reach / size) + 1;
+        // without a torus, cells further away than the playground do not exist
+        return useTorus ? offset : std::min(offset, dim - 1);
+    };
+    auto gap = [](int offset, double size) {
+        return std::max(0, std::abs(offset) - 1) * size;
+    };
+    int maxX = maxOffset(dimX, cellSize.x);
+    int maxY = maxOffset(dimY, cellSize.y);
+    int maxZ = maxOffset(dimZ, cellSize.z);
+    neighborOffsets.clear();
+    minOutsideDistance = std::numeric_limits<double>::infinity();
+    // one more offset along each axis finds the closest cells outside of the neighborhood
+    int outerX = maxX == 0 ? 0 : maxX + 1;
+    int outerY = maxY == 0 ? 0 : maxY + 1;
+    int outerZ = maxZ == 0 ? 0 : maxZ + 1;
+    for (int z = -outerZ; z <= outerZ; z++) {
+        for (int x = -outerX; x <= outerX; x++) {
+            for (int y = -outerY; y <= outerY; y++) {
+                double gapX = gap(x, cellSize.x);
+                double gapY = gap(y, cellSize.y);
+                double gapZ = gap(z, cellSize.z);
+                double distance = sqrt(gapX * gapX + gapY * gapY + gapZ * gapZ);
+                if (std::abs(x) <= maxX && std::abs(y) <= maxY && std::abs(z) <= maxZ && distance <= reach) {
+                    neighborOffsets.push_back(CellOffset{x, y, z});
+                }
+                else {
+                    minOutsideDistance = std::min(minOutsideDistance, distance);
+                }
+            }
+        }
+    }
+    neighborOffsetsWrap = useTorus && (2 * maxX + 1 > dimX || 2 * maxY + 1 > dimY || 2 * maxZ + 1 > dimZ);
+
+    numCoarseCells = dimX * dimY * dimZ;
+    cells.assign(static_cast<size_t>(numCoarseCells), std::vector<int>());
+    posX.clear();
+    posY.clear();
+    posZ.clear();
+    slotNicId.clear();
+    slotCell.clear();
+    slotIndexInCell.clear();
+    freeSlots.clear();
+
+    configureSubdivision(1, 0);
+
+    // playGroundSize has to be part of the playGround
+    ASSERT(getCellForCoordinate(playgroundSize) == static_cast<int>(cells.size()) - 1);
+}
+
+void NicGrid::configureSubdivision(int subdivisions, size_t threshold)
+{
+    ASSERT(subdivisions >= 1);
+    ASSERT(size() == 0);
+
+    // sub-cells narrower than the playground would stay empty
+    auto subDim = [&](double playgroundExtent, double size) {
+        return std::max(1, std::min(subdivisions, static_cast<int>(playgroundExtent / (size / subdivisions))));
+    };
+    subDimX = subDim(playgroundSize.x, cellSize.x);
+    subDimY = subDim(playgroundSize.y, cellSize.y);
+    subDimZ = subDim(playgroundSize.z, cellSize.z);
+    subCellsPerBlock = subDimX * subDimY * subDimZ;
+    subdivisionThreshold = threshold;
+
+    cells.resize(static_cast<size_t>(numCoarseCells));
+    coarseCellSize.assign(static_cast<size_t>(numCoarseCells), 0);
+    coarseCellBlock.assign(static_cast<size_t>(numCoarseCells), -1);
+    blockCoarseCell.clear();
+    freeBlocks.clear();
+    mergeCandidates.clear();
+}
+
+int NicGrid::cellIndex(int x, int y, int z) const
+{
+    return x + dimX * (y + dimY * z);
+}
+
+int NicGrid::getCoarseCell(int cell) const
+{
+    if (cell < numCoarseCells) return cell;
+    return blockCoarseCell[(cell - numCoarseCells) / subCellsPerBlock];
+}
+
+void NicGrid::getCellBox(int cell, Coord& origin, Coord& size) const
+{
+    int coarseCell = getCoarseCell(cell);
+    origin = Coord(coarseCell % dimX * cellSize.x, (coarseCell / dimX) % dimY * cellSize.y, coarseCell / (dimX * dimY) * cellSize.z);
+    size = cellSize;
+    if (cell == coarseCell) return;
+
+    int subCell = (cell - numCoarseCells) % subCellsPerBlock;
+    size = Coord(cellSize.x / subDimX, cellSize.y / subDimY, cellSize.z / subDimZ);
+    origin += Coord(subCell % subDimX * size.x, (subCell / subDimX) % subDimY * size.y, subCell / (subDimX * subDimY) * size.z);
+}
+
+int NicGrid::getCellForCoordinate(const Coord& pos) const
+{
+    int x = static_cast<int>(pos.x / cellSize.x);
+    int y = static_cast<int>(pos.y / cellSize.y);
+    int z = static_cast<int>(pos.z / cellSize.z);
+    ASSERT(x >= 0 && x < dimX && y >= 0 && y < dimY && z >= 0 && z < dimZ);
+    int coarseCell = cellIndex(x, y, z);
+
+    int block = coarseCellBlock[coarseCell];
+    if (block == -1) return coarseCell;
+
+    int sx = std::min(subDimX - 1, static_cast<int>((pos.x - x * cellSize.x) / (cellSize.x / subDimX)));
+    int sy = std::min(subDimY - 1, static_cast<int>((pos.y - y * cellSize.y) / (cellSize.y / subDimY)));
+    int sz = std::min(subDimZ - 1, static_cast<int>((pos.z - z * cellSize.z) / (cellSize.z / subDimZ)));
+    return numCoarseCells + block * subCellsPerBlock + sx + subDimX * (sy + subDimY * sz);
+}
+
+uint64_t NicGrid::getSpatialKey(int slot) const
+{
+    int coarseCell = getCoarseCell(slotCell[slot]);
+    uint64_t x = coarseCell % dimX;
+    uint64_t y = (coarseCell / dimX) % dimY;
+    uint64_t z = coarseCell / (dimX * dimY);
+
+    // interleave the lower 21 bits of the cell coordinates
+    uint64_t key = 0;
+    for (int bit = 0; bit < 21; bit++) {
+        key |= ((x >> bit) & 1) << (3 * bit);
+        key |= ((y >> bit) & 1) << (3 * bit + 1);
+        key |= ((z >> bit) & 1) << (3 * bit + 2);
+    }
+    return key;
+}
+
+int NicGrid::insert(int nicId, const Coord& pos)
+{
+    int slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = static_cast<int>(slotNicId.size());
+        posX.push_back(0);
+        posY.push_back(0);
+        posZ.push_back(0);
+        slotNicId.push_back(0);
+        slotCell.push_back(0);
+        slotIndexInCell.push_back(0);
+    }
+
+    posX[slot] = pos.x;
+    posY[slot] = pos.y;
+    posZ[slot] = pos.z;
+    slotNicId[slot] = nicId;
+    addToCell(slot, getCellForCoordinate(pos));
+
+    return slot;
+}
+
+void NicGrid::remove(int slot)
+{
+    removeFromCell(slot);
+
+    slotCell[slot] = -1;
+    freeSlots.push_back(slot);
+}
+
+void NicGrid::move(int slot, const Coord& pos)
+{
+    posX[slot] = pos.x;
+    posY[slot] = pos.y;
+    posZ[slot] = pos.z;
+
+    int newCell = getCellForCoordinate(pos);
+    if (newCell == slotCell[slot]) return;
+
+    removeFromCell(slot);
+    addToCell(slot, newCell);
+}
+
+void NicGrid::addToCell(int slot, int cell)
+{
+    slotCell[slot] = cell;
+    slotIndexInCell[slot] = static_cast<int>(cells[cell].size());
+    cells[cell].push_back(slot);
+
+    int coarseCell = getCoarseCell(cell);
+    coarseCellSize[coarseCell]++;
+    if (subCellsPerBlock > 1 && cell == coarseCell && coarseCellSize[coarseCell] > subdivisionThreshold) subdivide(coarseCell);
+}
+
+void NicGrid::removeFromCell(int slot)
+{
+    std::vector<int>& members = cells[slotCell[slot]];
+    int index = slotIndexInCell[slot];
+    int last = members.back();
+    members[index] = last;
+    slotIndexInCell[last] = index;
+    members.pop_back();
+
+    int coarseCell = getCoarseCell(slotCell[slot]);
+    coarseCellSize[coarseCell]--;
+    // merging only at half the threshold keeps nics moving at its border from splitting and merging a cell over and over
+    if (coarseCellBlock[coarseCell] != -1 && coarseCellSize[coarseCell] <= subdivisionThreshold / 2) mergeCandidates.push_back(coarseCell);
+}
+
+void NicGrid::subdivide(int coarseCell)
+{
+    int block;
+    if (!freeBlocks.empty()) {
+        block = freeBlocks.back();
+        freeBlocks.pop_back();
+    }
+    else {
+        block = static_cast<int>(blockCoarseCell.size());
+        blockCoarseCell.push_back(-1);
+        cells.resize(cells.size() + subCellsPerBlock);
+    }
+    blockCoarseCell[block] = coarseCell;
+    coarseCellBlock[coarseCell] = block;
+
+    std::vector<int> members;
+    members.swap(cells[coarseCell]);
+    for (int slot : members) {
+        int subCell = getCellForCoordinate(Coord(posX[slot], posY[slot], posZ[slot]));
+        slotCell[slot] = subCell;
+        slotIndexInCell[slot] = static_cast<int>(cells[subCell].size());
+        cells[subCell].push_back(slot);
+    }
+}
+
+void NicGrid::merge(int coarseCell)
+{
+    int block = coarseCellBlock[coarseCell];
+    std::vector<int>& members = cells[coarseCell];
+    for (int i = 0; i < subCellsPerBlock; i++) {
+        std::vector<int>& subMembers = cells[numCoarseCells + block * subCellsPerBlock + i];
+        for (int slot : subMembers) {
+            slotCell[slot] = coarseCell;
+            slotIndexInCell[slot] = static_cast<int>(members.size());
+            members.push_back(slot);
+        }
+        // unused blocks should not hold on to memory
+        std::vector<int>().swap(subMembers);
+    }
+
+    coarseCellBlock[coarseCell] = -1;
+    blockCoarseCell[block] = -1;
+    freeBlocks.push_back(block);
+}
+
+void NicGrid::rebalance()
+{
+    for (int coarseCell : mergeCandidates) {
+        if (coarseCellBlock[coarseCell] != -1 && coarseCellSize[coarseCell] <= subdivisionThreshold / 2) merge(coarseCell);
+    }
+    mergeCandidates.clear();
+}
+
+int NicGrid::wrapIfTorus(int value, int max) const
+{
+    if (value >= 0 && value < max) return value;
+    if (!useTorus) return -1;
+    int wrapped = value % max;
+    return wrapped < 0 ? wrapped + max : wrapped;
+}
+
+void NicGrid::addNeighborCells(int cell, CellSet& result) const
+{
+    size_t sizeBefore = result.size();
+
+    int coarseCell = getCoarseCell(cell);
+    int x = coarseCell % dimX;
+    int y = (coarseCell / dimX) % dimY;
+    int z = coarseCell / (dimX * dimY);
+
+    // neighborOffsets are exact for coarse cells, the boxes of sub-cells are compared one by one
+    Coord origin, size;
+    getCellBox(cell, origin, size);
+    bool isSubCell = cell != coarseCell;
+    double reachSquared = reach * reach;
+    auto inReach = [&](const Coord& otherOrigin, const Coord& otherSize) {
+        double dx = std::max(0.0, std::max(otherOrigin.x - (origin.x + size.x), origin.x - (otherOrigin.x + otherSize.x)));
+        double dy = std::max(0.0, std::max(otherOrigin.y - (origin.y + size.y), origin.y - (otherOrigin.y + otherSize.y)));
+        double dz = std::max(0.0, std::max(otherOrigin.z - (origin.z + size.z), origin.z - (otherOrigin.z + otherSize.z)));
+        return dx * dx + dy * dy + dz * dz <= reachSquared;
+    };
+    Coord subSize(cellSize.x / subDimX, cellSize.y / subDimY, cellSize.z / subDimZ);
+
+    for (const CellOffset& offset : neighborOffsets) {
+        int cx = wrapIfTorus(x + offset.x, dimX);
+        int cy = wrapIfTorus(y + offset.y, dimY);
+        int cz = wrapIfTorus(z + offset.z, dimZ);
+        if (cx == -1 || cy == -1 || cz == -1) continue;
+        int neighbor = cellIndex(cx, cy, cz);
+
+        int block = coarseCellBlock[neighbor];
+        if (block == -1 && !isSubCell) {
+            result.append(neighbor);
+            continue;
+        }
+
+        // the neighbor as seen from this cell, i.e., not wrapped around
+        Coord neighborOrigin((x + offset.x) * cellSize.x, (y + offset.y) * cellSize.y, (z + offset.z) * cellSize.z);
+        if (block == -1) {
+            if (inReach(neighborOrigin, cellSize)) result.append(neighbor);
+            continue;
+        }
+        int subCell = numCoarseCells + block * subCellsPerBlock;
+        for (int sz = 0; sz < subDimZ; sz++) {
+            for (int sy = 0; sy < subDimY; sy++) {
+                for (int sx = 0; sx < subDimX; sx++, subCell++) {
+                    if (inReach(neighborOrigin + Coord(sx * subSize.x, sy * subSize.y, sz * subSize.z), subSize)) result.append(subCell);
+                }
+            }
+        }
+    }
+
+    if (sizeBefore != 0 || neighborOffsetsWrap) result.removeDuplicates();
+}
+
+double NicGrid::sqrDist(int slotA, int slotB) const
+{
+    double dx, dy, dz;
+    if (useTorus) {
+        dx = torusDist(posX[slotA], posX[slotB], playgroundSize.x);
+        dy = torusDist(posY[slotA], posY[slotB], playgroundSize.y);
+        dz = torusDist(posZ[slotA], posZ[slotB], playgroundSize.z);
+    }
+    else {
+        dx = posX[slotA] - posX[slotB];
+        dy = posY[slotA] - posY[slotB];
+        dz = posZ[slotA] - posZ[slotB];
+    }
+    return dx * dx + dy * dy + dz * dz;
+}
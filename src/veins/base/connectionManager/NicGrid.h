@@ -0,0 +1,317 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/Coord.h"
+
+namespace veins {
+
+/**
+ * @brief Spatial index of the nics of a connection manager.
+ *
+ * The playground is divided into cells of a configurable fraction of the
+ * reach (usually the maximum interference distance). The neighborhood of a
+ * cell is every cell whose box comes within the reach of the cell's box, so
+ * nics can only be connected to nics in the neighborhood of their cell. With
+ * cells as large as the reach this is the 3x3x3 block around the cell; smaller
+ * cells follow the disk around the cell more closely, so fewer nics out of
+ * range are tested.
+ *
+ * All cells are kept in one contiguous array, each cell holding a dense array
+ * of the slots of its nics. A slot identifies a nic in the grid; the
+ * positions of all slots are stored as separate x/y/z arrays, so scanning
+ * the nics of a cell touches contiguous memory only. Moving a nic to another
+ * cell removes it from its old cell by swapping it with the cell's last nic.
+ * Slots of removed nics are re-used.
+ *
+ * Optionally, a cell holding more nics than a threshold is subdivided into
+ * sub-cells, which are appended to the array of cells and replace the cell
+ * until rebalance() finds it sparse again. Only dense cells pay for the finer
+ * resolution, empty parts of a large playground stay single coarse cells.
+ *
+ * @ingroup connectionManager
+ * @sa BaseConnectionManager
+ */
+class VEINS_API NicGrid {
+public:
+    /**
+     * @brief The cells to visit for a connection update, without duplicates.
+     *
+     * Keeps its memory when cleared, so a re-used set does not allocate.
+     */
+    class VEINS_API CellSet {
+    public:
+        void clear()
+        {
+            cells.clear();
+        }
+
+        size_t size() const
+        {
+            return cells.size();
+        }
+
+        int operator[](size_t i) const
+        {
+            return cells[i];
+        }
+
+    private:
+        friend class NicGrid;
+
+        void append(int cell)
+        {
+            cells.push_back(cell);
+        }
+
+        void removeDuplicates()
+        {
+            std::sort(cells.begin(), cells.end());
+            cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+        }
+
+        std::vector<int> cells;
+    };
+
+    NicGrid();
+
+    /**
+     * @brief Divides the playground into cells of at least the given fraction of the reach.
+     *
+     * Removes all nics and disables subdivision. If the playground is at most
+     * 3x3x3 times the reach, (nearly) every cell would be a neighbor of every
+     * other cell, so it is reduced to a single cell.
+     *
+     * @param playgroundSize size of the playground
+     * @param reach maximum distance of two nics in neighboring cells (usually the maximum interference distance)
+     * @param useTorus whether the borders of the playground are connected
+     * @param cellSizeFactor minimum width of a cell relative to the reach, in (0, 1]
+     */
+    void configure(const Coord& playgroundSize, double reach, bool useTorus, double cellSizeFactor = 1);
+
+    /**
+     * @brief Subdivides cells holding more than threshold nics into subdivisions sub-cells per axis.
+     *
+     * Must be called while the grid is empty. Axes along which the playground
+     * is thinner than a sub-cell are not subdivided.
+     *
+     * @param subdivisions number of sub-cells per axis, 1 to never subdivide
+     * @param threshold number of nics above which a cell is subdivided
+     */
+    void configureSubdivision(int subdivisions, size_t threshold);
+
+    /**
+     * @brief Merges subdivided cells which are no longer dense.
+     *
+     * Changes the cells of nics, so it must not be called while cells
+     * returned earlier are still used.
+     */
+    void rebalance();
+
+    /** @brief Adds a nic at the given position and returns its slot */
+    int insert(int nicId, const Coord& pos);
+
+    /** @brief Removes the nic in the given slot */
+    void remove(int slot);
+
+    /** @brief Moves the nic in the given slot to the given position, updating its cell */
+    void move(int slot, const Coord& pos);
+
+    /** @brief Returns the index of the cell containing the given position */
+    int getCellForCoordinate(const Coord& pos) const;
+
+    /** @brief Returns the index of the cell of the nic in the given slot */
+    int getCell(int slot) const
+    {
+        return slotCell[slot];
+    }
+
+    /**
+     * @brief Returns the Z-order (Morton code) of the coarse cell of the nic in the given slot.
+     *
+     * Nics sorted by this key form spatially compact runs at every scale, so
+     * consecutive ranges of them cover compact regions of the playground.
+     */
+    uint64_t getSpatialKey(int slot) const;
+
+    /** @brief Returns the id of the nic in the given slot */
+    int getNicId(int slot) const
+    {
+        return slotNicId[slot];
+    }
+
+    /** @brief Returns the slots of all nics in the given cell */
+    const std::vector<int>& getCellSlots(int cell) const
+    {
+        return cells[cell];
+    }
+
+    /** @brief Adds the given cell and all cells within the reach of it (wrapping around if the playground is a torus) */
+    void addNeighborCells(int cell, CellSet& result) const;
+
+    /** @brief Returns the squared distance between the nics in the given slots (along the torus, if used) */
+    double sqrDist(int slotA, int slotB) const;
+
+    /** @brief Returns the number of (coarse) cells along x, y, and z */
+    int getDimX() const
+    {
+        return dimX;
+    }
+    int getDimY() const
+    {
+        return dimY;
+    }
+    int getDimZ() const
+    {
+        return dimZ;
+    }
+
+    /** @brief Returns the size of a (coarse) cell */
+    const Coord& getCellSize() const
+    {
+        return cellSize;
+    }
+
+    /** @brief Returns the number of cells including sub-cells, which are numbered after the coarse cells */
+    int getNumCells() const
+    {
+        return static_cast<int>(cells.size());
+    }
+
+    /** @brief Returns the number of cells currently subdivided */
+    size_t getNumSubdividedCells() const
+    {
+        return blockCoarseCell.size() - freeBlocks.size();
+    }
+
+    /**
+     * @brief Returns a lower bound of the distance between any nic and the nics outside the neighborhood of its cell.
+     *
+     * At least the reach; infinity if the grid is a single cell that is never subdivided.
+     */
+    double getMinOutsideDistance() const
+    {
+        // sub-cells outside of a neighborhood are only known to be beyond the reach
+        return subCellsPerBlock > 1 ? std::min(minOutsideDistance, reach) : minOutsideDistance;
+    }
+
+    /** @brief Returns the number of nics in the grid */
+    size_t size() const
+    {
+        return slotNicId.size() - freeSlots.size();
+    }
+
+protected:
+    /** @brief Offset of a neighboring coarse cell */
+    struct CellOffset {
+        int x;
+        int y;
+        int z;
+    };
+
+    /** @brief Returns the cell index of the given cell coordinates, -1 if they are outside the grid (and it is no torus) */
+    int cellIndex(int x, int y, int z) const;
+
+    /** @brief Wraps a cell coordinate around if the playground is a torus, -1 if it is outside the grid otherwise */
+    int wrapIfTorus(int value, int max) const;
+
+    /** @brief Returns the coarse cell of the given (coarse or sub-) cell */
+    int getCoarseCell(int cell) const;
+
+    /** @brief Returns the lower corner and the size of the given cell */
+    void getCellBox(int cell, Coord& origin, Coord& size) const;
+
+    /** @brief Adds a nic to the given cell, subdividing it if it becomes dense */
+    void addToCell(int slot, int cell);
+
+    /** @brief Removes a nic from its cell, marking the cell for rebalance() if it becomes sparse */
+    void removeFromCell(int slot);
+
+    /** @brief Moves the nics of the given coarse cell into new sub-cells */
+    void subdivide(int coarseCell);
+
+    /** @brief Moves the nics of the sub-cells of the given coarse cell back into it */
+    void merge(int coarseCell);
+
+    Coord playgroundSize;
+    Coord cellSize;
+    bool useTorus;
+    int dimX;
+    int dimY;
+    int dimZ;
+    double reach;
+
+    /** @brief Offsets of the coarse cells within the reach of a coarse cell, see configure() */
+    std::vector<CellOffset> neighborOffsets;
+
+    /** @brief May neighborOffsets reach a cell more than once (on a torus only a few cells wide)? */
+    bool neighborOffsetsWrap;
+
+    double minOutsideDistance; ///< of the coarse cells, see getMinOutsideDistance()
+
+    /**
+     * @brief Slots of the nics of each cell
+     *
+     * The coarse cell at x, y, z is at index x + dimX * (y + dimY * z). Blocks
+     * of sub-cells follow, the sub-cell at sx, sy, sz of block b at index
+     * numCoarseCells + b * subCellsPerBlock + sx + subDimX * (sy + subDimY * sz).
+     */
+    std::vector<std::vector<int>> cells;
+
+    int numCoarseCells;
+
+    /** @name Subdivision of dense cells */
+    /*@{*/
+    int subDimX;
+    int subDimY;
+    int subDimZ;
+    int subCellsPerBlock; ///< 1 if subdivision is disabled
+    size_t subdivisionThreshold;
+    std::vector<size_t> coarseCellSize; ///< number of nics in each coarse cell (including its sub-cells)
+    std::vector<int> coarseCellBlock; ///< block of sub-cells of each coarse cell, -1 if it is not subdivided
+    std::vector<int> blockCoarseCell; ///< coarse cell of each block of sub-cells, -1 if the block is unused
+    std::vector<int> freeBlocks;
+    std::vector<int> mergeCandidates; ///< subdivided coarse cells which became sparse, may hold duplicates
+    /*@}*/
+
+    /** @name Per-slot state */
+    /*@{*/
+    std::vector<double> posX;
+    std::vector<double> posY;
+    std::vector<double> posZ;
+    std::vector<int> slotNicId;
+    std::vector<int> slotCell;
+    std::vector<int> slotIndexInCell; ///< position of the slot in its cell's array
+    /*@}*/
+
+    /** @brief Slots not in use */
+    std::vector<int> freeSlots;
+};
+
+} // namespace veins
@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -77,6 +78,18 @@ public:
     {
         return false;
     }
+
+    /**
+     * Returns an upper bound of the factor filterSignal applies to the power at the given frequency
+     * for a signal sent from senderPos to receiverPos.
+     *
+     * Used to rule out receivers before a signal is sent, so it must never be smaller than the actual factor.
+     * The default only knows about neverIncreasesPower().
+     */
+    virtual double getMaxPowerFactor(const Coord& senderPos, const Coord& receiverPos, double frequency)
+    {
+        return neverIncreasesPower() ? 1.0 : std::numeric_limits<double>::infinity();
+    }
 };
 
 using AnalogueModelList = std::vector<std::unique_ptr<AnalogueModel>>;
@@ -62,6 +62,17 @@ public:
      */
     virtual double getGain(Coord ownPos, Coord ownOrient, Coord otherPos);
 
+    /**
+     * Returns an upper bound of getGain() over all directions.
+     *
+     * Used to rule out receivers before any gain is calculated, so
+     * it must never be smaller than any gain this antenna returns.
+     */
+    virtual double getMaxGain()
+    {
+        return 1.0;
+    };
+
     virtual double getLastAngle()
     {
         return -1.0;
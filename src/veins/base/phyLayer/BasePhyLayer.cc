@@ -85,7 +85,11 @@ void BasePhyLayer::initialize(int stage)
         minPowerLevel = par("minPowerLevel").doubleValue();
         minPowerLevel = FWMath::dBm2mW(minPowerLevel);
 
+        cullFanOut = par("cullFanOut").boolValue();
+        interferenceFloor = FWMath::dBm2mW(par("interferenceFloor").doubleValue());
+
         recordStats = par("recordStats").boolValue();
+        trackInterference = par("trackInterference").boolValue();
 
         radio = initializeRadio();
 
@@ -178,6 +182,11 @@ void BasePhyLayer::finish()
 {
     // give decider the chance to do something
     decider->finish();
+
+    if (cullFanOut) {
+        recordScalar("fanOutFrames", numFanOutFrames);
+        recordScalar("fanOutCulled", numFanOutCulled);
+    }
 }
 
 // -----Decider initialization----------------------
@@ -436,6 +445,12 @@ void BasePhyLayer::handleAirFrameStartReceive(AirFrame* frame)
 
     filterSignal(frame);
 
+    if (trackInterference) {
+        // the total can only be updated with the final receive power
+        frame->getSignal().applyAllAnalogueModels();
+        interferenceTracker.addSignal(&frame->getSignal(), simTime());
+    }
+
     if (decider && isKnownProtocolId(frame->getProtocolId())) {
         frame->setState(static_cast<int>(AirFrameState::receiving));
 
@@ -492,6 +507,10 @@ void BasePhyLayer::handleAirFrameEndReceive(AirFrame* frame)
 
     simtime_t earliestInfoPoint = channelInfo.removeAirFrame(frame);
 
+    if (trackInterference) {
+        interferenceTracker.removeSignal(&frame->getSignal(), simTime());
+    }
+
     /* clean information in the radio until earliest time-point
      * of information in the ChannelInfo,
      * since this time-point might have changed due to removal of
@@ -672,6 +691,40 @@ void BasePhyLayer::filterSignal(AirFrame* frame)
     }
 }
 
+bool BasePhyLayer::canReach(cPacket* msg, const NicEntry* nic)
+{
+    if (!cullFanOut) return true;
+
+    BasePhyLayer* receiver = dynamic_cast<BasePhyLayer*>(nic->chAccess);
+    AirFrame* frame = dynamic_cast<AirFrame*>(msg);
+    if (receiver == nullptr || frame == nullptr) return true;
+
+    const Coord senderPos = antennaPosition.getPositionAt();
+    const Coord receiverPos = receiver->antennaPosition.getPositionAt();
+    const Signal& signal = frame->getSignal();
+    const double maxGain = antenna->getMaxGain() * receiver->antenna->getMaxGain();
+    // the receiver multiplies the gains and attenuations in a different order, so allow for their rounding errors
+    const double cullBelow = receiver->interferenceFloor * (1 - 1e-9);
+
+    for (size_t i = 0; i < signal.getNumValues(); i++) {
+        double power = signal.at(i) * maxGain;
+        if (power < cullBelow) continue;
+
+        double frequency = signal.getSpectrum().freqAt(i);
+        for (auto& analogueModel : receiver->analogueModels) {
+            power *= analogueModel->getMaxPowerFactor(senderPos, receiverPos, frequency);
+        }
+        for (auto& analogueModel : receiver->analogueModelsThresholding) {
+            power *= analogueModel->getMaxPowerFactor(senderPos, receiverPos, frequency);
+        }
+        // also keeps the receiver if the bound is undefined (e.g., zero times infinity)
+        if (!(power < cullBelow)) return true;
+    }
+
+    EV_TRACE << "Not sending frame to " << nic->nicId << ", it cannot exceed the interference floor" << endl;
+    return false;
+}
+
 // --Destruction--------------------------------
 
 BasePhyLayer::~BasePhyLayer()
@@ -772,6 +825,11 @@ double BasePhyLayer::getNoiseFloorValue()
     return noiseFloorValue;
 }
 
+const InterferenceTracker* BasePhyLayer::getInterferenceTracker() const
+{
+    return trackInterference ? &interferenceTracker : nullptr;
+}
+
 void BasePhyLayer::sendControlMsgToMac(cMessage* msg)
 {
     sendControlMessageUp(msg);
@@ -36,6 +36,7 @@
 #include "veins/base/phyLayer/MacToPhyInterface.h"
 #include "veins/base/phyLayer/Antenna.h"
 #include "veins/base/phyLayer/ChannelInfo.h"
+#include "veins/base/phyLayer/InterferenceTracker.h"
 
 namespace veins {
 
@@ -116,8 +117,12 @@ protected:
     int protocolId = PROTOCOL_ID_GENERIC; ///< The ID of the protocol this phy can transceive.
     double noiseFloorValue = 0; ///< Catch-all for all factors negatively impacting SINR (e.g., thermal noise, noise figure, ...)
     double minPowerLevel; ///< The minimum receive power needed to even attempt decoding a frame.
+    bool cullFanOut; ///< Stores if frames are only sent to receivers they can reach above the receiver's interference floor.
+    double interferenceFloor; ///< Receive power below which a frame may be culled by a sender using cullFanOut.
     bool recordStats; ///< Stores if tracking of statistics (esp. cOutvectors) is enabled.
     ChannelInfo channelInfo; ///< Channel info keeps track of received AirFrames and provides information about currently active AirFrames at the channel.
+    bool trackInterference; ///< Stores if the total power of all AirFrames on the channel is kept up to date in interferenceTracker.
+    InterferenceTracker interferenceTracker; ///< Running total of the power of the (fully attenuated) AirFrames on the channel.
     std::unique_ptr<Radio> radio; ///< The state machine storing the current radio state (TX, RX, SLEEP).
 
     /**
@@ -339,6 +344,18 @@ protected:
      */
     virtual void filterSignal(AirFrame* frame);
 
+    /**
+     * Decide if the passed AirFrame can reach the passed receiver above the receiver's interference floor.
+     *
+     * Only does something if cullFanOut is enabled. Bounds the receive power by the maximum gains of both antennas
+     * and the maximum power factors the receiver's AnalogueModels return for the current positions, so random
+     * and position independent parts of the channel never cause a frame to be culled wrongly.
+     *
+     * @see Antenna::getMaxGain
+     * @see AnalogueModel::getMaxPowerFactor
+     */
+    bool canReach(cPacket* msg, const NicEntry* nic) override;
+
     /**
      * Called when the switching process of the Radio is finished.
      *
@@ -434,6 +451,11 @@ public:
      */
     double getNoiseFloorValue() override;
 
+    /**
+     * Return the interference tracker if trackInterference is set, nullptr otherwise.
+     */
+    const InterferenceTracker* getInterferenceTracker() const override;
+
     /**
      * Send the given message to via the control gate to the mac.
      *
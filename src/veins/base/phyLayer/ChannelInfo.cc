@@ -24,197 +24,171 @@
 
 #include "veins/base/phyLayer/ChannelInfo.h"
 
-#include <iostream>
+#include <algorithm>
+#include <iterator>
 
 using namespace veins;
 
 using veins::AirFrame;
 
-void ChannelInfo::addAirFrame(AirFrame* frame, simtime_t_cref startTime)
-{
-    ASSERT(airFrameStarts.count(frame) == 0);
+namespace {
 
-    // check if we were previously empty
-    if (isChannelEmpty()) {
-        // earliest time point is current sim time
-        earliestInfoPoint = startTime;
+/** @brief Orders the inactive AirFrames of a min-heap by their end time.*/
+struct EndsLater {
+    template <class T>
+    bool operator()(const T& a, const T& b) const
+    {
+        return a.end > b.end;
     }
+};
 
-    // calculate endTime of AirFrame
-    simtime_t_cref endTime = startTime + frame->getDuration();
+} // namespace
 
-    // add AirFrame to active AirFrames
-    activeAirFrames[endTime].push_back(AirFrameTimePair(startTime, frame));
+void ChannelInfo::addAirFrame(AirFrame* frame, simtime_t_cref startTime)
+{
+    ASSERT(isChannelEmpty() || entryAt(endIndex - 1).start <= startTime);
 
-    // add to start time map
-    airFrameStarts[frame] = startTime;
+    if (endIndex - firstIndex == entries.size()) {
+        grow();
+    }
 
-    ASSERT(!isChannelEmpty());
-}
+    simtime_t_cref duration = frame->getDuration();
+    entryAt(endIndex) = Entry{frame, startTime, startTime + duration, true};
+    frame->setChannelInfoIndex(endIndex);
 
-simtime_t ChannelInfo::findEarliestInfoPoint()
-{
-    // TODO: check for a more efficient way to find out that earliest time-point
-
-    // make a variable for the earliest-start-time of all remaining AirFrames
-    simtime_t earliestStart = SIMTIME_ZERO;
-    AirFrameStartMap::const_iterator it = airFrameStarts.begin();
-
-    // if there is an entry for an AirFrame
-    if (it != airFrameStarts.end()) {
-        // store the start-time of the first entry as earliestStart so far
-        earliestStart = (*it).second;
-
-        // go through all other start-time-points
-        for (; it != airFrameStarts.end(); ++it) {
-            // and check if an earlier start-time was found,
-            // if so, replace earliestStart with it
-            if ((*it).second < earliestStart) earliestStart = (*it).second;
-        }
+    if (numActive == 0) {
+        firstActiveIndex = endIndex;
     }
+    ++numActive;
+    ++endIndex;
 
-    return earliestStart;
+    if (duration > maxDuration) {
+        maxDuration = duration;
+    }
+
+    ASSERT(!isChannelEmpty());
 }
 
 simtime_t ChannelInfo::removeAirFrame(AirFrame* frame)
 {
-    ASSERT(airFrameStarts.count(frame) > 0);
+    size_t index = frame->getChannelInfoIndex();
+    ASSERT(index >= firstIndex && index < endIndex);
 
-    // get start of AirFrame
-    simtime_t_cref startTime = airFrameStarts[frame];
+    Entry& entry = entryAt(index);
+    ASSERT(entry.frame == frame && entry.active);
 
-    // calculate end time
-    simtime_t_cref endTime = startTime + frame->getDuration();
+    entry.active = false;
+    --numActive;
 
-    // remove this AirFrame from active AirFrames
-    deleteAirFrame(activeAirFrames, frame, startTime, endTime);
-
-    // add to inactive AirFrames
-    addToInactives(frame, startTime, endTime);
+    // the earliest active AirFrame might have moved on in time
+    while (firstActiveIndex < endIndex && !entryAt(firstActiveIndex).active) {
+        ++firstActiveIndex;
+    }
 
-    // Now check, whether the earliest time-point we need to store information
-    // for might have moved on in time, since an AirFrame has been deleted.
-    if (isChannelEmpty()) {
-        earliestInfoPoint = -1;
+    if (canDiscard(entry)) {
+        discard(index);
     }
     else {
-        earliestInfoPoint = findEarliestInfoPoint();
+        inactiveEnds.push_back(InactiveEnd{entry.end, index});
+        std::push_heap(inactiveEnds.begin(), inactiveEnds.end(), EndsLater());
     }
 
-    return earliestInfoPoint;
+    // At last, check if some inactive AirFrames can be removed because the
+    // removed AirFrame was the last active one they intersected with.
+    discardUnneeded();
+
+    return getEarliestInfoPoint();
 }
 
-void ChannelInfo::assertNoIntersections()
+void ChannelInfo::grow()
 {
-    for (AirFrameMatrix::iterator it1 = inactiveAirFrames.begin(); it1 != inactiveAirFrames.end(); ++it1) {
-        simtime_t_cref e0 = it1->first;
-        for (AirFrameTimeList::iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2) {
-            simtime_t_cref s0 = it2->first;
-
-            bool intersects = (recordStartTime > -1 && recordStartTime <= e0);
-
-            for (AirFrameMatrix::iterator it3 = activeAirFrames.begin(); it3 != activeAirFrames.end() && !intersects; ++it3) {
-                simtime_t_cref e1 = it3->first;
-                for (AirFrameTimeList::iterator it4 = it3->second.begin(); it4 != it3->second.end() && !intersects; ++it4) {
-                    simtime_t_cref s1 = it4->first;
-
-                    if (e0 >= s1 && s0 <= e1) intersects = true;
-                }
-            }
-            ASSERT(intersects);
-        }
+    std::vector<Entry> grown(std::max<size_t>(16, 2 * entries.size()));
+    for (size_t index = firstIndex; index < endIndex; ++index) {
+        grown[index & (grown.size() - 1)] = entryAt(index);
     }
+    entries.swap(grown);
 }
 
-void ChannelInfo::deleteAirFrame(AirFrameMatrix& airFrames, AirFrame* frame, simtime_t_cref startTime, simtime_t_cref endTime)
+size_t ChannelInfo::findFirstStartingFrom(simtime_t_cref time) const
 {
-    AirFrameMatrix::iterator listIt = airFrames.find(endTime);
-    AirFrameTimeList* list = &listIt->second;
-
-    for (AirFrameTimeList::iterator it = list->begin(); it != list->end(); it++) {
-        if (it->second == frame) {
-            it = list->erase(it);
-            if (list->empty()) {
-                airFrames.erase(listIt);
-            }
-            return;
+    size_t low = firstIndex;
+    size_t high = endIndex;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (entryAt(middle).start < time) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
         }
     }
-
-    ASSERT(false);
+    return low;
 }
 
-bool ChannelInfo::canDiscardInterval(simtime_t_cref startTime, simtime_t_cref endTime)
+bool ChannelInfo::canDiscard(const Entry& entry) const
 {
     ASSERT(recordStartTime >= 0 || recordStartTime == -1);
 
     // only if it ends before the point in time we started recording or if
     // we aren't recording at all and it does not intersect with any active one
     // anymore this AirFrame can be deleted
-    return (recordStartTime > endTime || recordStartTime == -1) && !isIntersecting(activeAirFrames, startTime, endTime);
+    bool recorded = recordStartTime > -1 && recordStartTime <= entry.end;
+    bool intersectsActive = numActive > 0 && entryAt(firstActiveIndex).start <= entry.end;
+    return !recorded && !intersectsActive;
 }
 
-void ChannelInfo::checkAndCleanInterval(simtime_t_cref startTime, simtime_t_cref endTime)
+void ChannelInfo::discard(size_t index)
 {
-
-    // get through inactive AirFrame which intersected with the passed interval
-    IntersectionIterator inactiveIntersectIt(&inactiveAirFrames, startTime, endTime);
-
-    AirFrame* inactiveIntersect = inactiveIntersectIt.next();
-    while (inactiveIntersect != nullptr) {
-        simtime_t_cref currentStart = airFrameStarts[inactiveIntersect];
-        simtime_t_cref currentEnd = currentStart + inactiveIntersect->getDuration();
-
-        if (canDiscardInterval(currentStart, currentEnd)) {
-            inactiveIntersectIt.eraseAirFrame();
-
-            airFrameStarts.erase(inactiveIntersect);
-
-            delete inactiveIntersect;
-            inactiveIntersect = nullptr;
-        }
-        inactiveIntersect = inactiveIntersectIt.next();
-    }
+    Entry& entry = entryAt(index);
+    delete entry.frame;
+    entry.frame = nullptr;
 }
 
-void ChannelInfo::addToInactives(AirFrame* frame, simtime_t_cref startTime, simtime_t_cref endTime)
+void ChannelInfo::discardUnneeded()
 {
-    // At first, check if some inactive AirFrames can be removed because the
-    // AirFrame to in-activate was the last one they intersected with.
-    checkAndCleanInterval(startTime, endTime);
+    // AirFrames ending earlier are discarded first, so stop at the first one still needed
+    while (!inactiveEnds.empty() && canDiscard(entryAt(inactiveEnds.front().index))) {
+        size_t index = inactiveEnds.front().index;
+        std::pop_heap(inactiveEnds.begin(), inactiveEnds.end(), EndsLater());
+        inactiveEnds.pop_back();
+        discard(index);
+    }
 
-    if (!canDiscardInterval(startTime, endTime)) {
-        inactiveAirFrames[endTime].push_back(AirFrameTimePair(startTime, frame));
+    while (firstIndex < endIndex && entryAt(firstIndex).frame == nullptr) {
+        ++firstIndex;
     }
-    else {
-        airFrameStarts.erase(frame);
 
-        delete frame;
+    if (isChannelEmpty()) {
+        maxDuration = SIMTIME_ZERO;
     }
 }
 
-bool ChannelInfo::isIntersecting(const AirFrameMatrix& airFrames, simtime_t_cref from, simtime_t_cref to) const
+void ChannelInfo::getAirFrames(simtime_t_cref from, simtime_t_cref to, AirFrameVector& out) const
 {
-    ConstIntersectionIterator it(&airFrames, from, to);
-    return (it.next() != nullptr);
-}
+    if (isChannelEmpty()) return;
 
-void ChannelInfo::getIntersections(const AirFrameMatrix& airFrames, simtime_t_cref from, simtime_t_cref to, AirFrameVector& outVector) const
-{
-    ConstIntersectionIterator it(&airFrames, from, to);
+    // AirFrames starting at the same time are stored in the order they arrived,
+    // which can differ between equivalent runs, so they are returned by id
+    auto groupBegin = out.end();
+    simtime_t groupStart = -1;
 
-    AirFrame* intersect = it.next();
-    while (intersect != nullptr) {
-        outVector.push_back(intersect);
-        intersect = it.next();
-    }
-}
+    // A time interval A_start to A_end intersects with another interval
+    // B_start to B_end iff A_end >= B_start and A_start <= B_end.
+    for (size_t index = findFirstStartingFrom(from - maxDuration); index < endIndex; ++index) {
+        const Entry& entry = entryAt(index);
+        if (entry.start > to) break;
 
-void ChannelInfo::getAirFrames(simtime_t_cref from, simtime_t_cref to, AirFrameVector& out) const
-{
-    // check for intersecting inactive AirFrames
-    getIntersections(inactiveAirFrames, from, to, out);
+        if (entry.frame == nullptr || entry.end < from) continue;
 
-    // check for intersecting active AirFrames
-    getIntersections(activeAirFrames, from, to, out);
+        if (groupBegin == out.end() || entry.start != groupStart) {
+            groupBegin = out.insert(out.end(), entry.frame);
+            groupStart = entry.start;
+            continue;
+        }
+
+        auto position = out.end();
+        while (position != groupBegin && (*std::prev(position))->getId() > entry.frame->getId()) --position;
+        auto inserted = out.insert(position, entry.frame);
+        if (position == groupBegin) groupBegin = inserted;
+    }
 }
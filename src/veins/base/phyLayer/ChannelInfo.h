@@ -25,6 +25,7 @@
 #pragma once
 
 #include <list>
+#include <vector>
 
 #include "veins/veins.h"
 
@@ -51,6 +52,14 @@ namespace veins {
  * store also the AirFrames which are over but still intersect with an currently
  * running AirFrame.
  *
+ * The AirFrames are kept in a ring buffer in the order they were added, which
+ * is the order of their start times. An AirFrame stores its position in the
+ * buffer (channelInfoIndex), so it is found without a search when it is
+ * removed. Removed AirFrames which are still needed are kept in a min-heap by
+ * their end times, so the ones which are not needed anymore can be discarded
+ * from its top. Once the buffer has grown to the number of AirFrames on the
+ * channel, no operation allocates memory.
+ *
  * Note: ChannelInfo assumes that the AirFrames are added and removed
  *          chronologically. This means every time you add an AirFrame with a
  *          specific start time ChannelInfo assumes that start time as the current
@@ -64,304 +73,111 @@ namespace veins {
  * @ingroup phyLayer
  */
 class VEINS_API ChannelInfo {
-
-protected:
-    /** @brief Type for a pair of an AirFrame and a simulation time.*/
-    typedef std::pair<simtime_t, AirFrame*> AirFrameTimePair;
-    /** @brief Type for a list of AirFrames and a simulation time.*/
-    using AirFrameTimeList = std::list<AirFrameTimePair>;
-    /**
-     * The AirFrames are stored in a Matrix with start- and end time as
-     * dimensions.
-     */
-    typedef std::map<simtime_t, AirFrameTimeList> AirFrameMatrix;
-
+public:
     /**
-     * @brief Iterator for every intersection of a specific interval in a
-     * AirFrameMatrix.
-     *
-     * A time interval A_start to A_end intersects with another interval B_start
-     * to B_end iff the following two conditions are fulfilled:
-     *
-     *         1. A_end >= B_start.
-     *         2. A_start <= B_end and
-     *
-     * Or the defined by the
-     * opposite: The two intervals do not intersect iff A_end < B_start or
-     * A_start > B_end.
-     *
-     * To iterate over a two dimensional (end-time x start-time) container
-     * of AirFrames this class iterates over all AirFrame-lists whose end-time
-     * is bigger or equal than the interval start (intersect condition 1) and in
-     * each of these lists iterates over all entries but only stops at and
-     * returns entries which start-time is smaller or equal than the interval
-     * end (intersection condition 2).
+     * @brief Type for a container of AirFrames.
      *
-     * In template form to work as const- and non-const iterator.
+     * Used as out type for "getAirFrames" method.
      */
-    template <class C, class ItMatrix, class ItList>
-    class VEINS_API BaseIntersectionIterator {
-    public:
-        /** @brief Pointer to the matrix holding the intervals.*/
-        C* intervals;
-
-        /** @brief Point in time to start iterating over intersections.*/
-        simtime_t from;
-
-        /** @brief Point in time to end iterating over intersections.*/
-        simtime_t to;
-
-        /** @brief Iterator over AirFrame end times.*/
-        ItMatrix endIt;
-
-        /** @brief Iterator over AirFrame start times.*/
-        ItList startIt;
-
-        /** @brief True if the we are already pointing to the next entry.*/
-        bool alreadyNext;
-
-    public:
-        /**
-         * @brief Creates an iterator for the specified interval at the
-         * specified AirFrameMatrix.
-         */
-        BaseIntersectionIterator(C* airFrames, simtime_t_cref from, simtime_t_cref to)
-            : intervals(airFrames)
-            , from(from)
-            , to(to)
-        {
-            // begin at the smallest end-time-entry fulfilling the intersection
-            // condition 1
-            endIt = intervals->lower_bound(from);
-
-            if (endIt != intervals->end()) {
-                startIt = endIt->second.begin();
-            }
-            // we are already pointing at the first unchecked interval
-            alreadyNext = true;
-        }
+    using AirFrameVector = std::list<AirFrame*>;
 
-        /**
-         * @brief Increases the iterator to the next intersecting AirFrame and
-         * returns a pointer to this AirFrame.
-         */
-        AirFrame* next()
-        {
-            if (endIt == intervals->end()) return nullptr;
-
-            // "alreadyNext" indicates that some previous iterator function has
-            // already increased the intern iterators to a yet unchecked values.
-            // This happens after initialization of the iterator and when an
-            // element is erased.
-            if (alreadyNext)
-                alreadyNext = false;
-            else
-                startIt++;
-
-            while (endIt != intervals->end()) {
-                // while there are entries left at the current end-time
-                while (startIt != endIt->second.end()) {
-                    // check if this entry fulfilles the intersection condition
-                    // 2 (condition 1 is already fulfilled in the constructor by
-                    // the start-value of the end-time-iterator)
-                    if (startIt->first <= to) {
-                        return startIt->second;
-                    }
-                    startIt++;
-                }
-
-                endIt++;
-                if (endIt == intervals->end()) return nullptr;
-
-                startIt = endIt->second.begin();
-            }
-
-            return nullptr;
-        }
+protected:
+    /** @brief An AirFrame on the channel and the interval it is received in.*/
+    struct Entry {
+        AirFrame* frame; ///< nullptr once the AirFrame has been discarded
+        simtime_t start;
+        simtime_t end;
+        bool active; ///< added but not yet removed
     };
 
-    /** @brief Type for a const-iterator over an AirFrame interval matrix.*/
-    typedef BaseIntersectionIterator<const AirFrameMatrix, AirFrameMatrix::const_iterator, AirFrameTimeList::const_iterator> ConstIntersectionIterator;
+    /** @brief The end time of an inactive AirFrame and its position.*/
+    struct InactiveEnd {
+        simtime_t end;
+        size_t index;
+    };
 
     /**
-     * @brief Type for a iterator over an AirFrame interval matrix.
+     * @brief Ring buffer of the AirFrames in the order they were added.
      *
-     * Extends the const-version by an erase method.
+     * Holds the AirFrames with indices firstIndex up to endIndex - 1, the one
+     * with index i at i & (entries.size() - 1). Its size is a power of two.
+     * Discarded AirFrames leave an empty entry behind until they reach the
+     * front.
      */
-    class VEINS_API IntersectionIterator : public BaseIntersectionIterator<AirFrameMatrix, AirFrameMatrix::iterator, AirFrameTimeList::iterator> {
-    private:
-        /** @brief Type for shortcut to base class type.*/
-        typedef BaseIntersectionIterator<AirFrameMatrix, AirFrameMatrix::iterator, AirFrameTimeList::iterator> Base;
-
-    public:
-        /**
-         * @brief Creates an iterator for the specified interval at the
-         * specified AirFrameMatrix.
-         */
-        IntersectionIterator(AirFrameMatrix* airFrames, simtime_t_cref from, simtime_t_cref to)
-            : Base(airFrames, from, to)
-        {
-        }
+    std::vector<Entry> entries;
 
-        /**
-         * @brief Erases the AirFrame the iterator currently points to from the
-         * AirFrameMatrix.
-         *
-         * After the erase the iterator points to an invalid value and "next()"
-         * should be called.
-         */
-        void eraseAirFrame()
-        {
-            ASSERT(endIt != intervals->end());
-            ASSERT(startIt != endIt->second.end());
-
-            // erase AirFrame from list
-            startIt = endIt->second.erase(startIt);
-
-            // check if we've deleted the last entry in the list
-            if (startIt == endIt->second.end()) {
-                // check if we deleted the only entry in the list
-                if (endIt->second.empty()) {
-                    intervals->erase(endIt++); // delete list from map
-                }
-                else {
-                    endIt++;
-                }
-
-                // increase to a valid value if we are not done
-                if (endIt != intervals->end()) {
-                    startIt = endIt->second.begin();
-                }
-            }
-            alreadyNext = true;
-        }
-    };
+    /** @brief Index of the oldest AirFrame which has not been discarded.*/
+    size_t firstIndex = 0;
+
+    /** @brief Index the next AirFrame is added at.*/
+    size_t endIndex = 0;
+
+    /** @brief Index of the oldest active AirFrame, endIndex if there is none.*/
+    size_t firstActiveIndex = 0;
+
+    /** @brief Number of active AirFrames.*/
+    size_t numActive = 0;
 
     /**
-     * @brief Stores the currently active AirFrames.
+     * @brief Longest duration of the AirFrames on the channel.
      *
-     * This means every AirFrame which was added but not yet removed.
+     * AirFrames starting more than this before an interval cannot intersect
+     * with it.
      */
-    AirFrameMatrix activeAirFrames;
+    simtime_t maxDuration;
 
     /**
-     * @brief Stores inactive AirFrames.
+     * @brief Min-heap of the end times of the inactive AirFrames.
      *
-     * This means every AirFrame which has been already removed but still is
-     * needed because it intersect with one or more active AirFrames.
+     * Inactive AirFrames have already been removed but are still needed
+     * because they intersect with one or more active AirFrames.
      */
-    AirFrameMatrix inactiveAirFrames;
-
-    /** @brief Type for a map of AirFrame pointers to their start time.*/
-    typedef std::map<AirFrame*, simtime_t> AirFrameStartMap;
-
-    /** @brief Stores the start time of every AirFrame.*/
-    AirFrameStartMap airFrameStarts;
-
-    /** @brief Stores the point in history up to which we have some (but not
-     * necessarily all) channel information stored.*/
-    simtime_t earliestInfoPoint;
+    std::vector<InactiveEnd> inactiveEnds;
 
     /** @brief Stores a point in history up to which we need to keep all channel
      * information stored.*/
     simtime_t recordStartTime;
 
-public:
-    /**
-     * @brief Type for a container of AirFrames.
-     *
-     * Used as out type for "getAirFrames" method.
-     */
-    using AirFrameVector = std::list<AirFrame*>;
-
 protected:
-    /**
-     * @brief Asserts that every inactive AirFrame is still intersecting with at
-     * least one active airframe or with the current record start time.
-     */
-    void assertNoIntersections();
-
-    /**
-     * @brief Returns every AirFrame of an AirFrameMatrix which intersect with a
-     * given interval.
-     *
-     * The intersecting AirFrames are stored in the AirFrameVector reference
-     * passed as parameter.
-     */
-    void getIntersections(const AirFrameMatrix& airFrames, simtime_t_cref from, simtime_t_cref to, AirFrameVector& outVector) const;
-
-    /**
-     * @brief Returns true if there is at least one AirFrame in the passed
-     * AirFrameMatrix which intersect with the given interval.
-     */
-    bool isIntersecting(const AirFrameMatrix& airFrames, simtime_t_cref from, simtime_t_cref to) const;
+    Entry& entryAt(size_t index)
+    {
+        return entries[index & (entries.size() - 1)];
+    }
 
-    /**
-     * @brief Moves a previously active AirFrame to the inactive AirFrames.
-     *
-     * This methods checks if there are some inactive AirFrames which can be
-     * deleted because the AirFrame to in-activate was the last one they
-     * intersected with.
-     * It also checks if the AirFrame to in-activate still intersect with at
-     * least one active AirFrame before it is moved to inactive AirFrames.
-     */
-    void addToInactives(AirFrame* a, simtime_t_cref startTime, simtime_t_cref endTime);
+    const Entry& entryAt(size_t index) const
+    {
+        return entries[index & (entries.size() - 1)];
+    }
 
-    /**
-     * @brief Deletes an AirFrame from an AirFrameMatrix.
-     */
-    void deleteAirFrame(AirFrameMatrix& airFrames, AirFrame* a, simtime_t_cref startTime, simtime_t_cref endTime);
+    /** @brief Doubles the size of the ring buffer.*/
+    void grow();
 
-    /**
-     * @brief Returns the start time of the odlest AirFrame on the channel.
-     */
-    simtime_t findEarliestInfoPoint();
+    /** @brief Returns the index of the first AirFrame which starts at or after the passed time.*/
+    size_t findFirstStartingFrom(simtime_t_cref time) const;
 
     /**
-     * @brief Checks if any information inside the passed interval can be
-     * discarded.
-     *
-     * This method should be called every time the information for a certain
-     * interval changes (AirFrame is removed or record time changed).
+     * @brief Returns true if an inactive AirFrame is not needed anymore.
      *
-     * @param startTime The start of the interval to check
-     * @param endTime The end of the interval to check
+     * This is the case if it neither intersects with an active AirFrame nor
+     * with the recorded period. As AirFrames are removed chronologically, the
+     * earliest active AirFrame is the one to check.
      */
-    void checkAndCleanInterval(simtime_t_cref startTime, simtime_t_cref endTime);
+    bool canDiscard(const Entry& entry) const;
 
-    /**
-     * @brief Returns true if all information inside the passed interval can be
-     * deleted.
-     *
-     * For example this method is used to check if information for the duration
-     * of an AirFrame is needed anymore and if not the AirFrame is deleted.
-     *
-     * @param startTime The start time of the interval (e.g. AirFrame start)
-     * @param endTime The end time of the interval (e.g. AirFrame end)
-     * @return returns true if any information for the passed interval can be
-     * discarded.
-     */
-    bool canDiscardInterval(simtime_t_cref startTime, simtime_t_cref endTime);
+    /** @brief Deletes the AirFrame at the passed index.*/
+    void discard(size_t index);
 
     /**
-     * @brief Checks if any information up from the passed start time can be
-     * discarded.
+     * @brief Discards every inactive AirFrame which is not needed anymore.
      *
-     * @param start The start of the interval to check
+     * This method should be called every time the information needed changes
+     * (AirFrame is removed or record time changed).
      */
-    void checkAndCleanFrom(simtime_t_cref start)
-    {
-        // nothing to do
-        if (inactiveAirFrames.empty()) return;
-
-        // take last ended inactive airframe as end of interval
-        checkAndCleanInterval(start, inactiveAirFrames.rbegin()->first);
-    }
+    void discardUnneeded();
 
 public:
     ChannelInfo()
-        : earliestInfoPoint(-1)
-        , recordStartTime(-1)
+        : recordStartTime(-1)
     {
     }
 
@@ -393,6 +209,11 @@ public:
      * @brief Fills the passed AirFrameVector reference with the AirFrames which
      * intersect with the given time interval.
      *
+     * The AirFrames are returned in the order of their start times,
+     * AirFrames starting at the same time in the order of their ids. So the
+     * order (and sums over it) does not depend on the order in which
+     * simultaneous AirFrames arrived.
+     *
      * Note: Completeness of the list of AirFrames for specific interval can
      * only be assured if start and end point of the interval lies inside the
      * duration of at least one currently active AirFrame.
@@ -405,11 +226,9 @@ public:
      * @brief Returns the current time-point from that information concerning
      * AirFrames is needed to be stored.
      */
-    simtime_t getEarliestInfoPoint()
+    simtime_t getEarliestInfoPoint() const
     {
-        ASSERT(!isChannelEmpty() || earliestInfoPoint == -1);
-
-        return earliestInfoPoint;
+        return isChannelEmpty() ? simtime_t(-1) : entryAt(firstIndex).start;
     }
 
     /**
@@ -428,14 +247,8 @@ public:
      */
     void startRecording(simtime_t_cref start)
     {
-        // clean up until old record start
-        if (recordStartTime > -1) {
-            recordStartTime = start;
-            checkAndCleanInterval(0, recordStartTime);
-        }
-        else {
-            recordStartTime = start;
-        }
+        recordStartTime = start;
+        discardUnneeded();
     }
 
     /**
@@ -447,9 +260,8 @@ public:
     void stopRecording()
     {
         if (recordStartTime > -1) {
-            simtime_t old = recordStartTime;
             recordStartTime = -1;
-            checkAndCleanFrom(old);
+            discardUnneeded();
         }
     }
 
@@ -468,9 +280,9 @@ public:
      */
     bool isChannelEmpty() const
     {
-        ASSERT(recordStartTime != -1 || activeAirFrames.empty() == airFrameStarts.empty());
+        ASSERT(recordStartTime != -1 || numActive > 0 || inactiveEnds.empty());
 
-        return airFrameStarts.empty();
+        return firstIndex == endIndex;
     }
 };
 
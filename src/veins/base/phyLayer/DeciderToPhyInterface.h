@@ -35,6 +35,8 @@ class AirFrame;
 
 class BaseWorldUtility;
 
+class InterferenceTracker;
+
 /**
  * See Decider.h for definition of DeciderResult
  */
@@ -111,6 +113,18 @@ public:
 
     /** @brief Returns the channel currently used by the radio. */
     virtual int getCurrentRadioChannel() = 0;
+
+    /**
+     * @brief Returns the running total of the power on the channel, or
+     * nullptr if it is not tracked.
+     *
+     * If available, interference can be looked up there instead of being
+     * summed up over the AirFrames returned by getChannelInfo.
+     */
+    virtual const InterferenceTracker* getInterferenceTracker() const
+    {
+        return nullptr;
+    }
 };
 
 } // namespace veins
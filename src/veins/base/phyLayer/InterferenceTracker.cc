@@ -0,0 +1,143 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/base/phyLayer/InterferenceTracker.h"
+
+#include <algorithm>
+
+#include "veins/base/toolbox/SignalKernels.h"
+
+using namespace veins;
+
+void InterferenceTracker::addSignal(const Signal* signal, simtime_t_cref now)
+{
+    ASSERT(!isActive(signal));
+
+    if (activeSignals.empty()) {
+        total = Signal(signal->getSpectrum());
+        history.clear();
+    }
+
+    total += *signal;
+    activeSignals.push_back({signal, now});
+    record(now);
+}
+
+void InterferenceTracker::removeSignal(const Signal* signal, simtime_t_cref now)
+{
+    auto it = std::find_if(activeSignals.begin(), activeSignals.end(), [signal](const ActiveSignal& active) { return active.signal == signal; });
+    ASSERT(it != activeSignals.end());
+    *it = activeSignals.back();
+    activeSignals.pop_back();
+
+    if (activeSignals.empty()) {
+        // start over from zero instead of keeping the rounding errors of all additions and subtractions
+        history.clear();
+        return;
+    }
+
+    total -= *signal;
+    record(now);
+    prune();
+}
+
+bool InterferenceTracker::isActive(const Signal* signal) const
+{
+    return std::any_of(activeSignals.begin(), activeSignals.end(), [signal](const ActiveSignal& active) { return active.signal == signal; });
+}
+
+const Spectrum& InterferenceTracker::getSpectrum() const
+{
+    ASSERT(!isChannelEmpty());
+    return total.getSpectrum();
+}
+
+double InterferenceTracker::getPowerAt(size_t freqIndex, const Signal* exclude) const
+{
+    if (isChannelEmpty()) return 0;
+
+    double power = total.at(freqIndex);
+    if (exclude && isActive(exclude)) {
+        power -= exclude->at(freqIndex);
+    }
+    return std::max(power, 0.0);
+}
+
+Signal InterferenceTracker::getMaxInterference(const Signal* signal, simtime_t_cref start, simtime_t_cref end) const
+{
+    ASSERT(isActive(signal));
+    ASSERT(!history.empty());
+
+    // the total in effect at start is the last one recorded at or before it
+    auto it = std::upper_bound(history.begin(), history.end(), start, [](simtime_t_cref time, const Snapshot& snapshot) { return time < snapshot.time; });
+    if (it != history.begin()) --it;
+
+    Signal interference(total.getSpectrum());
+    double* maximum = interference.getValues();
+    const size_t numValues = interference.getNumValues();
+    std::copy(it->total.getValues(), it->total.getValues() + numValues, maximum);
+    for (++it; it != history.end() && it->time < end; ++it) {
+        const double* values = it->total.getValues();
+        for (size_t i = 0; i < numValues; ++i) {
+            maximum[i] = std::max(maximum[i], values[i]);
+        }
+    }
+
+    // the signal itself was part of every total during its reception
+    const double* own = signal->getValues();
+    for (size_t i = 0; i < numValues; ++i) {
+        maximum[i] = std::max(maximum[i] - own[i], 0.0);
+    }
+    return interference;
+}
+
+double InterferenceTracker::getMinSINR(const Signal* signal, simtime_t_cref start, simtime_t_cref end, double noise) const
+{
+    const Signal interference = getMaxInterference(signal, start, end);
+    return SignalKernels::minQuotient(signal->getDataValues(), interference.getValues() + signal->getDataStart(), noise, signal->getNumDataValues());
+}
+
+void InterferenceTracker::record(simtime_t_cref now)
+{
+    ASSERT(history.empty() || history.back().time <= now);
+
+    if (!history.empty() && history.back().time == now) {
+        history.back().total = total;
+    }
+    else {
+        history.push_back({now, total});
+    }
+}
+
+void InterferenceTracker::prune()
+{
+    simtime_t earliestStart = activeSignals.front().start;
+    for (const auto& active : activeSignals) {
+        earliestStart = std::min(earliestStart, active.start);
+    }
+
+    // keep the total in effect at the earliest start
+    while (history.size() > 1 && history[1].time <= earliestStart) {
+        history.pop_front();
+    }
+}
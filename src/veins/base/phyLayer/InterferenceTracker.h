@@ -0,0 +1,124 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/base/toolbox/Signal.h"
+
+namespace veins {
+
+/**
+ * @brief Keeps a running total of the power of all signals on the channel.
+ *
+ * The total is updated whenever a signal starts or ends, so the interference
+ * a receiver sees can be looked up instead of being summed up over all
+ * AirFrames returned by ChannelInfo for every decision. A copy of the total
+ * is recorded at every change; as copies share their values until the total
+ * changes again, this costs one set of values per event. Totals older than
+ * the start of the earliest signal still on the channel are dropped.
+ *
+ * Like ChannelInfo, InterferenceTracker is passive and assumes signals are
+ * added and removed chronologically. All analogue models must have been
+ * applied to a signal before it is added, and it must not change until it
+ * has been removed again.
+ *
+ * @ingroup phyLayer
+ */
+class VEINS_API InterferenceTracker {
+public:
+    /** @brief Adds a signal starting at the given (current) time */
+    void addSignal(const Signal* signal, simtime_t_cref now);
+
+    /** @brief Removes a signal ending at the given (current) time */
+    void removeSignal(const Signal* signal, simtime_t_cref now);
+
+    /** @brief Returns true if there is no signal on the channel */
+    bool isChannelEmpty() const
+    {
+        return activeSignals.empty();
+    }
+
+    /** @brief Returns true if the signal has been added and not removed yet */
+    bool isActive(const Signal* signal) const;
+
+    /** @brief Returns the spectrum of the signals on the channel, which must not be empty */
+    const Spectrum& getSpectrum() const;
+
+    /**
+     * @brief Returns the current total power of all signals but exclude at the
+     * given frequency index.
+     *
+     * exclude may be nullptr or a signal not on the channel.
+     */
+    double getPowerAt(size_t freqIndex, const Signal* exclude = nullptr) const;
+
+    /**
+     * @brief Returns the maximum power of all signals but the given one
+     * during [start, end), for every frequency.
+     *
+     * The signal must still be on the channel and the interval must lie
+     * within its reception.
+     */
+    Signal getMaxInterference(const Signal* signal, simtime_t_cref start, simtime_t_cref end) const;
+
+    /**
+     * @brief Returns the minimum SINR of the data part of the signal during
+     * [start, end), using the maximum interference on every frequency.
+     */
+    double getMinSINR(const Signal* signal, simtime_t_cref start, simtime_t_cref end, double noise) const;
+
+    /** @brief Returns the number of totals currently recorded */
+    size_t getHistorySize() const
+    {
+        return history.size();
+    }
+
+private:
+    /** @brief The total power from the given time on */
+    struct Snapshot {
+        simtime_t time;
+        Signal total;
+    };
+
+    /** @brief Records the current total, replacing one recorded at the same time */
+    void record(simtime_t_cref now);
+
+    /** @brief Drops the totals no signal on the channel can be interfered by anymore */
+    void prune();
+
+    struct ActiveSignal {
+        const Signal* signal;
+        simtime_t start;
+    };
+
+    std::vector<ActiveSignal> activeSignals;
+    Signal total;
+    std::deque<Snapshot> history; ///< ordered by time, the last one is the current total
+};
+
+} // namespace veins
@@ -25,6 +25,7 @@
 #include <sstream>
 
 #include "veins/base/phyLayer/AnalogueModel.h"
+#include "veins/base/toolbox/SignalKernels.h"
 
 namespace veins {
 
@@ -67,7 +68,7 @@ const Spectrum& Signal::getSpectrum() const
 
 double& Signal::at(size_t index)
 {
-    return values.at(index);
+    return values.mutableAt(index);
 }
 
 const double& Signal::at(size_t index) const
@@ -78,7 +79,7 @@ const double& Signal::at(size_t index) const
 double& Signal::atFrequency(double frequency)
 {
     size_t index = spectrum.indexOf(frequency);
-    return values.at(index);
+    return values.mutableAt(index);
 }
 
 const double& Signal::atFrequency(double frequency) const
@@ -88,6 +89,11 @@ const double& Signal::atFrequency(double frequency) const
 }
 
 double* Signal::getValues()
+{
+    return values.mutableData();
+}
+
+const double* Signal::getValues() const
 {
     return values.data();
 }
@@ -104,7 +110,7 @@ double Signal::getMax() const
 
 double& Signal::dataAt(size_t index)
 {
-    return values.at(dataOffset + index);
+    return values.mutableAt(dataOffset + index);
 }
 
 const double& Signal::dataAt(size_t index) const
@@ -123,6 +129,11 @@ size_t Signal::getDataEnd() const
 }
 
 double* Signal::getDataValues()
+{
+    return values.mutableData() + dataOffset;
+}
+
+const double* Signal::getDataValues() const
 {
     return values.data() + dataOffset;
 }
@@ -169,7 +180,7 @@ size_t Signal::getCenterFrequencyIndex() const
 
 double Signal::getAtCenterFrequency() const
 {
-    return values[centerFrequencyIndex];
+    return values.data()[centerFrequencyIndex];
 }
 
 void Signal::setCenterFrequencyIndex(size_t index)
@@ -179,7 +190,7 @@ void Signal::setCenterFrequencyIndex(size_t index)
 
 bool Signal::greaterAtCenterFrequency(double threshold)
 {
-    if (values[centerFrequencyIndex] < threshold) return false;
+    if (values.data()[centerFrequencyIndex] < threshold) return false;
 
     uint16_t maxAnalogueModels = analogueModelList->size();
 
@@ -188,14 +199,14 @@ bool Signal::greaterAtCenterFrequency(double threshold)
         (*analogueModelList)[numAnalogueModelsApplied]->filterSignal(this);
         numAnalogueModelsApplied++;
 
-        if (values[centerFrequencyIndex] < threshold) return false;
+        if (values.data()[centerFrequencyIndex] < threshold) return false;
     }
     return true;
 }
 
 bool Signal::smallerAtCenterFrequency(double threshold)
 {
-    if (values[centerFrequencyIndex] < threshold) return true;
+    if (values.data()[centerFrequencyIndex] < threshold) return true;
 
     uint16_t maxAnalogueModels = analogueModelList->size();
 
@@ -204,7 +215,7 @@ bool Signal::smallerAtCenterFrequency(double threshold)
         (*analogueModelList)[numAnalogueModelsApplied]->filterSignal(this);
         numAnalogueModelsApplied++;
 
-        if (values[centerFrequencyIndex] < threshold) return true;
+        if (values.data()[centerFrequencyIndex] < threshold) return true;
     }
     return false;
 }
@@ -313,7 +324,7 @@ void Signal::setTiming(simtime_t start, simtime_t dur)
 
 Signal& Signal::operator=(const double value)
 {
-    std::fill(values.begin(), values.end(), value);
+    std::fill_n(values.replaceData(), values.size(), value);
     return *this;
 }
 
@@ -349,13 +360,17 @@ Signal& Signal::operator+=(const Signal& other)
     ASSERT(this->getSpectrum() == other.getSpectrum());
     ASSERT(!(this->timingUsed && other.timingUsed) || (this->sendingStart == other.sendingStart && this->duration == other.duration));
 
-    std::transform(values.begin(), values.end(), other.values.begin(), values.begin(), std::plus<double>());
+    // read both operands before replaceData(), other may be this signal
+    const double* source = values.data();
+    const double* otherSource = other.values.data();
+    SignalKernels::apply(SignalKernels::Operation::add, source, otherSource, values.replaceData(), values.size());
     return *this;
 }
 
 Signal& Signal::operator+=(const double value)
 {
-    std::transform(values.begin(), values.end(), values.begin(), [value](double other) { return other + value; });
+    const double* source = values.data();
+    SignalKernels::apply(SignalKernels::Operation::add, source, value, values.replaceData(), values.size());
     return *this;
 }
 
@@ -364,13 +379,17 @@ Signal& Signal::operator-=(const Signal& other)
     ASSERT(this->getSpectrum() == other.getSpectrum());
     ASSERT(!(this->timingUsed && other.timingUsed) || (this->sendingStart == other.sendingStart && this->duration == other.duration));
 
-    std::transform(values.begin(), values.end(), other.values.begin(), values.begin(), std::minus<double>());
+    // read both operands before replaceData(), other may be this signal
+    const double* source = values.data();
+    const double* otherSource = other.values.data();
+    SignalKernels::apply(SignalKernels::Operation::subtract, source, otherSource, values.replaceData(), values.size());
     return *this;
 }
 
 Signal& Signal::operator-=(const double value)
 {
-    std::transform(values.begin(), values.end(), values.begin(), [value](double other) { return other - value; });
+    const double* source = values.data();
+    SignalKernels::apply(SignalKernels::Operation::subtract, source, value, values.replaceData(), values.size());
     return *this;
 }
 
@@ -379,13 +398,17 @@ Signal& Signal::operator*=(const Signal& other)
     ASSERT(this->getSpectrum() == other.getSpectrum());
     ASSERT(!(this->timingUsed && other.timingUsed) || (this->sendingStart == other.sendingStart && this->duration == other.duration));
 
-    std::transform(values.begin(), values.end(), other.values.begin(), values.begin(), std::multiplies<double>());
+    // read both operands before replaceData(), other may be this signal
+    const double* source = values.data();
+    const double* otherSource = other.values.data();
+    SignalKernels::apply(SignalKernels::Operation::multiply, source, otherSource, values.replaceData(), values.size());
     return *this;
 }
 
 Signal& Signal::operator*=(const double value)
 {
-    std::transform(values.begin(), values.end(), values.begin(), [value](double other) { return other * value; });
+    const double* source = values.data();
+    SignalKernels::apply(SignalKernels::Operation::multiply, source, value, values.replaceData(), values.size());
     return *this;
 }
 
@@ -394,13 +417,17 @@ Signal& Signal::operator/=(const Signal& other)
     ASSERT(this->getSpectrum() == other.getSpectrum());
     ASSERT(!(this->timingUsed && other.timingUsed) || (this->sendingStart == other.sendingStart && this->duration == other.duration));
 
-    std::transform(values.begin(), values.end(), other.values.begin(), values.begin(), std::divides<double>());
+    // read both operands before replaceData(), other may be this signal
+    const double* source = values.data();
+    const double* otherSource = other.values.data();
+    SignalKernels::apply(SignalKernels::Operation::divide, source, otherSource, values.replaceData(), values.size());
     return *this;
 }
 
 Signal& Signal::operator/=(const double value)
 {
-    std::transform(values.begin(), values.end(), values.begin(), [value](double other) { return other / value; });
+    const double* source = values.data();
+    SignalKernels::apply(SignalKernels::Operation::divide, source, value, values.replaceData(), values.size());
     return *this;
 }
 
@@ -521,12 +548,12 @@ simtime_t calculateDuration(const Signal& lhs, const Signal& rhs)
 
 double Signal::getMinInRange(size_t freqIndexLow, size_t freqIndexHigh) const
 {
-    return *(std::min_element(values.begin() + freqIndexLow, values.begin() + freqIndexHigh));
+    return SignalKernels::min(values.data() + freqIndexLow, freqIndexHigh - freqIndexLow);
 }
 
 double Signal::getMaxInRange(size_t freqIndexLow, size_t freqIndexHigh) const
 {
-    return *(std::max_element(values.begin() + freqIndexLow, values.begin() + freqIndexHigh));
+    return SignalKernels::max(values.data() + freqIndexLow, freqIndexHigh - freqIndexLow);
 }
 
 } // namespace veins
@@ -27,6 +27,7 @@
 #include "veins/base/utils/POA.h"
 #include "veins/base/utils/Coord.h"
 #include "veins/base/toolbox/Spectrum.h"
+#include "veins/base/toolbox/SignalValues.h"
 #include "veins/base/phyLayer/AnalogueModel.h"
 
 namespace veins {
@@ -110,6 +111,13 @@ public:
      */
     double* getValues();
 
+    /**
+     * Access the underlying power values directly, without copying values shared with other signals.
+     *
+     * @see getNumValues()
+     */
+    const double* getValues() const;
+
     /**
      * Returns the number of power values stored in this signal.
      *
@@ -162,6 +170,13 @@ public:
      */
     double* getDataValues();
 
+    /**
+     * Access the underlying data range power levels directly, without copying values shared with other signals.
+     *
+     * @see getNumDataValues()
+     */
+    const double* getDataValues() const;
+
     /**
      * The number of values in the data frequency subrange.
      */
@@ -495,7 +510,7 @@ private:
 
     Spectrum spectrum;
 
-    std::vector<double> values;
+    SignalValues values;
 
     size_t numDataValues = 0;
     size_t dataOffset = 0;
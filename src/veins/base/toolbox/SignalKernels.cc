@@ -0,0 +1,395 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/base/toolbox/SignalKernels.h"
+
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define VEINS_SIGNAL_KERNELS_SSE2
+#include <emmintrin.h>
+#endif
+
+// AVX kernels are compiled for the AVX target only, so the rest of Veins does not need to be built for it
+#if defined(VEINS_SIGNAL_KERNELS_SSE2) && defined(__GNUC__)
+#define VEINS_SIGNAL_KERNELS_AVX
+#include <immintrin.h>
+#define VEINS_TARGET_AVX __attribute__((target("avx")))
+#endif
+
+namespace veins {
+namespace SignalKernels {
+
+namespace {
+
+const double infinity = std::numeric_limits<double>::infinity();
+
+template <Operation op>
+inline double applyScalar(double lhs, double rhs)
+{
+    switch (op) {
+    case Operation::add:
+        return lhs + rhs;
+    case Operation::subtract:
+        return lhs - rhs;
+    case Operation::multiply:
+        return lhs * rhs;
+    case Operation::divide:
+        return lhs / rhs;
+    }
+    return 0;
+}
+
+// like the min/max instructions of SSE2 and AVX: the current extremum unless value is strictly smaller/larger
+inline double minOf(double value, double smallest)
+{
+    return value < smallest ? value : smallest;
+}
+
+inline double maxOf(double value, double largest)
+{
+    return value > largest ? value : largest;
+}
+
+struct KernelTable {
+    void (*binary[4])(const double* lhs, const double* rhs, double* result, size_t size);
+    void (*binaryScalar[4])(const double* lhs, double rhs, double* result, size_t size);
+    double (*min)(const double* values, size_t size);
+    double (*max)(const double* values, size_t size);
+    double (*minQuotient)(const double* numerators, const double* denominators, double denominatorOffset, size_t size);
+};
+
+namespace scalar {
+
+template <Operation op>
+void binary(const double* lhs, const double* rhs, double* result, size_t size)
+{
+    for (size_t i = 0; i < size; i++) result[i] = applyScalar<op>(lhs[i], rhs[i]);
+}
+
+template <Operation op>
+void binaryScalar(const double* lhs, double rhs, double* result, size_t size)
+{
+    for (size_t i = 0; i < size; i++) result[i] = applyScalar<op>(lhs[i], rhs);
+}
+
+double min(const double* values, size_t size)
+{
+    double smallest = infinity;
+    for (size_t i = 0; i < size; i++) smallest = minOf(values[i], smallest);
+    return smallest;
+}
+
+double max(const double* values, size_t size)
+{
+    double largest = -infinity;
+    for (size_t i = 0; i < size; i++) largest = maxOf(values[i], largest);
+    return largest;
+}
+
+double minQuotient(const double* numerators, const double* denominators, double denominatorOffset, size_t size)
+{
+    double smallest = infinity;
+    for (size_t i = 0; i < size; i++) smallest = minOf(numerators[i] / (denominators[i] + denominatorOffset), smallest);
+    return smallest;
+}
+
+const KernelTable table = {
+    {binary<Operation::add>, binary<Operation::subtract>, binary<Operation::multiply>, binary<Operation::divide>},
+    {binaryScalar<Operation::add>, binaryScalar<Operation::subtract>, binaryScalar<Operation::multiply>, binaryScalar<Operation::divide>},
+    min,
+    max,
+    minQuotient,
+};
+
+} // namespace scalar
+
+#ifdef VEINS_SIGNAL_KERNELS_SSE2
+namespace sse2 {
+
+const size_t width = 2;
+
+template <Operation op>
+inline __m128d applyVector(__m128d lhs, __m128d rhs)
+{
+    switch (op) {
+    case Operation::add:
+        return _mm_add_pd(lhs, rhs);
+    case Operation::subtract:
+        return _mm_sub_pd(lhs, rhs);
+    case Operation::multiply:
+        return _mm_mul_pd(lhs, rhs);
+    case Operation::divide:
+        return _mm_div_pd(lhs, rhs);
+    }
+    return lhs;
+}
+
+template <Operation op>
+void binary(const double* lhs, const double* rhs, double* result, size_t size)
+{
+    size_t i = 0;
+    for (; i + width <= size; i += width) _mm_storeu_pd(result + i, applyVector<op>(_mm_loadu_pd(lhs + i), _mm_loadu_pd(rhs + i)));
+    for (; i < size; i++) result[i] = applyScalar<op>(lhs[i], rhs[i]);
+}
+
+template <Operation op>
+void binaryScalar(const double* lhs, double rhs, double* result, size_t size)
+{
+    __m128d rhsVector = _mm_set1_pd(rhs);
+    size_t i = 0;
+    for (; i + width <= size; i += width) _mm_storeu_pd(result + i, applyVector<op>(_mm_loadu_pd(lhs + i), rhsVector));
+    for (; i < size; i++) result[i] = applyScalar<op>(lhs[i], rhs);
+}
+
+double min(const double* values, size_t size)
+{
+    __m128d smallest = _mm_set1_pd(infinity);
+    size_t i = 0;
+    for (; i + width <= size; i += width) smallest = _mm_min_pd(_mm_loadu_pd(values + i), smallest);
+    double lanes[width];
+    _mm_storeu_pd(lanes, smallest);
+    double result = minOf(lanes[1], lanes[0]);
+    for (; i < size; i++) result = minOf(values[i], result);
+    return result;
+}
+
+double max(const double* values, size_t size)
+{
+    __m128d largest = _mm_set1_pd(-infinity);
+    size_t i = 0;
+    for (; i + width <= size; i += width) largest = _mm_max_pd(_mm_loadu_pd(values + i), largest);
+    double lanes[width];
+    _mm_storeu_pd(lanes, largest);
+    double result = maxOf(lanes[1], lanes[0]);
+    for (; i < size; i++) result = maxOf(values[i], result);
+    return result;
+}
+
+double minQuotient(const double* numerators, const double* denominators, double denominatorOffset, size_t size)
+{
+    __m128d offset = _mm_set1_pd(denominatorOffset);
+    __m128d smallest = _mm_set1_pd(infinity);
+    size_t i = 0;
+    for (; i + width <= size; i += width) {
+        __m128d quotient = _mm_div_pd(_mm_loadu_pd(numerators + i), _mm_add_pd(_mm_loadu_pd(denominators + i), offset));
+        smallest = _mm_min_pd(quotient, smallest);
+    }
+    double lanes[width];
+    _mm_storeu_pd(lanes, smallest);
+    double result = minOf(lanes[1], lanes[0]);
+    for (; i < size; i++) result = minOf(numerators[i] / (denominators[i] + denominatorOffset), result);
+    return result;
+}
+
+const KernelTable table = {
+    {binary<Operation::add>, binary<Operation::subtract>, binary<Operation::multiply>, binary<Operation::divide>},
+    {binaryScalar<Operation::add>, binaryScalar<Operation::subtract>, binaryScalar<Operation::multiply>, binaryScalar<Operation::divide>},
+    min,
+    max,
+    minQuotient,
+};
+
+} // namespace sse2
+#endif
+
+#ifdef VEINS_SIGNAL_KERNELS_AVX
+namespace avx {
+
+const size_t width = 4;
+
+template <Operation op>
+VEINS_TARGET_AVX inline __m256d applyVector(__m256d lhs, __m256d rhs)
+{
+    switch (op) {
+    case Operation::add:
+        return _mm256_add_pd(lhs, rhs);
+    case Operation::subtract:
+        return _mm256_sub_pd(lhs, rhs);
+    case Operation::multiply:
+        return _mm256_mul_pd(lhs, rhs);
+    case Operation::divide:
+        return _mm256_div_pd(lhs, rhs);
+    }
+    return lhs;
+}
+
+/** Reduces the lanes of a vector of minimums (or maximums) to one value, continuing with the remaining values */
+template <typename Reduce>
+VEINS_TARGET_AVX double reduceLanes(__m256d vector, Reduce reduce)
+{
+    double lanes[width];
+    _mm256_storeu_pd(lanes, vector);
+    double result = lanes[0];
+    for (size_t lane = 1; lane < width; lane++) result = reduce(lanes[lane], result);
+    return result;
+}
+
+template <Operation op>
+VEINS_TARGET_AVX void binary(const double* lhs, const double* rhs, double* result, size_t size)
+{
+    size_t i = 0;
+    for (; i + width <= size; i += width) _mm256_storeu_pd(result + i, applyVector<op>(_mm256_loadu_pd(lhs + i), _mm256_loadu_pd(rhs + i)));
+    for (; i < size; i++) result[i] = applyScalar<op>(lhs[i], rhs[i]);
+}
+
+template <Operation op>
+VEINS_TARGET_AVX void binaryScalar(const double* lhs, double rhs, double* result, size_t size)
+{
+    __m256d rhsVector = _mm256_set1_pd(rhs);
+    size_t i = 0;
+    for (; i + width <= size; i += width) _mm256_storeu_pd(result + i, applyVector<op>(_mm256_loadu_pd(lhs + i), rhsVector));
+    for (; i < size; i++) result[i] = applyScalar<op>(lhs[i], rhs);
+}
+
+VEINS_TARGET_AVX double min(const double* values, size_t size)
+{
+    __m256d smallest = _mm256_set1_pd(infinity);
+    size_t i = 0;
+    for (; i + width <= size; i += width) smallest = _mm256_min_pd(_mm256_loadu_pd(values + i), smallest);
+    double result = reduceLanes(smallest, minOf);
+    for (; i < size; i++) result = minOf(values[i], result);
+    return result;
+}
+
+VEINS_TARGET_AVX double max(const double* values, size_t size)
+{
+    __m256d largest = _mm256_set1_pd(-infinity);
+    size_t i = 0;
+    for (; i + width <= size; i += width) largest = _mm256_max_pd(_mm256_loadu_pd(values + i), largest);
+    double result = reduceLanes(largest, maxOf);
+    for (; i < size; i++) result = maxOf(values[i], result);
+    return result;
+}
+
+VEINS_TARGET_AVX double minQuotient(const double* numerators, const double* denominators, double denominatorOffset, size_t size)
+{
+    __m256d offset = _mm256_set1_pd(denominatorOffset);
+    __m256d smallest = _mm256_set1_pd(infinity);
+    size_t i = 0;
+    for (; i + width <= size; i += width) {
+        __m256d quotient = _mm256_div_pd(_mm256_loadu_pd(numerators + i), _mm256_add_pd(_mm256_loadu_pd(denominators + i), offset));
+        smallest = _mm256_min_pd(quotient, smallest);
+    }
+    double result = reduceLanes(smallest, minOf);
+    for (; i < size; i++) result = minOf(numerators[i] / (denominators[i] + denominatorOffset), result);
+    return result;
+}
+
+const KernelTable table = {
+    {binary<Operation::add>, binary<Operation::subtract>, binary<Operation::multiply>, binary<Operation::divide>},
+    {binaryScalar<Operation::add>, binaryScalar<Operation::subtract>, binaryScalar<Operation::multiply>, binaryScalar<Operation::divide>},
+    min,
+    max,
+    minQuotient,
+};
+
+} // namespace avx
+#endif
+
+const KernelTable* tableOf(InstructionSet instructionSet)
+{
+    switch (instructionSet) {
+    case InstructionSet::scalar:
+        return &scalar::table;
+    case InstructionSet::sse2:
+#ifdef VEINS_SIGNAL_KERNELS_SSE2
+        return &sse2::table;
+#else
+        return nullptr;
+#endif
+    case InstructionSet::avx:
+#ifdef VEINS_SIGNAL_KERNELS_AVX
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx") ? &avx::table : nullptr;
+#else
+        return nullptr;
+#endif
+    }
+    return nullptr;
+}
+
+InstructionSet bestInstructionSet()
+{
+    if (isSupported(InstructionSet::avx)) return InstructionSet::avx;
+    if (isSupported(InstructionSet::sse2)) return InstructionSet::sse2;
+    return InstructionSet::scalar;
+}
+
+struct Dispatch {
+    InstructionSet instructionSet;
+    const KernelTable* kernels;
+};
+
+// chosen on first use, so kernels can be used during static initialization
+Dispatch& dispatch()
+{
+    static Dispatch current = {bestInstructionSet(), tableOf(bestInstructionSet())};
+    return current;
+}
+
+} // namespace
+
+bool isSupported(InstructionSet instructionSet)
+{
+    return tableOf(instructionSet) != nullptr;
+}
+
+InstructionSet getInstructionSet()
+{
+    return dispatch().instructionSet;
+}
+
+void setInstructionSet(InstructionSet instructionSet)
+{
+    if (!isSupported(instructionSet)) throw cRuntimeError("SignalKernels: instruction set %d is not compiled in or not supported by this CPU", static_cast<int>(instructionSet));
+    dispatch() = {instructionSet, tableOf(instructionSet)};
+}
+
+void apply(Operation op, const double* lhs, const double* rhs, double* result, size_t size)
+{
+    dispatch().kernels->binary[static_cast<size_t>(op)](lhs, rhs, result, size);
+}
+
+void apply(Operation op, const double* lhs, double rhs, double* result, size_t size)
+{
+    dispatch().kernels->binaryScalar[static_cast<size_t>(op)](lhs, rhs, result, size);
+}
+
+double min(const double* values, size_t size)
+{
+    return dispatch().kernels->min(values, size);
+}
+
+double max(const double* values, size_t size)
+{
+    return dispatch().kernels->max(values, size);
+}
+
+double minQuotient(const double* numerators, const double* denominators, double denominatorOffset, size_t size)
+{
+    return dispatch().kernels->minQuotient(numerators, denominators, denominatorOffset, size);
+}
+
+} // namespace SignalKernels
+} // namespace veins
@@ -0,0 +1,86 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "veins/veins.h"
+
+namespace veins {
+namespace SignalKernels {
+
+/**
+ * @brief Element-wise operations of the kernels.
+ */
+enum class Operation {
+    add,
+    subtract,
+    multiply,
+    divide
+};
+
+/**
+ * @brief Implementations of the kernels.
+ *
+ * By default, the best instruction set supported by the CPU is used.
+ * All instruction sets give bit-identical results: the element-wise
+ * operations are exactly rounded on all of them, and min/max only select
+ * values (for inputs without NaNs).
+ */
+enum class InstructionSet {
+    scalar,
+    sse2,
+    avx
+};
+
+/** @brief Returns if the kernels for the given instruction set are compiled in and supported by the CPU */
+bool VEINS_API isSupported(InstructionSet instructionSet);
+
+/** @brief Returns the instruction set currently used by the kernels */
+InstructionSet VEINS_API getInstructionSet();
+
+/** @brief Selects the instruction set used by the kernels, e.g., to compare them in tests; throws a cRuntimeError if it is not supported */
+void VEINS_API setInstructionSet(InstructionSet instructionSet);
+
+/** @brief result[i] = lhs[i] op rhs[i] for all i < size, result may be lhs or rhs */
+void VEINS_API apply(Operation op, const double* lhs, const double* rhs, double* result, size_t size);
+
+/** @brief result[i] = lhs[i] op rhs for all i < size, result may be lhs */
+void VEINS_API apply(Operation op, const double* lhs, double rhs, double* result, size_t size);
+
+/** @brief Returns the smallest of the given values, infinity if there are none */
+double VEINS_API min(const double* values, size_t size);
+
+/** @brief Returns the largest of the given values, -infinity if there are none */
+double VEINS_API max(const double* values, size_t size);
+
+/**
+ * @brief Returns the smallest numerators[i] / (denominators[i] + denominatorOffset), infinity if size is 0.
+ *
+ * Computes e.g. the minimum SINR of a signal (numerators) given the interference (denominators) and noise (denominatorOffset).
+ */
+double VEINS_API minQuotient(const double* numerators, const double* denominators, double denominatorOffset, size_t size);
+
+} // namespace SignalKernels
+} // namespace veins
@@ -23,6 +23,7 @@
 #include "veins/base/toolbox/SignalUtils.h"
 
 #include "veins/base/messages/AirFrame_m.h"
+#include "veins/base/toolbox/SignalKernels.h"
 
 #include <queue>
 
@@ -149,13 +150,13 @@ double VEINS_API getMinSINR(simtime_t start, simtime_t end, AirFrame* signalFram
     Spectrum spectrum = signal.getSpectrum();
 
     Signal interference = getMaxInterference(start, end, signalFrame, interfererFrames);
-    Signal sinr = signal / (interference + noise);
+    ASSERT(interference.getSpectrum() == spectrum);
+    ASSERT(signal.getDataEnd() <= signal.getNumValues());
 
-    double min_sinr = INFINITY;
-    for (uint16_t i = signal.getDataStart(); i < signal.getDataEnd(); i++) {
-        min_sinr = std::min(min_sinr, sinr.at(i));
-    }
-    return min_sinr;
+    // signal / (interference + noise) over the data channels, without creating the intermediate signals
+    const Signal& constSignal = signal;
+    const Signal& constInterference = interference;
+    return SignalKernels::minQuotient(constSignal.getDataValues(), constInterference.getValues() + signal.getDataStart(), noise, signal.getNumDataValues());
 }
 
 } // namespace SignalUtils
@@ -0,0 +1,194 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/base/toolbox/SignalValues.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace veins {
+
+namespace {
+
+/**
+ * Recycled storage of each size up to SignalValues::maxPooledSize values.
+ *
+ * Blocks are cut from slabs, each starting on a cache line. Free blocks are kept in one list per size,
+ * linked through their first bytes. Slabs are never freed, their number is bounded by the largest number
+ * of signals alive at once.
+ */
+class BlockPool {
+public:
+    static const size_t cacheLine = 64;
+    static const size_t blocksPerSlab = 32;
+
+    BlockPool()
+        : freeBlocks(SignalValues::maxPooledSize + 1, nullptr)
+    {
+    }
+
+    void* take(size_t size, size_t bytes)
+    {
+        if (!freeBlocks[size]) addSlab(size, bytes);
+        FreeBlock* block = freeBlocks[size];
+        freeBlocks[size] = block->next;
+        return block;
+    }
+
+    void give(size_t size, void* memory)
+    {
+        FreeBlock* block = static_cast<FreeBlock*>(memory);
+        block->next = freeBlocks[size];
+        freeBlocks[size] = block;
+    }
+
+    /** Returns the pool of the calling thread, which is never destroyed so values may be released during static destruction */
+    static BlockPool& ofThisThread()
+    {
+        static thread_local BlockPool* pool = new BlockPool();
+        return *pool;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    void addSlab(size_t size, size_t bytes)
+    {
+        // every block starts on a cache line
+        size_t stride = (bytes + cacheLine - 1) / cacheLine * cacheLine;
+        char* slab = static_cast<char*>(::operator new(stride * blocksPerSlab + cacheLine));
+        slabs.push_back(slab);
+        char* first = slab + (cacheLine - reinterpret_cast<uintptr_t>(slab) % cacheLine) % cacheLine;
+        for (size_t i = blocksPerSlab; i > 0; i--) give(size, first + (i - 1) * stride);
+    }
+
+    std::vector<FreeBlock*> freeBlocks;
+    std::vector<void*> slabs; ///< kept reachable for leak checkers
+};
+
+} // namespace
+
+SignalValues::SignalValues(size_t size, double value)
+    : block(size > 0 ? allocate(size) : nullptr)
+{
+    if (block) std::fill(valuesOf(block), valuesOf(block) + size, value);
+}
+
+SignalValues::SignalValues(const SignalValues& other)
+    : block(other.block)
+{
+    if (block) block->refs++;
+}
+
+SignalValues::SignalValues(SignalValues&& other) noexcept
+    : block(other.block)
+{
+    other.block = nullptr;
+}
+
+SignalValues& SignalValues::operator=(const SignalValues& other)
+{
+    if (block == other.block) return *this;
+    release();
+    block = other.block;
+    if (block) block->refs++;
+    return *this;
+}
+
+SignalValues& SignalValues::operator=(SignalValues&& other) noexcept
+{
+    std::swap(block, other.block);
+    return *this;
+}
+
+SignalValues::~SignalValues()
+{
+    release();
+}
+
+const double& SignalValues::at(size_t index) const
+{
+    if (index >= size()) throw std::out_of_range("SignalValues::at: index out of range");
+    return valuesOf(block)[index];
+}
+
+double& SignalValues::mutableAt(size_t index)
+{
+    if (index >= size()) throw std::out_of_range("SignalValues::mutableAt: index out of range");
+    return mutableData()[index];
+}
+
+double* SignalValues::mutableData()
+{
+    if (isShared()) {
+        Block* copy = allocate(block->size);
+        std::copy(valuesOf(block), valuesOf(block) + block->size, valuesOf(copy));
+        release();
+        block = copy;
+    }
+    return block ? valuesOf(block) : nullptr;
+}
+
+double* SignalValues::replaceData()
+{
+    if (isShared()) {
+        // the other copies keep the old values alive
+        Block* fresh = allocate(block->size);
+        release();
+        block = fresh;
+    }
+    return block ? valuesOf(block) : nullptr;
+}
+
+SignalValues::Block* SignalValues::allocate(size_t size)
+{
+    size_t bytes = sizeof(Block) + size * sizeof(double);
+    void* memory = size <= maxPooledSize ? BlockPool::ofThisThread().take(size, bytes) : ::operator new(bytes);
+    return new (memory) Block{1, size};
+}
+
+void SignalValues::deallocate(Block* block)
+{
+    if (block->size <= maxPooledSize) {
+        BlockPool::ofThisThread().give(block->size, block);
+    }
+    else {
+        ::operator delete(block);
+    }
+}
+
+void SignalValues::release()
+{
+    if (block && --block->refs == 0) {
+        deallocate(block);
+    }
+    block = nullptr;
+}
+
+} // namespace veins
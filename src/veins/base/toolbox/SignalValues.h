@@ -0,0 +1,132 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <cstddef>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * Reference counted, copy-on-write storage of the power levels of a Signal.
+ *
+ * Copies share the same values until one of them is changed, so the copies of an AirFrame sent to
+ * every receiver of a transmission do not copy the transmit power levels until each receiver
+ * attenuates its own copy. The values and the reference count are kept in a single allocation.
+ *
+ * Reading never copies. Changing the values through mutableData() or mutableAt() first copies them
+ * if they are shared, replaceData() only provides fresh storage if they are shared.
+ *
+ * Storage for up to maxPooledSize values (which covers the spectra of all PHYs of Veins, e.g., the 802.11p
+ * channels) is cut from cache line aligned slabs and recycled per number of values, so creating and
+ * copying signals of a spectrum does not allocate once a simulation has warmed up.
+ *
+ * @note The reference count is not synchronized, copies must only be used by one thread.
+ */
+class VEINS_API SignalValues {
+public:
+    /** Storage of up to this many values is recycled instead of being freed. */
+    static const size_t maxPooledSize = 64;
+
+    SignalValues() = default;
+
+    /** Creates storage for size values, all set to value. */
+    SignalValues(size_t size, double value);
+
+    /** Shares the values of other. */
+    SignalValues(const SignalValues& other);
+    SignalValues(SignalValues&& other) noexcept;
+    SignalValues& operator=(const SignalValues& other);
+    SignalValues& operator=(SignalValues&& other) noexcept;
+    ~SignalValues();
+
+    size_t size() const
+    {
+        return block ? block->size : 0;
+    }
+
+    const double* data() const
+    {
+        return block ? valuesOf(block) : nullptr;
+    }
+
+    const double* begin() const
+    {
+        return data();
+    }
+
+    const double* end() const
+    {
+        return data() + size();
+    }
+
+    /** Returns the value at index, throws std::out_of_range for invalid indices. */
+    const double& at(size_t index) const;
+
+    /** Returns the value at index to be changed, throws std::out_of_range for invalid indices. */
+    double& mutableAt(size_t index);
+
+    /** Returns the values to be changed, copying them first if they are shared. */
+    double* mutableData();
+
+    /**
+     * Returns storage for values that are about to be overwritten entirely.
+     *
+     * If the values are shared, the storage is fresh and its contents are undefined. Pointers obtained
+     * from data() before stay valid in this case as the old values are still held by the other copies,
+     * so new values can be computed from the old ones, e.g. with std::transform.
+     */
+    double* replaceData();
+
+    /** Returns if the values are shared with another copy. */
+    bool isShared() const
+    {
+        return block && block->refs > 1;
+    }
+
+private:
+    /** Header of the single allocation, followed by the values. */
+    struct Block {
+        size_t refs;
+        size_t size;
+    };
+
+    /** Returns a block with one reference, taken from the pool of the calling thread if size is at most maxPooledSize. */
+    static Block* allocate(size_t size);
+
+    /** Returns a block without references to the pool of the calling thread (or frees it if it is too large). */
+    static void deallocate(Block* block);
+
+    static double* valuesOf(Block* block)
+    {
+        return reinterpret_cast<double*>(block + 1);
+    }
+
+    void release();
+
+    Block* block = nullptr;
+};
+
+} // namespace veins
@@ -35,46 +35,53 @@ Spectrum::Frequencies normalizeFrequencies(Spectrum::Frequencies freqs)
 }
 
 Spectrum::Spectrum(Spectrum::Frequencies freqs)
-    : frequencies(normalizeFrequencies(freqs))
+    : frequencies(std::make_shared<const Frequencies>(normalizeFrequencies(freqs)))
 {
 }
 
+const Spectrum::Frequencies& Spectrum::getFrequencies() const
+{
+    static const Frequencies noFrequencies;
+    return frequencies ? *frequencies : noFrequencies;
+}
+
 const double& Spectrum::operator[](size_t index) const
 {
-    return frequencies.at(index);
+    return getFrequencies().at(index);
 }
 
 size_t Spectrum::indexOf(double freq) const
 {
     // Binary search
-    auto it = std::lower_bound(frequencies.begin(), frequencies.end(), freq);
-    bool found = it != frequencies.end() && (*it) == freq;
+    const Frequencies& freqs = getFrequencies();
+    auto it = std::lower_bound(freqs.begin(), freqs.end(), freq);
+    bool found = it != freqs.end() && (*it) == freq;
 
     ASSERT(found == true);
 
-    return std::distance(frequencies.begin(), it);
+    return std::distance(freqs.begin(), it);
 }
 
 double Spectrum::freqAt(size_t freqIndex) const
 {
-    return frequencies.at(freqIndex);
+    return getFrequencies().at(freqIndex);
 }
 
 size_t Spectrum::getNumFreqs() const
 {
-    return frequencies.size();
+    return getFrequencies().size();
 }
 
 bool operator==(const Spectrum& lhs, const Spectrum& rhs)
 {
-    return lhs.frequencies == rhs.frequencies;
+    return lhs.frequencies == rhs.frequencies || lhs.getFrequencies() == rhs.getFrequencies();
 }
 
 std::ostream& operator<<(std::ostream& os, const Spectrum& s)
 {
     os << "Spectrum(";
     std::ostringstream ss;
-    for (auto&& frequency : s.frequencies) {
+    for (auto&& frequency : s.getFrequencies()) {
         if (ss.tellp() != 0) {
             ss << ", ";
         }
@@ -56,7 +56,10 @@ public:
     friend std::ostream& VEINS_API operator<<(std::ostream& os, const Spectrum& s);
 
 private:
-    Frequencies frequencies;
+    const Frequencies& getFrequencies() const;
+
+    /** Immutable and shared between all copies, so copying a Spectrum (e.g., along with every Signal) does not copy the frequencies */
+    std::shared_ptr<const Frequencies> frequencies;
 };
 
 } // namespace veins
@@ -0,0 +1,121 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/base/utils/WorkerPool.h"
+
+using namespace veins;
+
+WorkerPool::WorkerPool()
+    : task(nullptr)
+    , generation(0)
+    , numBusy(0)
+    , stopping(false)
+{
+}
+
+WorkerPool::~WorkerPool()
+{
+    stop();
+}
+
+void WorkerPool::start(size_t numThreads)
+{
+    ASSERT(numThreads >= 1);
+    stop();
+
+    stopping = false;
+    for (size_t i = 1; i < numThreads; i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this, i, generation);
+    }
+}
+
+void WorkerPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto& worker : workers) worker.join();
+    workers.clear();
+}
+
+void WorkerPool::run(const Task& task)
+{
+    if (workers.empty()) {
+        task(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        numBusy = workers.size();
+        error = nullptr;
+        generation++;
+    }
+    taskAvailable.notify_all();
+
+    std::exception_ptr ownError;
+    try {
+        task(0);
+    }
+    catch (...) {
+        ownError = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    taskFinished.wait(lock, [this]() { return numBusy == 0; });
+    this->task = nullptr;
+
+    if (ownError) std::rethrow_exception(ownError);
+    if (error) std::rethrow_exception(error);
+}
+
+void WorkerPool::workerLoop(size_t threadIndex, unsigned long lastGeneration)
+{
+    while (true) {
+        const Task* current;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [&]() { return stopping || generation != lastGeneration; });
+            if (stopping) return;
+            lastGeneration = generation;
+            current = task;
+        }
+
+        std::exception_ptr taskError;
+        try {
+            (*current)(threadIndex);
+        }
+        catch (...) {
+            taskError = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (taskError && !error) error = taskError;
+            numBusy--;
+        }
+        taskFinished.notify_one();
+    }
+}
@@ -0,0 +1,90 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * A fixed set of worker threads running one task at a time on all threads.
+ *
+ * The calling thread takes part as thread 0, so a pool of one thread starts
+ * no worker at all. Threads are started once and kept waiting between tasks,
+ * so a task can be run every simulation step without the cost of creating
+ * threads.
+ */
+class VEINS_API WorkerPool {
+public:
+    using Task = std::function<void(size_t threadIndex)>;
+
+    WorkerPool();
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * Stops the current workers and starts new ones.
+     *
+     * @param numThreads number of threads including the calling thread, at least 1
+     */
+    void start(size_t numThreads);
+
+    /** @brief Stops and joins all workers */
+    void stop();
+
+    size_t getNumThreads() const
+    {
+        return workers.size() + 1;
+    }
+
+    /**
+     * Runs the task on all threads and returns once it has finished on all of them.
+     *
+     * If the task throws on any thread, the first exception is rethrown.
+     */
+    void run(const Task& task);
+
+private:
+    void workerLoop(size_t threadIndex, unsigned long lastGeneration);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable taskFinished;
+    const Task* task;
+    unsigned long generation; ///< incremented for every task
+    size_t numBusy; ///< workers still running the current task
+    bool stopping;
+    std::exception_ptr error;
+};
+
+} // namespace veins
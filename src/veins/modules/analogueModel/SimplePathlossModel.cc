@@ -30,6 +30,19 @@ using namespace veins;
 
 using veins::AirFrame;
 
+double SimplePathlossModel::getMaxPowerFactor(const Coord& senderPos, const Coord& receiverPos, double frequency)
+{
+    double sqrDistance = useTorus ? receiverPos.sqrTorusDist(senderPos, playgroundSize) : receiverPos.sqrdist(senderPos);
+    if (sqrDistance <= 1.0) {
+        return 1.0;
+    }
+
+    // same order of operations as filterSignal, so the bound does not round below the actual factor
+    double distFactor = pow(sqrDistance, -pathLossAlphaHalf) / (16.0 * M_PI * M_PI);
+    double wavelength = BaseWorldUtility::speedOfLight() / frequency;
+    return (wavelength * wavelength) * distFactor;
+}
+
 void SimplePathlossModel::filterSignal(Signal* signal)
 {
     auto senderPos = signal->getSenderPoa().pos.getPositionAt();
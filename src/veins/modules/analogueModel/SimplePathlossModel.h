@@ -95,6 +95,11 @@ public:
     {
         return true;
     }
+
+    /**
+     * @brief Returns the attenuation filterSignal applies at the given frequency, it only depends on the distance.
+     */
+    double getMaxPowerFactor(const Coord& senderPos, const Coord& receiverPos, double frequency) override;
 };
 
 } // namespace veins
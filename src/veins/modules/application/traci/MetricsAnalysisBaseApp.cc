@@ -17,12 +17,13 @@ std::map<cModule*, LAddress::L2Type> veins::MetricsAnalysisBaseApp::cModuleToL2;
 std::map<LAddress::L2Type, const char*> veins::MetricsAnalysisBaseApp::L2ToFullname;
 int veins::MetricsAnalysisBaseApp::numVehicles;
 double veins::MetricsAnalysisBaseApp::laneMaxSpeed;
-std::vector<veins::MetricsAnalysisBaseApp::NbConnectivityDetails> veins::MetricsAnalysisBaseApp::globalNbConnectivityDetails;
-std::vector<simtime_t> veins::MetricsAnalysisBaseApp::globalNewNbMeetingDiffTime;
-std::map<int, std::vector<int>> veins::MetricsAnalysisBaseApp::allNodesNumNbsOverTimeMap;
+veins::StreamingHistogram veins::MetricsAnalysisBaseApp::globalContactDurationHistogram;
+veins::StreamingHistogram veins::MetricsAnalysisBaseApp::globalMeetingTimeHistogram;
+veins::QuantileSketch veins::MetricsAnalysisBaseApp::globalContactDurationSketch;
+veins::QuantileSketch veins::MetricsAnalysisBaseApp::globalMeetingTimeSketch;
+veins::QuantileSketch veins::MetricsAnalysisBaseApp::globalNbDegreeSketch;
+veins::PerSecondAggregate veins::MetricsAnalysisBaseApp::globalNumNbsPerSecond;
 int veins::MetricsAnalysisBaseApp::numCurrentVehicles;
-simtime_t veins::MetricsAnalysisBaseApp::maxContactDuration;
-simtime_t veins::MetricsAnalysisBaseApp::maxMeetingTimeofNextVehicle;
 int veins::MetricsAnalysisBaseApp::totalMaxVehicles;
 std::string veins::MetricsAnalysisBaseApp::perSecondNumVehiclesAndNumNbsFileDir;
 std::string veins::MetricsAnalysisBaseApp::indvContactDurationFileDir;
@@ -30,6 +31,8 @@ std::string veins::MetricsAnalysisBaseApp::indvMeetingTimeFileDir;
 std::string veins::MetricsAnalysisBaseApp::indvPerSecondNbContactDurationLogFile;
 std::string veins::MetricsAnalysisBaseApp::aggrContactDurationFileDir;
 std::string veins::MetricsAnalysisBaseApp::aggrMeetingTimeFileDir;
+std::string veins::MetricsAnalysisBaseApp::aggrPerSecondNumNbsFileDir;
+std::string veins::MetricsAnalysisBaseApp::quantileFileDir;
 
 void MetricsAnalysisBaseApp::initialize(int stage)
 {
@@ -82,6 +85,7 @@ void MetricsAnalysisBaseApp::initialize(int stage)
 
         sendBeaconEvt = new cMessage("beacon evt", SEND_BEACON_EVT);
         sendWSAEvt = new cMessage("wsa evt", SEND_WSA_EVT);
+        nbExpiryTimer = new cMessage("Nb device timeout", NB_TIMEOUT_TIMER);
 
         generatedBSMs = 0;
         generatedWSAs = 0;
@@ -96,6 +100,18 @@ void MetricsAnalysisBaseApp::initialize(int stage)
         logIndividualPerSecondNeighborContactDuration = par("logIndividualPerSecondNeighborContactDuration").boolValue();
         logAggregatedContactuDuration = par("logAggregatedContactuDuration").boolValue();
         logAggregatedMeetingTime = par("logAggregatedMeetingTime").boolValue();
+        logAggregatedPerSecondNumNeighbors = par("logAggregatedPerSecondNumNeighbors").boolValue();
+
+        std::string contactDetection = par("contactDetection").stringValue();
+        if (contactDetection != "beacon" && contactDetection != "geometric") {
+            throw cRuntimeError("Unknown contactDetection \"%s\", expecting \"beacon\" or \"geometric\"", contactDetection.c_str());
+        }
+        geometricContactDetection = (contactDetection == "geometric");
+
+        aggrHistogramBinWidth = par("aggrHistogramBinWidth");
+        aggrHistogramMaxValue = par("aggrHistogramMaxValue");
+
+        quantileReportInterval = par("quantileReportInterval");
 
     }
     else if (stage == 1) {
@@ -163,6 +179,7 @@ MetricsAnalysisBaseApp::~MetricsAnalysisBaseApp()
        }
 
    cancelAndDelete(sendWSAEvt);
+   cancelAndDelete(nbExpiryTimer);
 
    findHost()->unsubscribe(BaseMobility::mobilityStateChangedSignal, this);
 }
@@ -261,8 +278,7 @@ void MetricsAnalysisBaseApp::handleSelfMsg(cMessage* msg)
             break;
         }
         case NB_TIMEOUT_TIMER: {
-            auto nbConnectivityTimeoutMsg = dynamic_cast<NbConnectivityTimeoutMsg *>(msg);
-            nbConnectivityTimeout(nbConnectivityTimeoutMsg);
+            handleNbExpiryTimer();
             break;
         }
 
@@ -327,6 +343,19 @@ void MetricsAnalysisBaseApp::populateWSM(BaseFrame1609_4* wsm, LAddress::L2Type
     }
 }
 
+/**
+ * @brief: Bins are centered on multiples of the bin width (bin k holds the samples that round to k*binWidth),
+ * and are allocated once for the whole range, so the memory does not grow with the simulation time.
+ * Samples larger than the range are still counted in the overflow bucket.
+ */
+void MetricsAnalysisBaseApp::configureAggregatedHistograms() {
+    double binWidth = aggrHistogramBinWidth.dbl();
+    size_t numBins = ceil(aggrHistogramMaxValue.dbl() / binWidth) + 1;
+
+    globalContactDurationHistogram.configure(binWidth, numBins, -binWidth / 2);
+    globalMeetingTimeHistogram.configure(binWidth, numBins, -binWidth / 2);
+}
+
 const std::string MetricsAnalysisBaseApp::currentDateTime() {
     time_t     now = time(0);
     struct tm  tstruct;
@@ -397,27 +426,40 @@ double MetricsAnalysisBaseApp::getTxPower() {
 }
 
 
-/** This function is called when an offloading vehicle or offloaded RSU/Vehicle are out of coverage.
- * This function is also used when granted data is completely offloaded */
-//
-//void MetricsAnalysisBaseApp::nbConnectivityTimeout(NbConnectivityTimeoutMsg *nbConnectivityTimeoutMsg) {
-//    LAddress::L2Type nbId = nbConnectivityTimeoutMsg->getNbId();
-//
-//    // Cancel the message and delete the entry from the map
-//    auto nbTimeoutTimerIter = nbDeviceTimeoutTimerMap.find(nbId);
-//    if (nbTimeoutTimerIter != nbDeviceTimeoutTimerMap.end()) {
-////        cancelEvent(nbTimeoutTimerIter->second);
-//        cancelAndDelete(nbTimeoutTimerIter->second);
-//        nbDeviceTimeoutTimerMap.erase(nbTimeoutTimerIter);
-//    }
-//}
-
-void MetricsAnalysisBaseApp::scheduleNbTimoutTimer(LAddress::L2Type offloadingVehicleAddr, LAddress::L2Type nbAddress, int nbDeviceType) {
-    NbConnectivityTimeoutMsg *nbConnectivityTimer = new NbConnectivityTimeoutMsg("Nb device timeout", NB_TIMEOUT_TIMER);
-    nbConnectivityTimer->setOffloadingVehicleId(offloadingVehicleAddr);
-    nbConnectivityTimer->setNbId(nbAddress);
-    nbConnectivityTimer->setNbDeviceType(nbDeviceType);
-
-    nbDeviceTimeoutTimerMap[nbAddress] = nbConnectivityTimer;
-    scheduleAt(simTime() + 3*beaconInterval, nbConnectivityTimer);
+/**
+ * @brief: Neighbor timeouts share a single self message instead of one message per neighbor and beacon.
+ * As the timeout is the same for all neighbors, deadlines are appended to nbExpiryQueue in increasing order,
+ * so the earliest deadline is always at its front. Deadlines replaced by a later beacon are skipped lazily.
+ */
+void MetricsAnalysisBaseApp::scheduleNbTimoutTimer(NbConnectivityDetails& nbDetails) {
+    nbDetails.deadline = simTime() + 3*beaconInterval;
+    nbExpiryQueue.push_back(std::make_pair(nbDetails.nbId, nbDetails.deadline));
+
+    if (!nbExpiryTimer->isScheduled()) {
+        scheduleAt(nbExpiryQueue.front().second, nbExpiryTimer);
+    }
+}
+
+void MetricsAnalysisBaseApp::handleNbExpiryTimer() {
+    // Neighbors with the same deadline time out in the order their last beacons were received
+    while (!nbExpiryQueue.empty()) {
+        std::pair<LAddress::L2Type, simtime_t> entry = nbExpiryQueue.front();
+        NbConnectivityDetails* nbDetails = currentConnectedNbs.find(entry.first);
+        bool isOutdated = (nbDetails == nullptr || nbDetails->deadline != entry.second);
+
+        if (!isOutdated && entry.second > simTime()) {
+            break;
+        }
+
+        nbExpiryQueue.pop_front();
+
+        if (!isOutdated) {
+            nbDetails->deadline = SIMTIME_ZERO;
+            nbConnectivityTimeout(entry.first);
+        }
+    }
+
+    if (!nbExpiryQueue.empty()) {
+        scheduleAt(nbExpiryQueue.front().second, nbExpiryTimer);
+    }
 }
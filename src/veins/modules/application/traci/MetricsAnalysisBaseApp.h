@@ -17,10 +17,16 @@
 #include "veins/modules/mobility/traci/TraCIMobility.h"
 #include "veins/modules/mobility/traci/TraCICommandInterface.h"
 
+#include <deque>
 #include <map>
 #include <math.h>       /* sqrt */
 #include "veins/modules/application/traci/MetricsAnalysisMessages_m.h"
 #include "veins/modules/mac/ieee80211p/Mac1609_4.h"
+#include "veins/modules/utility/StreamingHistogram.h"
+#include "veins/modules/utility/NeighborCountTimeline.h"
+#include "veins/modules/utility/QuantileSketch.h"
+#include "veins/modules/utility/BufferedLogSink.h"
+#include "veins/modules/utility/NeighborTable.h"
 
 
 
@@ -71,7 +77,6 @@ public:
             NONE = 0
         };
 
-protected:
     struct NbConnectivityDetails
     {
         LAddress::L2Type myId;
@@ -79,8 +84,14 @@ protected:
         simtime_t startTime;
         simtime_t endTime;
         simtime_t duration;  // seconds
+        simtime_t deadline;  // last beacon + 3*beaconInterval, zero if the neighbor does not time out (geometric contacts)
     };
 
+    /* current neighbors and their contact details, updated in place on every beacon */
+    NeighborTable<NbConnectivityDetails> currentConnectedNbs;
+
+protected:
+
 //    double bitsToMegabits = 0.000001;
 
     TraCIMobility* mobility;
@@ -138,7 +149,11 @@ protected:
     std::string prefixLogFilename;
     std::string scenarioName;
 
-    std::map<LAddress::L2Type, NbConnectivityTimeoutMsg*> nbDeviceTimeoutTimerMap;
+    /* neighbor expiry: a queue of (neighbor, deadline) in order of deadline that may still hold outdated deadlines
+     * of neighbors which sent another beacon since (or are gone), and a single timer armed for the earliest deadline
+     * of the queue. The current deadline of every neighbor is kept in currentConnectedNbs */
+    std::deque<std::pair<LAddress::L2Type, simtime_t>> nbExpiryQueue;
+    cMessage* nbExpiryTimer = nullptr;
 
     double currentSpeed;
     cModule* host;
@@ -153,6 +168,8 @@ protected:
     static std::string indvPerSecondNbContactDurationLogFile;
     static std::string aggrContactDurationFileDir;
     static std::string aggrMeetingTimeFileDir;
+    static std::string aggrPerSecondNumNbsFileDir;
+    static std::string quantileFileDir;
 
     bool logPerSecondNumVehiclesAndNumNeighbors;
     bool logIndividualContactDuration;
@@ -160,13 +177,26 @@ protected:
     bool logIndividualPerSecondNeighborContactDuration;
     bool logAggregatedContactuDuration;
     bool logAggregatedMeetingTime;
+    bool logAggregatedPerSecondNumNeighbors;
+
+    /* neighbors are detected from positions instead of beacons (contactDetection = "geometric") */
+    bool geometricContactDetection;
 
-    static std::vector<NbConnectivityDetails> globalNbConnectivityDetails;
-    static std::vector<simtime_t> globalNewNbMeetingDiffTime;
+    simtime_t aggrHistogramBinWidth;
+    simtime_t aggrHistogramMaxValue;
+
+    /* distributions of all vehicles, updated whenever a contact ends or a new neighbor is met */
+    static StreamingHistogram globalContactDurationHistogram;
+    static StreamingHistogram globalMeetingTimeHistogram;
+
+    /* quantile sketches of all vehicles, only updated if quantileReportInterval > 0 */
+    simtime_t quantileReportInterval;
+    static QuantileSketch globalContactDurationSketch;
+    static QuantileSketch globalMeetingTimeSketch;
+    static QuantileSketch globalNbDegreeSketch;
     static int numCurrentVehicles;
-    static std::map<int, std::vector<int>> allNodesNumNbsOverTimeMap;
-    static simtime_t maxContactDuration;
-    static simtime_t maxMeetingTimeofNextVehicle;
+    /* number of neighbors of all vehicles per second, each vehicle adds its timeline when it leaves the network */
+    static PerSecondAggregate globalNumNbsPerSecond;
 
     /** @brief handle messages from below and calls the onWSM, onBSM, and onWSA functions accordingly */
     void handleLowerMsg(cMessage* msg) override;
@@ -233,15 +263,21 @@ protected:
     virtual void checkAndTrackPacket(cMessage* msg);
 
     /** @brief this function is called when a vehicle does not receive beacon from its neighbor within a pre-defined timer */
-    virtual void nbConnectivityTimeout(NbConnectivityTimeoutMsg *nbConnectivityTimeoutMsg) {};
+    virtual void nbConnectivityTimeout(LAddress::L2Type nbId) {};
 
-    /** @brief after receiving a beacon from a neighboring vehicle, schedule a neighbor timeout timer to identify
-     * if the vehicle is still neighbor */
-    virtual void scheduleNbTimoutTimer(LAddress::L2Type offloadingVehicleAddr, LAddress::L2Type destAddress, int nbDeviceType);
+    /** @brief after receiving a beacon from a neighboring vehicle, (re)schedule the neighbor timeout to identify
+     * if the vehicle is still neighbor. Removing the neighbor from currentConnectedNbs cancels its timeout */
+    virtual void scheduleNbTimoutTimer(NbConnectivityDetails& nbDetails);
+
+    /** @brief call nbConnectivityTimeout for all neighbors whose deadline has passed and re-arm the timer */
+    void handleNbExpiryTimer();
 
     /** @brief obtain the transmission power of node (vehicle/RSU) */
     virtual double getTxPower();
 
+    /** @brief reset the global distributions to empty histograms with the configured bin width and range */
+    void configureAggregatedHistograms();
+
     /** @brief obtain current date time for recording into log (csv) files */
     const std::string currentDateTime();
 };
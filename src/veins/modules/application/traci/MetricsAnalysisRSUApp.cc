@@ -5,6 +5,8 @@
 
 #include <veins/modules/application/traci/MetricsAnalysisRSUApp.h>
 
+#include <algorithm>
+
 using namespace veins;
 
 Define_Module(veins::MetricsAnalysisRSUApp);
@@ -29,47 +31,63 @@ void MetricsAnalysisRSUApp::initialize(int stage)
             perSecondNumVehiclesAndNumNbsFileDir = baseDirLogFiles + prefixLogFilename + "perSecondNumVehiclesAndNumAvgNbs" + postfix;
             indvContactDurationFileDir = baseDirLogFiles + prefixLogFilename + "indvContactDurationLog" + postfix;
             indvMeetingTimeFileDir = baseDirLogFiles + prefixLogFilename + "indvNewNbMeetingTimeLog" + postfix;
-            indvPerSecondNbContactDurationLogFile = baseDirLogFiles + prefixLogFilename + "indvPerSecondNbContactDurationLog" + postfix;
+            // The per-second neighbor contact duration log is either a csv or a (much smaller) binary file, see BinaryContactLog
+            std::string nbContactDurationLogFormat = par("perSecondNbContactDurationLogFormat").stringValue();
+            if (nbContactDurationLogFormat != "csv" && nbContactDurationLogFormat != "binary") {
+                throw cRuntimeError("Unknown perSecondNbContactDurationLogFormat \"%s\", expecting \"csv\" or \"binary\"", nbContactDurationLogFormat.c_str());
+            }
+            binaryPerSecondNbContactDurationLog = (nbContactDurationLogFormat == "binary");
+            std::string nbContactDurationPostfix = binaryPerSecondNbContactDurationLog ? "-" + std::to_string(getTxPower()) + "mW-" + scenarioName + ".bin" : postfix;
+            indvPerSecondNbContactDurationLogFile = baseDirLogFiles + prefixLogFilename + "indvPerSecondNbContactDurationLog" + nbContactDurationPostfix;
             aggrContactDurationFileDir = baseDirLogFiles + prefixLogFilename + "aggrContactDurationLog" + postfix;
             aggrMeetingTimeFileDir = baseDirLogFiles + prefixLogFilename + "aggrMeetingTimeLog" + postfix;
+            aggrPerSecondNumNbsFileDir = baseDirLogFiles + prefixLogFilename + "aggrPerSecondNumNbsLog" + postfix;
+            quantileFileDir = baseDirLogFiles + prefixLogFilename + "quantileLog" + postfix;
+
+            // Start every run with empty distributions of contact duration and meeting time
+            configureAggregatedHistograms();
+            globalNumNbsPerSecond.clear();
+
+            // configure() also discards the samples of a previous run
+            int quantileSketchAccuracy = par("quantileSketchAccuracy").intValue();
+            globalContactDurationSketch.configure(quantileSketchAccuracy);
+            globalMeetingTimeSketch.configure(quantileSketchAccuracy);
+            globalNbDegreeSketch.configure(quantileSketchAccuracy);
+            nextQuantileReportTime = simTime() + quantileReportInterval;
+
+            // Log files are kept open and written in large chunks by a background thread
+            BufferedLogSink::getInstance().setBufferSize(par("logBufferSize").intValue());
+            BufferedLogSink::getInstance().setMaxPendingBytes(par("logMaxPendingSize").intValue());
 
             if (logPerSecondNumVehiclesAndNumNeighbors) {
                 std::ifstream fileExits(perSecondNumVehiclesAndNumNbsFileDir.c_str());
                 if (!fileExits.good()) {
-                    std::ofstream perSecondLog;
-                    perSecondLog.open(perSecondNumVehiclesAndNumNbsFileDir, std::ios::app);
+                    BufferedLogFile& perSecondLog = BufferedLogSink::getInstance().getFile(perSecondNumVehiclesAndNumNbsFileDir);
                     perSecondLog << "seed,scenario,totalVehicles,maxSpeed,txPower,simTime,numVehicles,numAvgNbs,datetime" << endl;
-                    perSecondLog.close();
                 }
             }
 
             if (logIndividualContactDuration) {
                 std::ifstream fileExits(indvContactDurationFileDir.c_str());
                 if (!fileExits.good()) {
-                    std::ofstream contactDurationLog;
-                    contactDurationLog.open(indvContactDurationFileDir, std::ios::app);
+                    BufferedLogFile& contactDurationLog = BufferedLogSink::getInstance().getFile(indvContactDurationFileDir);
                     contactDurationLog << "seed,scenario,maxSpeed,txPower,myId,nbId,startTime,endTime,contactDuration,datetime" << endl;
-                    contactDurationLog.close();
                 }
             }
 
             if (logIndividualMeetingTime) {
                 std::ifstream fileExits(indvMeetingTimeFileDir.c_str());
                 if (!fileExits.good()) {
-                    std::ofstream newNbMeetingTimeLog;
-                    newNbMeetingTimeLog.open(indvMeetingTimeFileDir, std::ios::app);
+                    BufferedLogFile& newNbMeetingTimeLog = BufferedLogSink::getInstance().getFile(indvMeetingTimeFileDir);
                     newNbMeetingTimeLog << "seed,scenario,maxSpeed,txPower,myId,newNbMeetTimeDiff,datetime" << endl;
-                    newNbMeetingTimeLog.close();
                 }
             }
 
-            if (logIndividualPerSecondNeighborContactDuration) {
+            if (logIndividualPerSecondNeighborContactDuration && !binaryPerSecondNbContactDurationLog) {
                 std::ifstream fileExits(indvPerSecondNbContactDurationLogFile.c_str());
                 if (!fileExits.good()) {
-                    std::ofstream nbContactDurationLog;
-                    nbContactDurationLog.open(indvPerSecondNbContactDurationLogFile, std::ios::app);
+                    BufferedLogFile& nbContactDurationLog = BufferedLogSink::getInstance().getFile(indvPerSecondNbContactDurationLogFile);
                     nbContactDurationLog << "seed,scenario,maxSpeed,txPower,simTime,myId,nbId,contactDuration,datetime" << endl;
-                    nbContactDurationLog.close();
                 }
 
             }
@@ -77,20 +95,32 @@ void MetricsAnalysisRSUApp::initialize(int stage)
             if (logAggregatedContactuDuration) {
                 std::ifstream fileExits(aggrContactDurationFileDir.c_str());
                 if (!fileExits.good()) {
-                    std::ofstream aggrContactDurationLog;
-                    aggrContactDurationLog.open(aggrContactDurationFileDir, std::ios::app);
+                    BufferedLogFile& aggrContactDurationLog = BufferedLogSink::getInstance().getFile(aggrContactDurationFileDir);
                     aggrContactDurationLog << "seed,scenario,totalVehicles,maxSpeed,txPower,simTime,contactTime,datetime" << endl;
-                    aggrContactDurationLog.close();
                 }
             }
 
             if (logAggregatedMeetingTime) {
                 std::ifstream fileExits(aggrMeetingTimeFileDir.c_str());
                 if (!fileExits.good()) {
-                    std::ofstream aggrNewNbMeetingTimeLog;
-                    aggrNewNbMeetingTimeLog.open(aggrMeetingTimeFileDir, std::ios::app);
+                    BufferedLogFile& aggrNewNbMeetingTimeLog = BufferedLogSink::getInstance().getFile(aggrMeetingTimeFileDir);
                     aggrNewNbMeetingTimeLog << "seed,scenario,totalVehicles,maxSpeed,txPower,simTime,meetingTime,datetime" << endl;
-                    aggrNewNbMeetingTimeLog.close();
+                }
+            }
+
+            if (logAggregatedPerSecondNumNeighbors) {
+                std::ifstream fileExits(aggrPerSecondNumNbsFileDir.c_str());
+                if (!fileExits.good()) {
+                    BufferedLogFile& aggrPerSecondNumNbsLog = BufferedLogSink::getInstance().getFile(aggrPerSecondNumNbsFileDir);
+                    aggrPerSecondNumNbsLog << "seed,scenario,totalVehicles,maxSpeed,txPower,simTime,numVehicles,sumNbs,minNbs,maxNbs,avgNbs,datetime" << endl;
+                }
+            }
+
+            if (quantileReportInterval > 0) {
+                std::ifstream fileExits(quantileFileDir.c_str());
+                if (!fileExits.good()) {
+                    BufferedLogFile& quantileLog = BufferedLogSink::getInstance().getFile(quantileFileDir);
+                    quantileLog << "seed,scenario,totalVehicles,maxSpeed,txPower,simTime,metric,count,p50,p90,p99,max,datetime" << endl;
                 }
             }
 
@@ -116,90 +146,137 @@ void MetricsAnalysisRSUApp::finish()
 {
     if (L2TocModule.find(myId) != L2TocModule.end() && strcmp("rsu[0]", L2TocModule[myId]->getFullName()) == 0) {
 
-        if (logAggregatedContactuDuration) {
-            std::ofstream contactDistrLog;
-            contactDistrLog.open(aggrContactDurationFileDir, std::ios::app);
-
-            int maxContactDurationInt = round(maxContactDuration.dbl());
-            std::vector<int> distr_numVehicle_duration(maxContactDurationInt + 1);
-            double numValidRecordsContactDistr = 0;
-
-            for (int i=0; i<globalNbConnectivityDetails.size(); i++) {
-                NbConnectivityDetails nbConnDetails = globalNbConnectivityDetails[i];
-                int duration = round((nbConnDetails.duration).dbl());
-    //            if (duration > maxContactDurationInt) {
-    //                break;
-    //            }
-    //            else {
-    //            if (duration > 0) {
-                    distr_numVehicle_duration[duration]++;
-                    numValidRecordsContactDistr++;
-    //            }
-            }
+        if (nbContactDurationBinaryLog) {
+            // Write the rows of the last (incomplete) block
+            nbContactDurationBinaryLog->flush();
+        }
 
+        if (logAggregatedContactuDuration) {
+            createAggregatedLogFile(aggrContactDurationFileDir, globalContactDurationHistogram);
+        }
 
+        if (logAggregatedMeetingTime) {
+            createAggregatedLogFile(aggrMeetingTimeFileDir, globalMeetingTimeHistogram);
+        }
 
-            for (int j=0; j<distr_numVehicle_duration.size(); j++) {
-    //            if (distr_numVehicle_duration[j] > 0) {
-        //            contactDistrLog << j << "," << distr_numVehicle_duration[j] << endl;
-                contactDistrLog << seed <<
-                        "," << scenarioName <<
-                        "," << numVehicles <<
-                        "," << laneMaxSpeed <<
-                        "," << getTxPower() <<
-                        "," << j <<
-                        "," << (distr_numVehicle_duration[j]/numValidRecordsContactDistr)*100 <<
-                        "," << currentDateTime() <<
-                        endl;
-        //            EV_INFO << j << ". " << distr_numVehicle_duration[j] << endl;
-    //            }
-            }
+        if (logAggregatedPerSecondNumNeighbors) {
+            createAggregatedPerSecondNumNbsLogFile();
+        }
 
-            contactDistrLog.close();
+        if (quantileReportInterval > 0) {
+            // Final report, covering the whole run
+            createQuantileLogFile_IndividualRecords();
         }
 
-        if (logAggregatedMeetingTime) {
-            std::ofstream meetingDistrLog;
-            meetingDistrLog.open(aggrMeetingTimeFileDir, std::ios::app);
+        // The vehicles have already been finished by the TraCIScenarioManager, so this is the last write:
+        // write out and close all log files here, where a write error still ends the run with an error
+        BufferedLogSink::getInstance().close();
+    }
 
-            int maxMeetingTimeofNextVehiclenInt = round(maxMeetingTimeofNextVehicle.dbl());
-            std::vector<int> distr_MeetingTime_numVehicles(maxMeetingTimeofNextVehiclenInt + 1);
-            double numValidRecordsMeetingDistr = 0;
+}
 
-            for (int k=0; k<globalNewNbMeetingDiffTime.size(); k++) {
-                int meetingDiffTime = round((globalNewNbMeetingDiffTime[k]).dbl());
-    //            if (meetingDiffTime > 0) {
-                    distr_MeetingTime_numVehicles[meetingDiffTime]++;
-                    numValidRecordsMeetingDistr++;
-    //            }
+/**
+ * @brief: Write the distribution (in percent of all records) of the given histogram into log file.
+ * Each row holds the center value of one bin; if any record exceeded the histogram range,
+ * a last row holds the share of these records with the upper end of the range as its value.
+ */
+void MetricsAnalysisRSUApp::createAggregatedLogFile(std::string fileDir, const StreamingHistogram& histogram) {
+    BufferedLogFile& distrLog = BufferedLogSink::getInstance().getFile(fileDir);
 
-            }
+    size_t usedBins = histogram.getUsedBins();
+    double numValidRecords = histogram.getCount();
 
-            for (int l=0; l<distr_MeetingTime_numVehicles.size(); l++) {
-    //            if (distr_MeetingTime_numVehicles[l] > 0) {
-        //            meetingDistrLog << l << "," << distr_MeetingTime_numVehicles[l] << endl;
-                    meetingDistrLog << seed <<
-                            "," << scenarioName <<
-                            "," << numVehicles <<
-                            "," << laneMaxSpeed <<
-                            "," << getTxPower() <<
-                            "," << l <<
-                            "," << (distr_MeetingTime_numVehicles[l]/numValidRecordsMeetingDistr)*100 <<
-                            "," << currentDateTime() <<
-                            endl;
-    //            }
-            }
+    for (size_t j=0; j<usedBins; j++) {
+        // seed,scenario,totalVehicles,maxSpeed,txPower,simTime,contactTime/meetingTime,datetime
+        distrLog << seed <<
+                "," << scenarioName <<
+                "," << numVehicles <<
+                "," << laneMaxSpeed <<
+                "," << getTxPower() <<
+                "," << j * histogram.getBinWidth() <<
+                "," << (histogram.getBinCount(j)/numValidRecords)*100 <<
+                "," << currentDateTime() <<
+                endl;
+    }
 
-            meetingDistrLog.close();
-        }
+    if (histogram.getOverflowCount() > 0) {
+        EV_WARN << histogram.getOverflowCount() << " records of " << fileDir << " exceed aggrHistogramMaxValue" << endl;
+
+        distrLog << seed <<
+                "," << scenarioName <<
+                "," << numVehicles <<
+                "," << laneMaxSpeed <<
+                "," << getTxPower() <<
+                "," << histogram.getNumBins() * histogram.getBinWidth() <<
+                "," << (histogram.getOverflowCount()/numValidRecords)*100 <<
+                "," << currentDateTime() <<
+                endl;
     }
+}
 
+/**
+ * @brief: Write the number of neighbors of all vehicles per second (count of vehicles, sum, min, max and mean) into log file.
+ * Seconds without any vehicle are skipped.
+ */
+void MetricsAnalysisRSUApp::createAggregatedPerSecondNumNbsLogFile() {
+    BufferedLogFile& aggrPerSecondNumNbsLog = BufferedLogSink::getInstance().getFile(aggrPerSecondNumNbsFileDir);
+
+    for (size_t second=0; second<globalNumNbsPerSecond.getNumSeconds(); second++) {
+        if (globalNumNbsPerSecond.getCount(second) == 0) continue;
+
+        // seed,scenario,totalVehicles,maxSpeed,txPower,simTime,numVehicles,sumNbs,minNbs,maxNbs,avgNbs,datetime
+        aggrPerSecondNumNbsLog << seed <<
+                "," << scenarioName <<
+                "," << numVehicles <<
+                "," << laneMaxSpeed <<
+                "," << getTxPower() <<
+                "," << second <<
+                "," << globalNumNbsPerSecond.getCount(second) <<
+                "," << globalNumNbsPerSecond.getSum(second) <<
+                "," << globalNumNbsPerSecond.getMin(second) <<
+                "," << globalNumNbsPerSecond.getMax(second) <<
+                "," << globalNumNbsPerSecond.getMean(second) <<
+                "," << currentDateTime() <<
+                endl;
+    }
+}
+
+/**
+ * @brief: Write p50, p90 and p99 of contact duration, meeting time and neighbor degree (since the start of the run) into log file.
+ */
+void MetricsAnalysisRSUApp::createQuantileLogFile_IndividualRecords() {
+    BufferedLogFile& quantileLog = BufferedLogSink::getInstance().getFile(quantileFileDir);
+
+    const std::pair<const char*, const QuantileSketch*> metrics[] = {
+        {"contactDuration", &globalContactDurationSketch},
+        {"meetingTime", &globalMeetingTimeSketch},
+        {"nbDegree", &globalNbDegreeSketch},
+    };
+
+    for (auto& metric : metrics) {
+        const QuantileSketch& sketch = *metric.second;
+
+        // seed,scenario,totalVehicles,maxSpeed,txPower,simTime,metric,count,p50,p90,p99,max,datetime
+        quantileLog << seed <<
+                "," << scenarioName <<
+                "," << totalMaxVehicles <<
+                "," << laneMaxSpeed <<
+                "," << getTxPower() <<
+                "," << round(simTime().dbl()) <<
+                "," << metric.first <<
+                "," << sketch.getCount() <<
+                "," << sketch.getQuantile(0.5) <<
+                "," << sketch.getQuantile(0.9) <<
+                "," << sketch.getQuantile(0.99) <<
+                "," << sketch.getMax() <<
+                "," << currentDateTime() <<
+                endl;
+    }
 }
 
 void MetricsAnalysisRSUApp::createPerSecondNumNbLogFile() {
 
-    std::ofstream perSecondLogFile;
-    perSecondLogFile.open(perSecondNumVehiclesAndNumNbsFileDir, std::ios::app);
+    BufferedLogFile& perSecondLogFile = BufferedLogSink::getInstance().getFile(perSecondNumVehiclesAndNumNbsFileDir);
 
     std::map<int, PerSecondLogStruct>::iterator iter;
     for (iter = perSecondLogMap.begin(); iter != perSecondLogMap.end(); iter++) {
@@ -218,14 +295,11 @@ void MetricsAnalysisRSUApp::createPerSecondNumNbLogFile() {
                 << "," << currentDateTime()
                 << endl;
     }
-
-    perSecondLogFile.close();
 }
 
 void MetricsAnalysisRSUApp::createPerSecondNumNbLogFile_IndividualRecord(PerSecondLogStruct perSecondValue) {
 
-    std::ofstream perSecondLogFile;
-    perSecondLogFile.open(perSecondNumVehiclesAndNumNbsFileDir, std::ios::app);
+    BufferedLogFile& perSecondLogFile = BufferedLogSink::getInstance().getFile(perSecondNumVehiclesAndNumNbsFileDir);
 
 
     // seed,scenariototalVehicles,maxSpeed,txPower,simTime,numVehicles,NumAvgNbs,datetime
@@ -239,13 +313,15 @@ void MetricsAnalysisRSUApp::createPerSecondNumNbLogFile_IndividualRecord(PerSeco
             << "," << perSecondValue.numAvgNbs
             << "," << currentDateTime()
             << endl;
-
-    perSecondLogFile.close();
 }
 
-void MetricsAnalysisRSUApp::createPerSecondNbContactDurationLogFile_IndividualRecords(std::vector<NbContactDurationLogStruct> nbContactDurationsVector) {
-    std::ofstream nbContactDurationLog;
-    nbContactDurationLog.open(indvPerSecondNbContactDurationLogFile, std::ios::app);
+void MetricsAnalysisRSUApp::createPerSecondNbContactDurationLogFile_IndividualRecords(const std::vector<NbContactDurationLogStruct>& nbContactDurationsVector) {
+    if (binaryPerSecondNbContactDurationLog) {
+        createPerSecondNbContactDurationBinaryLogFile_IndividualRecords(nbContactDurationsVector);
+        return;
+    }
+
+    BufferedLogFile& nbContactDurationLog = BufferedLogSink::getInstance().getFile(indvPerSecondNbContactDurationLogFile);
 
     for (int i=0; i<nbContactDurationsVector.size(); i++) {
 
@@ -263,8 +339,31 @@ void MetricsAnalysisRSUApp::createPerSecondNbContactDurationLogFile_IndividualRe
                 "," << currentDateTime() <<
                 endl;
     }
+}
+
+/**
+ * @brief: Binary variant of the per-second neighbor contact duration log.
+ * Seed, scenario, maxSpeed, txPower and datetime are written once per run, not once per row.
+ */
+void MetricsAnalysisRSUApp::createPerSecondNbContactDurationBinaryLogFile_IndividualRecords(const std::vector<NbContactDurationLogStruct>& nbContactDurationsVector) {
+    if (!nbContactDurationBinaryLog) {
+        // laneMaxSpeed is only known once the first vehicle entered the network, so the header is created on first use
+        BinaryContactLog::Header header;
+        header.seed = seed;
+        header.scaleExponent = SimTime::getScaleExp();
+        header.laneMaxSpeed = laneMaxSpeed;
+        header.txPower = getTxPower();
+        header.scenarioName = scenarioName;
+        header.dateTime = currentDateTime();
+
+        BufferedLogFile& nbContactDurationLog = BufferedLogSink::getInstance().getFile(indvPerSecondNbContactDurationLogFile);
+        nbContactDurationBinaryLog.reset(new BinaryContactLog::Writer(nbContactDurationLog, header));
+    }
 
-    nbContactDurationLog.close();
+    int64_t currentTime = round(simTime().dbl());
+    for (auto& nbContactDuration : nbContactDurationsVector) {
+        nbContactDurationBinaryLog->add({currentTime, nbContactDuration.myId, nbContactDuration.nbId, nbContactDuration.contactDuration.raw()});
+    }
 }
 
 /**
@@ -282,43 +381,44 @@ void MetricsAnalysisRSUApp::takePerSecondCountNbActionByRSU() {
     }
 
     int currentTime = round(simTime().dbl());
-    int sumNeighbors = 0;
+
+    // the number of neighbors of all vehicles is kept up to date by the vehicles themselves
+    int sumNeighbors = MetricsAnalysisVehicleApp::getTotalCurrentConnectedNbs();
 
     std::cout << "Per Second Action at simTime: " << currentTime << " and currentTime: " << currentDateTime() << endl;
 
     // a vector of NbContactDurationLogStruct for storing the information of my id, nb id, contact duration of all the vehicles at current sim time
     std::vector<NbContactDurationLogStruct> nbContactDurationLogVector;
 
-    // Run a loop on current number of vehicles to fetch the pointer of each vehicle
-    for (int i=0; i<totalMaxVehicles; i++) {
-        std::string vehicleName = "node[" + std::to_string(i) + "]";
-        cModule *vehiclePointer = getModuleByPath(vehicleName.c_str());
+    // Only visit the vehicles if their neighbors' contact durations are logged, or their number of neighbors sampled
+    if (logIndividualPerSecondNeighborContactDuration || quantileReportInterval > 0) {
+        // Run a loop on the vehicles currently in the network
+        for (MetricsAnalysisVehicleApp* vehicleModule = MetricsAnalysisVehicleApp::getFirstLiveVehicle(); vehicleModule != nullptr; vehicleModule = vehicleModule->getNextLiveVehicle()) {
 
-        // if node pointer is null, then continue to the next vehicle in the loop
-        if (vehiclePointer == nullptr) {
-           continue;
-        }
-
-//        EV_INFO << "I am " << vehiclePointer->getFullName() << endl;
+            if (quantileReportInterval > 0) {
+                globalNbDegreeSketch.collect(vehicleModule->currentConnectedNbs.size());
+            }
 
-        MetricsAnalysisVehicleApp* vehicleModule = FindModule<MetricsAnalysisVehicleApp*>::findSubModule(vehiclePointer);
+            if (!logIndividualPerSecondNeighborContactDuration) continue;
 
-        // find number of average neighbors
-        sumNeighbors += vehicleModule->currentConnectedNbsMap.size();
+            // add current vehicle id (my id), all its nbs id and contact duration into the vector nbContactDurationLogVector
+            size_t firstOfVehicle = nbContactDurationLogVector.size();
 
-        // add current vehicle id (my id), all its nbs id and contact duration into the vector nbContactDurationLogVector
-        std::map<LAddress::L2Type, NbConnectivityDetails>::iterator iter;
+            for (auto& nb : vehicleModule->currentConnectedNbs) {
+                NbContactDurationLogStruct nbContactDurationTemp;
+                const NbConnectivityDetails& nbConnectivityTemp = nb.value;
+                nbContactDurationTemp.myId = nbConnectivityTemp.myId;
+                nbContactDurationTemp.nbId = nbConnectivityTemp.nbId;
+                nbContactDurationTemp.contactDuration = nbConnectivityTemp.duration;
 
-        for (iter = vehicleModule->currentConnectedNbsMap.begin(); iter != vehicleModule->currentConnectedNbsMap.end(); iter++) {
-            NbContactDurationLogStruct nbContactDurationTemp;
-            NbConnectivityDetails nbConnectivityTemp = iter->second;
-            nbContactDurationTemp.myId = nbConnectivityTemp.myId;
-            nbContactDurationTemp.nbId = nbConnectivityTemp.nbId;
-            nbContactDurationTemp.contactDuration = nbConnectivityTemp.duration;
+                nbContactDurationLogVector.push_back(nbContactDurationTemp);
+            }
 
-            nbContactDurationLogVector.push_back(nbContactDurationTemp);
+            // the neighbors of a vehicle are logged in order of their id
+            std::sort(nbContactDurationLogVector.begin() + firstOfVehicle, nbContactDurationLogVector.end(), [](const NbContactDurationLogStruct& a, const NbContactDurationLogStruct& b) {
+                return a.nbId < b.nbId;
+            });
         }
-
     }
 
     PerSecondLogStruct perSecondLog;
@@ -342,6 +442,12 @@ void MetricsAnalysisRSUApp::takePerSecondCountNbActionByRSU() {
             createPerSecondNbContactDurationLogFile_IndividualRecords(nbContactDurationLogVector);
         }
     }
+
+    if (quantileReportInterval > 0 && simTime() >= nextQuantileReportTime) {
+        createQuantileLogFile_IndividualRecords();
+        nextQuantileReportTime += quantileReportInterval;
+    }
+
     // Schedule the timer again after one second
     scheduleAt(simTime() + 1, perSecondNbCountTimer);
 }
@@ -6,6 +6,7 @@
 //#pragma once
 
 #include <veins/modules/application/traci/MetricsAnalysisVehicleApp.h>
+#include "veins/modules/utility/BinaryContactLog.h"
 
 namespace veins {
 
@@ -34,12 +35,21 @@ protected:
     void takePerSecondCountNbActionByRSU();
     void createPerSecondNumNbLogFile();
     void createPerSecondNumNbLogFile_IndividualRecord(PerSecondLogStruct perSecondValue);
-    void createPerSecondNbContactDurationLogFile_IndividualRecords(std::vector<NbContactDurationLogStruct> nbContactDurationsVector);
+    void createPerSecondNbContactDurationLogFile_IndividualRecords(const std::vector<NbContactDurationLogStruct>& nbContactDurationsVector);
+    void createPerSecondNbContactDurationBinaryLogFile_IndividualRecords(const std::vector<NbContactDurationLogStruct>& nbContactDurationsVector);
+    void createAggregatedLogFile(std::string fileDir, const StreamingHistogram& histogram);
+    void createAggregatedPerSecondNumNbsLogFile();
+    void createQuantileLogFile_IndividualRecords();
 
 protected:
     cMessage* perSecondNbCountTimer;
 
     std::map<int, PerSecondLogStruct> perSecondLogMap;
+
+    simtime_t nextQuantileReportTime;
+
+    bool binaryPerSecondNbContactDurationLog = false;
+    std::unique_ptr<BinaryContactLog::Writer> nbContactDurationBinaryLog;
 };
 
 }
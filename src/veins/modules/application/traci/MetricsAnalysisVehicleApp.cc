@@ -5,26 +5,65 @@
 
 #include <veins/modules/application/traci/MetricsAnalysisVehicleApp.h>
 
+#include <algorithm>
+
+#include "veins/modules/utility/GeometricContacts.h"
+
 using namespace veins;
 
 Define_Module(veins::MetricsAnalysisVehicleApp);
 
+/* Global static variables */
+MetricsAnalysisVehicleApp* veins::MetricsAnalysisVehicleApp::firstLiveVehicle = nullptr;
+MetricsAnalysisVehicleApp* veins::MetricsAnalysisVehicleApp::lastLiveVehicle = nullptr;
+long veins::MetricsAnalysisVehicleApp::totalCurrentConnectedNbs = 0;
+MetricsAnalysisVehicleApp::GeometricContactListener veins::MetricsAnalysisVehicleApp::geometricContactListener;
+
+MetricsAnalysisVehicleApp::~MetricsAnalysisVehicleApp()
+{
+    // finish() was not called (e.g., the simulation ended with an error), so keep the registry consistent
+    if (isLiveVehicle) {
+        totalCurrentConnectedNbs -= currentConnectedNbs.size();
+        unregisterLiveVehicle();
+    }
+}
+
 void MetricsAnalysisVehicleApp::initialize(int stage)
 {
     MetricsAnalysisBaseApp::initialize(stage);
     if (stage == 0) {
         EV << "Initializing " << par("appName").stringValue() << std::endl;
 
-        int simTimeLimitMax = atoi(getEnvir()->getConfig()->getConfigValue("sim-time-limit"));
-
         newNbMeetTime.push_back(simTime());  // first element will be the time when vehicle entered the road
 
-        numNbsOverTime.resize(simTimeLimitMax+1);
-
+        numNbsTimeline.start(simTime().dbl());
+
+        if (geometricContactDetection) {
+            // Contacts are derived from the connections of the nic, which the connection manager keeps up to date with its grid
+            ChannelAccess* phy = FindModule<ChannelAccess*>::findSubModule(getParentModule());
+            ASSERT(phy);
+            connectionManager = ChannelAccess::getConnectionManager(phy->getParentModule());
+            nicId = phy->getParentModule()->getId();
+
+            geometricContactRange = par("geometricContactRange").doubleValue();
+            if (geometricContactRange < 0) {
+                geometricContactRange = connectionManager->getMaxInterferenceDistance();
+            }
+            else if (geometricContactRange > connectionManager->getMaxInterferenceDistance()) {
+                throw cRuntimeError("geometricContactRange (%f m) must not exceed maxInterfDist of the connection manager (%f m)", geometricContactRange, connectionManager->getMaxInterferenceDistance());
+            }
+
+            // One listener serves all vehicles; it is released together with the system module at the end of the run
+            cModule* systemModule = getSimulation()->getSystemModule();
+            if (!systemModule->isSubscribed(TraCIScenarioManager::traciTimestepEndSignal, &geometricContactListener)) {
+                systemModule->subscribe(TraCIScenarioManager::traciTimestepEndSignal, &geometricContactListener);
+            }
+        }
     }
     else if (stage == 1) {
         numCurrentVehicles++;
         totalMaxVehicles++;
+        registerLiveVehicle();
     }
 }
 
@@ -33,8 +72,12 @@ void MetricsAnalysisVehicleApp::finish()
 {
     numCurrentVehicles--;
 
+    // Add the number of neighbors over the lifetime of the vehicle to the per second distribution of all vehicles
+    numNbsTimeline.mergeInto(globalNumNbsPerSecond, simTime().dbl());
+
     // For nb vehicles which are still connected, force stop their connectivity because the current vehicle reached the end of network.
     forceStopConnectivityWithNbs();
+    unregisterLiveVehicle();
 
     if (logIndividualContactDuration) {
         // Create a log file of individual contact duration
@@ -46,43 +89,11 @@ void MetricsAnalysisVehicleApp::finish()
         createIndvNewNbMeetingTimeLogFile();
     }
 
-    for (int j=1; j<newNbMeetTime.size(); j++) {
-        simtime_t meetTime = newNbMeetTime[j] - newNbMeetTime[j-1];
-        if (meetTime > maxMeetingTimeofNextVehicle) {
-            maxMeetingTimeofNextVehicle = meetTime;
-        }
-
-        globalNewNbMeetingDiffTime.push_back(meetTime);
-    }
-
-    int maxNodeLocalSimTimeInt = round(maxNodeLocalSimTime.dbl());
-
-    for (int simTime=0; simTime<=maxNodeLocalSimTimeInt; simTime++) {
-        auto nbDeviceTimeoutIter = allNodesNumNbsOverTimeMap.find(simTime);
-
-        std::vector<int> nbsList;
-
-        if (nbDeviceTimeoutIter == allNodesNumNbsOverTimeMap.end()) {
-            // First time
-            nbsList.push_back(numNbsOverTime[simTime]);
-            allNodesNumNbsOverTimeMap[simTime] = nbsList;
-        }
-        else {
-            nbsList = nbDeviceTimeoutIter->second;
-            nbsList.push_back(numNbsOverTime[simTime]);
-            allNodesNumNbsOverTimeMap[simTime] = nbsList;
-        }
-    }
-
     allConnectivityDetails.clear();
     allConnectivityDetails.shrink_to_fit();
 
     newNbMeetTime.clear();
     newNbMeetTime.shrink_to_fit();
-
-    numNbsOverTime.clear();
-    numNbsOverTime.shrink_to_fit();
-
 }
 
 void MetricsAnalysisVehicleApp::onBSM(DemoSafetyMessage* bsm)
@@ -96,43 +107,47 @@ void MetricsAnalysisVehicleApp::onBSM(DemoSafetyMessage* bsm)
 
     EV_INFO << "I(" << myId <<") received a BSM from vehicle: " << originatorAddress << " at time: " << simTime() << endl;
 
-    auto nbDeviceTimeoutIter = nbDeviceTimeoutTimerMap.find(originatorAddress);
+    // Neighbors are detected from positions instead
+    if (geometricContactDetection) return;
+
+    NbConnectivityDetails& nbConnDetails = onNbObserved(originatorAddress);
 
-    // This is the first time (or after long time) that current vehicle is receiving a beacon from a new neighboring vehicle
-    if (nbDeviceTimeoutIter == nbDeviceTimeoutTimerMap.end()) {
+    // (Re)schedule the nb timeout, replacing the previous deadline
+    scheduleNbTimoutTimer(nbConnDetails);
+}
+
+MetricsAnalysisBaseApp::NbConnectivityDetails& MetricsAnalysisVehicleApp::onNbObserved(LAddress::L2Type originatorAddress)
+{
+    std::pair<NbConnectivityDetails*, bool> inserted = currentConnectedNbs.insert(originatorAddress);
+    NbConnectivityDetails& nbConnDetails = *inserted.first;
+
+    // This is the first time (or after long time) that current vehicle observes a new neighboring vehicle
+    if (inserted.second) {
         // For probability of meeting a new vehicle
+        globalMeetingTimeHistogram.collect((simTime() - newNbMeetTime.back()).dbl());
+        if (quantileReportInterval > 0) {
+            globalMeetingTimeSketch.collect((simTime() - newNbMeetTime.back()).dbl());
+        }
         newNbMeetTime.push_back(simTime());
 
         // For distribution of contact time of vehicles
-        NbConnectivityDetails nbConnDetails;
         nbConnDetails.myId = myId;
         nbConnDetails.nbId = originatorAddress;
         nbConnDetails.startTime = simTime();
         nbConnDetails.endTime = simTime();
         nbConnDetails.duration = 0;
 
-        currentConnectedNbsMap[originatorAddress] = nbConnDetails;
+        totalCurrentConnectedNbs++;
+        numNbsTimeline.set(simTime().dbl(), currentConnectedNbs.size());
     }
 
-    // Current vehicle has already recently received a beacon from neighboring vehicle
+    // Current vehicle has already recently observed the neighboring vehicle
     else {
-        // Fetch the NbConnectivityDetails object of current neighbor
-        auto currentConnectedNbIter = currentConnectedNbsMap.find(originatorAddress);
-        NbConnectivityDetails nbConnDetails = currentConnectedNbIter->second;
         nbConnDetails.endTime = simTime();
         nbConnDetails.duration = simTime() - nbConnDetails.startTime;
-
-        currentConnectedNbsMap[originatorAddress] = nbConnDetails;
-
-        // Cancel the nb timeout timer and delete the entry
-        NbConnectivityTimeoutMsg *nbConnectivityTimeoutMsg = nbDeviceTimeoutIter->second;
-        ASSERT(nbConnectivityTimeoutMsg->isScheduled());
-        cancelAndDelete(nbConnectivityTimeoutMsg);
-        nbDeviceTimeoutTimerMap.erase(nbDeviceTimeoutIter);
     }
 
-    // Schedule a new nb timeout timer
-    scheduleNbTimoutTimer(originatorAddress, originatorAddress, VEHICLE);
+    return nbConnDetails;
 }
 
 
@@ -143,40 +158,72 @@ void MetricsAnalysisVehicleApp::handlePositionUpdate(cObject* obj)
     // member variables such as currentPosition and currentSpeed are updated in the parent class
 }
 
-// This function is called when a neighbor is out of reach (i.e., moved outside coverage area)
-void MetricsAnalysisVehicleApp::nbConnectivityTimeout(NbConnectivityTimeoutMsg *nbConnectivityTimeoutMsg) {
-    LAddress::L2Type nbId = nbConnectivityTimeoutMsg->getNbId();
+/**
+ * @brief: Beacon-free contact detection. Vehicles whose nics are within geometricContactRange are neighbors:
+ * a contact starts at the first TraCI step in range and ends at the first TraCI step out of range,
+ * its duration lasting until the last TraCI step in range (just like the last beacon received).
+ * The positions of the nics are those the connection manager uses, so no additional spatial index is needed.
+ * Called by the GeometricContactListener at the end of each TraCI step, when all vehicles of the step have moved.
+ */
+void MetricsAnalysisVehicleApp::updateGeometricContacts() {
+    connectionManager->getNicsInRange(nicId, geometricContactRange, nicsInContactRange);
 
-    // Fetch the NbConnectivityDetails object of neighbor
-    auto nbIter = currentConnectedNbsMap.find(nbId);
-    NbConnectivityDetails nbConnDetails = nbIter->second;
+    nbsInContactRange.clear();
+    for (const NicEntry* nic : nicsInContactRange) {
+        // Only other vehicles of this application are neighbors (e.g., not RSUs)
+        cModule* nbHost = getSimulation()->getModule(nic->hostId);
+        MetricsAnalysisVehicleApp* nbApp = nbHost ? dynamic_cast<MetricsAnalysisVehicleApp*>(nbHost->getSubmodule("appl")) : nullptr;
+        if (nbApp == nullptr || !nbApp->isLiveVehicle) continue;
 
-    // Add nb connectivity details in the vector of all nbs connectivity details (for local testing)
-    allConnectivityDetails.push_back(nbConnDetails);
+        nbsInContactRange.push_back(nbApp->myId);
+    }
 
-    // Add nb connectivity details in the vector of all vehicles' nbs connectivity details (to calculate contact duration of all vehicles)
-    globalNbConnectivityDetails.push_back(nbConnDetails);
+    // Start/extend the contacts with the vehicles in range, end those with vehicles no longer in range
+    veins::updateGeometricContacts(currentConnectedNbs, nbsInContactRange, endedContacts, [this](LAddress::L2Type nbId) { onNbObserved(nbId); }, [this](LAddress::L2Type nbId) { nbConnectivityTimeout(nbId); });
+}
 
-    // update the max contact duration
-    if (nbConnDetails.duration > maxContactDuration) {
-        maxContactDuration = nbConnDetails.duration;
+void MetricsAnalysisVehicleApp::GeometricContactListener::receiveSignal(cComponent* source, simsignal_t signalID, const SimTime& t, cObject* details)
+{
+    if (signalID != TraCIScenarioManager::traciTimestepEndSignal) return;
+
+    // The first range query applies the pending moves of the whole step as one batch
+    for (MetricsAnalysisVehicleApp* vehicle = getFirstLiveVehicle(); vehicle; vehicle = vehicle->getNextLiveVehicle()) {
+        if (vehicle->geometricContactDetection) vehicle->handleTimestepEnd();
     }
+}
 
-    // delete the entry from currentConnectedNbsMap
-    currentConnectedNbsMap.erase(nbIter);
+void MetricsAnalysisVehicleApp::handleTimestepEnd()
+{
+    Enter_Method_Silent();
+    updateGeometricContacts();
+}
+
+// This function is called when a neighbor is out of reach (i.e., moved outside coverage area)
+void MetricsAnalysisVehicleApp::nbConnectivityTimeout(LAddress::L2Type nbId) {
+    // Fetch the NbConnectivityDetails object of neighbor
+    const NbConnectivityDetails* nbIter = currentConnectedNbs.find(nbId);
+    ASSERT(nbIter);
+    NbConnectivityDetails nbConnDetails = *nbIter;
 
-    // Cancel the message and delete the entry from the nb timout map
-    auto nbTimeoutTimerIter = nbDeviceTimeoutTimerMap.find(nbId);
-    if (nbTimeoutTimerIter != nbDeviceTimeoutTimerMap.end()) {
-//        cancelEvent(nbTimeoutTimerIter->second);
-        cancelAndDelete(nbTimeoutTimerIter->second);
-        nbDeviceTimeoutTimerMap.erase(nbTimeoutTimerIter);
+    // Add nb connectivity details in the vector of all nbs connectivity details (for the individual contact duration log)
+    if (logIndividualContactDuration) {
+        allConnectivityDetails.push_back(nbConnDetails);
+    }
+
+    // Add nb contact duration to the distribution of all vehicles' contact durations
+    globalContactDurationHistogram.collect(nbConnDetails.duration.dbl());
+    if (quantileReportInterval > 0) {
+        globalContactDurationSketch.collect(nbConnDetails.duration.dbl());
     }
+
+    // delete the entry from currentConnectedNbs, which also cancels the nb timeout (if the connectivity is stopped before the timeout)
+    currentConnectedNbs.erase(nbId);
+    totalCurrentConnectedNbs--;
+    numNbsTimeline.set(simTime().dbl(), currentConnectedNbs.size());
 }
 
 void MetricsAnalysisVehicleApp::createIndvContactDurationLogFile() {
-    std::ofstream contactDurationLog;
-    contactDurationLog.open(indvContactDurationFileDir, std::ios::app);
+    BufferedLogFile& contactDurationLog = BufferedLogSink::getInstance().getFile(indvContactDurationFileDir);
 
     for (int i=0; i<allConnectivityDetails.size(); i++) {
         NbConnectivityDetails nbConnDetails = allConnectivityDetails[i];
@@ -194,13 +241,10 @@ void MetricsAnalysisVehicleApp::createIndvContactDurationLogFile() {
                 "," << currentDateTime() <<
                 endl;
     }
-
-    contactDurationLog.close();
 }
 
 void MetricsAnalysisVehicleApp::createIndvNewNbMeetingTimeLogFile() {
-    std::ofstream newNbMeetingTimeLog;
-    newNbMeetingTimeLog.open(indvMeetingTimeFileDir, std::ios::app);
+    BufferedLogFile& newNbMeetingTimeLog = BufferedLogSink::getInstance().getFile(indvMeetingTimeFileDir);
 
     for (int j=1; j<newNbMeetTime.size(); j++) {
 
@@ -216,8 +260,6 @@ void MetricsAnalysisVehicleApp::createIndvNewNbMeetingTimeLogFile() {
                 "," << currentDateTime() <<
                 endl;
     }
-
-    newNbMeetingTimeLog.close();
 }
 
 /**
@@ -225,27 +267,56 @@ void MetricsAnalysisVehicleApp::createIndvNewNbMeetingTimeLogFile() {
  * This is to be done when a vehicle leaves the network (i.e., in finish() function).
  */
 void MetricsAnalysisVehicleApp::forceStopConnectivityWithNbs() {
-    std::map<LAddress::L2Type, NbConnectivityDetails> currentConnectedNbsMapCopy = currentConnectedNbsMap;
+    // in order of neighbor id, as the contacts are logged in this order
+    std::vector<LAddress::L2Type> nbIds;
+    nbIds.reserve(currentConnectedNbs.size());
+    for (auto& nb : currentConnectedNbs) {
+        nbIds.push_back(nb.key);
+    }
+    std::sort(nbIds.begin(), nbIds.end());
 
-    if (currentConnectedNbsMapCopy.size() > 0) {
-        std::map<LAddress::L2Type, NbConnectivityDetails>::iterator iter;
-        for (iter = currentConnectedNbsMapCopy.begin(); iter != currentConnectedNbsMapCopy.end(); iter++) {
-            NbConnectivityDetails nbConnDetails = iter->second;
+    for (LAddress::L2Type nbId : nbIds) {
+        NbConnectivityDetails& nbConnDetails = *currentConnectedNbs.find(nbId);
 
-            nbConnDetails.endTime = simTime();
-            nbConnDetails.duration = simTime() - nbConnDetails.startTime;
+        nbConnDetails.endTime = simTime();
+        nbConnDetails.duration = simTime() - nbConnDetails.startTime;
 
-            currentConnectedNbsMap[nbConnDetails.nbId] = nbConnDetails;
+        // Forcing to stop connectivity because it reaches end of the network
+        nbConnectivityTimeout(nbId);
+    }
+}
 
+void MetricsAnalysisVehicleApp::registerLiveVehicle() {
+    ASSERT(!isLiveVehicle);
 
-            NbConnectivityTimeoutMsg *forceStopConnectivityMsg = new NbConnectivityTimeoutMsg("Forcing to stop connectivity because it reaches end of the network");
-            forceStopConnectivityMsg->setOffloadingVehicleId(nbConnDetails.nbId);
-            forceStopConnectivityMsg->setNbId(nbConnDetails.nbId);
-            forceStopConnectivityMsg->setNbDeviceType(VEHICLE);
+    prevLiveVehicle = lastLiveVehicle;
+    nextLiveVehicle = nullptr;
+    if (lastLiveVehicle) {
+        lastLiveVehicle->nextLiveVehicle = this;
+    }
+    else {
+        firstLiveVehicle = this;
+    }
+    lastLiveVehicle = this;
+    isLiveVehicle = true;
+}
 
-            nbConnectivityTimeout(forceStopConnectivityMsg);
+void MetricsAnalysisVehicleApp::unregisterLiveVehicle() {
+    if (!isLiveVehicle) return;
 
-            cancelAndDelete(forceStopConnectivityMsg);
-        }
+    if (prevLiveVehicle) {
+        prevLiveVehicle->nextLiveVehicle = nextLiveVehicle;
+    }
+    else {
+        firstLiveVehicle = nextLiveVehicle;
+    }
+    if (nextLiveVehicle) {
+        nextLiveVehicle->prevLiveVehicle = prevLiveVehicle;
+    }
+    else {
+        lastLiveVehicle = prevLiveVehicle;
     }
+    prevLiveVehicle = nullptr;
+    nextLiveVehicle = nullptr;
+    isLiveVehicle = false;
 }
@@ -7,6 +7,7 @@
 
 #include <veins/modules/application/traci/MetricsAnalysisBaseApp.h>
 #include "veins/veins.h"
+#include "veins/base/connectionManager/BaseConnectionManager.h"
 
 using namespace omnetpp;
 
@@ -14,30 +15,74 @@ namespace veins {
 
 class VEINS_API MetricsAnalysisVehicleApp : public MetricsAnalysisBaseApp {
 public:
+    ~MetricsAnalysisVehicleApp() override;
     void initialize(int stage) override;
     void finish() override;
 
+    /** @brief first vehicle currently in the network (in order of entering it), nullptr if there is none */
+    static MetricsAnalysisVehicleApp* getFirstLiveVehicle() {return firstLiveVehicle;}
+
+    /** @brief next vehicle currently in the network after this one, nullptr if this is the last one */
+    MetricsAnalysisVehicleApp* getNextLiveVehicle() const {return nextLiveVehicle;}
+
+    /** @brief sum of the number of current neighbors of all vehicles currently in the network */
+    static long getTotalCurrentConnectedNbs() {return totalCurrentConnectedNbs;}
+
 protected:
 
     void onBSM(DemoSafetyMessage* bsm) override;
 
     void handlePositionUpdate(cObject* obj) override;
 
-    void nbConnectivityTimeout(NbConnectivityTimeoutMsg *nbConnectivityTimeoutMsg) override;
+    void nbConnectivityTimeout(LAddress::L2Type nbId) override;
+
+    /** @brief start a new contact with the given neighbor, or extend the current one up to now
+     *
+     * @return the details of the contact, in currentConnectedNbs
+     */
+    NbConnectivityDetails& onNbObserved(LAddress::L2Type nbId);
+
+    /** @brief geometric contact detection: start/extend contacts with the vehicles in range, end the others */
+    void updateGeometricContacts();
+    void handleTimestepEnd();
+
+    /** @brief updates the geometric contacts of all live vehicles once per TraCI step, after all of them have moved */
+    class GeometricContactListener : public cListener {
+    public:
+        void receiveSignal(cComponent* source, simsignal_t signalID, const SimTime& t, cObject* details) override;
+    };
+    static GeometricContactListener geometricContactListener;
 
     void createIndvContactDurationLogFile();
     void createIndvNewNbMeetingTimeLogFile();
     void forceStopConnectivityWithNbs();
 
+    /** @brief add/remove this vehicle to/from the list of vehicles currently in the network */
+    void registerLiveVehicle();
+    void unregisterLiveVehicle();
+
+    /* intrusive doubly linked list of vehicles currently in the network, replacing lookups of node[i] by name */
+    bool isLiveVehicle = false;
+    MetricsAnalysisVehicleApp* prevLiveVehicle = nullptr;
+    MetricsAnalysisVehicleApp* nextLiveVehicle = nullptr;
+    static MetricsAnalysisVehicleApp* firstLiveVehicle;
+    static MetricsAnalysisVehicleApp* lastLiveVehicle;
+    static long totalCurrentConnectedNbs;
+
+    /* geometric contact detection */
+    BaseConnectionManager* connectionManager = nullptr;
+    int nicId = -1;
+    double geometricContactRange = 0;
+    std::vector<const NicEntry*> nicsInContactRange;    // re-used buffers
+    std::vector<LAddress::L2Type> nbsInContactRange;
+    std::vector<LAddress::L2Type> endedContacts;
+
 public:
-    std::map<LAddress::L2Type, NbConnectivityDetails> currentConnectedNbsMap;     // map<activeNb, ConnectionDetails>
     std::vector<NbConnectivityDetails> allConnectivityDetails;
 
     std::vector<simtime_t> newNbMeetTime;   // first element will be the time when vehicle entered the road
     std::vector<simtime_t> nextNbsMeetingDiffTime;
-    cMessage* countNumNbsTimer;
-    std::vector<int> numNbsOverTime;
-    simtime_t maxNodeLocalSimTime;
+    NeighborCountTimeline numNbsTimeline;   // number of neighbors over the lifetime of the vehicle
 
 
 
@@ -93,7 +93,7 @@ void VehicleObstacleControl::erase(const MobileHostObstacle* obstacle)
     delete obstacle;
 }
 
-Signal VehicleObstacleControl::getVehicleAttenuationSingle(double h1, double h2, double h, double d, double d1, Signal attenuationPrototype)
+Signal VehicleObstacleControl::getVehicleAttenuationSingle(double h1, double h2, double h, double d, double d1, const Signal& attenuationPrototype)
 {
     Signal attenuation = Signal(attenuationPrototype.getSpectrum());
 
@@ -117,7 +117,7 @@ Signal VehicleObstacleControl::getVehicleAttenuationSingle(double h1, double h2,
     return attenuation;
 }
 
-Signal VehicleObstacleControl::getVehicleAttenuationDZ(const std::vector<std::pair<double, double>>& dz_vec, Signal attenuationPrototype)
+Signal VehicleObstacleControl::getVehicleAttenuationDZ(const std::vector<std::pair<double, double>>& dz_vec, const Signal& attenuationPrototype)
 {
 
     // basic sanity check
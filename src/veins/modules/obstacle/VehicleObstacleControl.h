@@ -76,7 +76,7 @@ public:
      * @param d1: distance between sender and obstacle
      * @param attenuationPrototype: a prototype Signal for constructing a Signal containing the attenuation factors for each frequency
      */
-    static Signal getVehicleAttenuationSingle(double h1, double h2, double h, double d, double d1, Signal attenuationPrototype);
+    static Signal getVehicleAttenuationSingle(double h1, double h2, double h, double d, double d1, const Signal& attenuationPrototype);
 
     /**
      * compute attenuation due to vehicles.
@@ -86,7 +86,7 @@ public:
      * @param dz_vec: a vector of (distance, height) referring to potential obstacles along the line of sight, starting with the sender and ending with the receiver
      * @param attenuationPrototype: a prototype Signal for constructing a Signal containing the attenuation factors for each frequency
      */
-    static Signal getVehicleAttenuationDZ(const std::vector<std::pair<double, double>>& dz_vec, Signal attenuationPrototype);
+    static Signal getVehicleAttenuationDZ(const std::vector<std::pair<double, double>>& dz_vec, const Signal& attenuationPrototype);
 
 protected:
     AnnotationManager* annotations;
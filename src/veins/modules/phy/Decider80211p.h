@@ -28,6 +28,7 @@
 #include "veins/modules/utility/Consts80211p.h"
 #include "veins/modules/mac/ieee80211p/Mac80211pToPhy11pInterface.h"
 #include "veins/modules/phy/Decider80211pToPhy80211pInterface.h"
+#include "veins/modules/phy/NistErrorRateTable.h"
 
 namespace veins {
 
@@ -119,6 +120,10 @@ protected:
      * this variable should be set to false
      */
     bool collectCollisionStats;
+
+    /** @brief precomputed success rates to look up instead of evaluating the NIST error rate model, nullptr if not used */
+    const NistErrorRateTable* errorRateTable;
+
     /** @brief count the number of collisions */
     unsigned int collisions;
 
@@ -152,12 +157,15 @@ protected:
     /** @brief computes if packet is ok or has errors*/
     enum PACKET_OK_RESULT packetOk(double snirMin, double snrMin, int lengthMPDU, double bitrate);
 
+    /** @brief returns the probability of receiving nbits bits without error, from errorRateTable if set */
+    double getChunkSuccessRate(double bitrate, double sinr, uint32_t nbits) const;
+
 public:
     /**
      * @brief Initializes the Decider with a pointer to its PhyLayer and
      * specific values for threshold and minPowerLevel
      */
-    Decider80211p(cComponent* owner, DeciderToPhyInterface* phy, double minPowerLevel, double ccaThreshold, bool allowTxDuringRx, double centerFrequency, int myIndex = -1, bool collectCollisionStatistics = false)
+    Decider80211p(cComponent* owner, DeciderToPhyInterface* phy, double minPowerLevel, double ccaThreshold, bool allowTxDuringRx, double centerFrequency, int myIndex = -1, bool collectCollisionStatistics = false, bool useErrorRateTable = false)
         : BaseDecider(owner, phy, minPowerLevel, myIndex)
         , ccaThreshold(ccaThreshold)
         , allowTxDuringRx(allowTxDuringRx)
@@ -165,6 +173,7 @@ public:
         , myBusyTime(0)
         , myStartTime(simTime().dbl())
         , collectCollisionStats(collectCollisionStatistics)
+        , errorRateTable(useErrorRateTable ? &NistErrorRateTable::getInstance() : nullptr)
         , collisions(0)
         , notifyRxStart(false)
     {
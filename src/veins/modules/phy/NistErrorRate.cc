@@ -120,6 +120,52 @@ double NistErrorRate::getFec64QamBer(double snr, uint32_t nbits, uint32_t bValue
     double pms = std::pow(1 - pe, static_cast<double>(nbits));
     return pms;
 }
+double NistErrorRate::getCodedBer(MCS mcs, double snr)
+{
+    double ber;
+    uint32_t bValue;
+    switch (mcs) {
+    case MCS::ofdm_bpsk_r_1_2:
+        ber = getBpskBer(snr);
+        bValue = 1;
+        break;
+    case MCS::ofdm_bpsk_r_3_4:
+        ber = getBpskBer(snr);
+        bValue = 3;
+        break;
+    case MCS::ofdm_qpsk_r_1_2:
+        ber = getQpskBer(snr);
+        bValue = 1;
+        break;
+    case MCS::ofdm_qpsk_r_3_4:
+        ber = getQpskBer(snr);
+        bValue = 3;
+        break;
+    case MCS::ofdm_qam16_r_1_2:
+        ber = get16QamBer(snr);
+        bValue = 1;
+        break;
+    case MCS::ofdm_qam16_r_3_4:
+        ber = get16QamBer(snr);
+        bValue = 3;
+        break;
+    case MCS::ofdm_qam64_r_2_3:
+        ber = get64QamBer(snr);
+        bValue = 2;
+        break;
+    case MCS::ofdm_qam64_r_3_4:
+        ber = get64QamBer(snr);
+        bValue = 3;
+        break;
+    default:
+        ASSERT2(false, "Invalid MCS chosen");
+        return 1;
+    }
+    if (ber == 0.0) {
+        return 0;
+    }
+    return std::min(calculatePe(ber, bValue), 1.0);
+}
 double NistErrorRate::getChunkSuccessRate(unsigned int datarate, enum Bandwidth bw, double snr_mW, uint32_t nbits)
 {
 
@@ -37,6 +37,17 @@ public:
 
     static double getChunkSuccessRate(unsigned int datarate, enum Bandwidth bw, double snr_mW, uint32_t nbits);
 
+    /**
+     * Return the BER after decoding for the given MCS at the given SNR.
+     *
+     * The chunk success rate of nbits bits is (1 - BER)^nbits.
+     *
+     * \param mcs modulation and coding scheme
+     * \param snr snr value
+     * \return BER after decoding, at most 1
+     */
+    static double getCodedBer(MCS mcs, double snr);
+
 private:
     /**
      * Return the coded BER for the given p and b.
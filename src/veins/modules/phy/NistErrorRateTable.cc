@@ -0,0 +1,168 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "veins/modules/phy/NistErrorRateTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "veins/modules/phy/NistErrorRate.h"
+
+using namespace veins;
+
+constexpr double NistErrorRateTable::step_dB;
+constexpr double NistErrorRateTable::maxError;
+constexpr uint32_t NistErrorRateTable::maxBits;
+constexpr size_t NistErrorRateTable::numMcs;
+
+namespace {
+
+// tabulated SNR range in steps, from -10 dB to 60 dB
+const int minStep = -200;
+const int maxStep = 1200;
+
+// BERs below this change the success rate of maxBits bits by less than 1e-15
+const double negligibleLogRate = std::log(1e-20);
+
+// SNRs at which the interpolation of an interval is compared to the analytic model
+const int numSamples = 16;
+
+} // namespace
+
+NistErrorRateTable::NistErrorRateTable()
+{
+    for (size_t i = 0; i < numMcs; ++i) {
+        MCS mcs = static_cast<MCS>(i);
+        McsTable& table = tables[i];
+
+        // start at the last SNR at which nothing can be decoded
+        int step = minStep;
+        while (step < maxStep && std::isinf(getLogRate(mcs, (step + 1) * step_dB))) {
+            ++step;
+        }
+        table.minSnr_dB = step * step_dB;
+
+        double start = getLogRate(mcs, table.minSnr_dB);
+        ASSERT(std::isinf(start) && start > 0);
+
+        // end where the BER becomes negligible
+        while (start >= negligibleLogRate) {
+            ASSERT(step < maxStep);
+            double end = getLogRate(mcs, (step + 1) * step_dB);
+
+            Interval interval{start, end - start};
+            if (std::isinf(start) || !isAccurate(mcs, step * step_dB, start, end)) {
+                interval.slope = std::numeric_limits<double>::quiet_NaN();
+            }
+            table.intervals.push_back(interval);
+
+            start = end;
+            ++step;
+        }
+    }
+}
+
+const NistErrorRateTable& NistErrorRateTable::getInstance()
+{
+    static const NistErrorRateTable instance;
+    return instance;
+}
+
+double NistErrorRateTable::getChunkSuccessRate(unsigned int datarate, enum Bandwidth bw, double snr_mW, uint32_t nbits) const
+{
+    return getChunkSuccessRate(getMCS(datarate, bw), snr_mW, nbits);
+}
+
+double NistErrorRateTable::getChunkSuccessRate(MCS mcs, double snr_mW, uint32_t nbits) const
+{
+    ASSERT2(mcs != MCS::undefined, "Invalid MCS chosen");
+    const McsTable& table = tables[static_cast<size_t>(mcs)];
+
+    if (nbits == 0 || nbits > maxBits) {
+        return getExactChunkSuccessRate(mcs, snr_mW, nbits);
+    }
+
+    double position = (10 * std::log10(snr_mW) - table.minSnr_dB) / step_dB;
+    if (std::isnan(position)) {
+        return getExactChunkSuccessRate(mcs, snr_mW, nbits);
+    }
+    if (position < 0) {
+        return 0;
+    }
+    if (position >= table.intervals.size()) {
+        return 1;
+    }
+
+    size_t index = static_cast<size_t>(position);
+    const Interval& interval = table.intervals[index];
+    if (std::isnan(interval.slope)) {
+        return getExactChunkSuccessRate(mcs, snr_mW, nbits);
+    }
+
+    double rate = std::exp(interval.logRate + (position - index) * interval.slope);
+    return std::exp(-static_cast<double>(nbits) * rate);
+}
+
+size_t NistErrorRateTable::getNumExactIntervals() const
+{
+    size_t count = 0;
+    for (const auto& table : tables) {
+        for (const auto& interval : table.intervals) {
+            if (std::isnan(interval.slope)) ++count;
+        }
+    }
+    return count;
+}
+
+double NistErrorRateTable::getExactChunkSuccessRate(MCS mcs, double snr_mW, uint32_t nbits)
+{
+    // same as NistErrorRate::getChunkSuccessRate(), which returns 1 for a BER of 0
+    return std::pow(1 - NistErrorRate::getCodedBer(mcs, snr_mW), static_cast<double>(nbits));
+}
+
+double NistErrorRateTable::getLogRate(MCS mcs, double snr_dB)
+{
+    double ber = NistErrorRate::getCodedBer(mcs, std::pow(10, snr_dB / 10));
+    return std::log(-std::log1p(-ber));
+}
+
+bool NistErrorRateTable::isAccurate(MCS mcs, double snr_dB, double start, double end)
+{
+    if (!std::isfinite(start) || !std::isfinite(end)) return false;
+
+    for (int sample = 1; sample < numSamples; ++sample) {
+        double fraction = static_cast<double>(sample) / numSamples;
+        double exact = std::exp(getLogRate(mcs, snr_dB + fraction * step_dB));
+        double interpolated = std::exp(start + fraction * (end - start));
+        if (exact == interpolated) continue;
+
+        // exp(-n * interpolated) - exp(-n * exact) is largest at this chunk length
+        double nbits = std::log(interpolated / exact) / (interpolated - exact);
+        nbits = std::min(std::max(nbits, 1.0), static_cast<double>(maxBits));
+
+        // leave a margin for the SNRs in between the samples
+        if (!(std::abs(std::exp(-nbits * interpolated) - std::exp(-nbits * exact)) <= maxError / 2)) return false;
+    }
+    return true;
+}
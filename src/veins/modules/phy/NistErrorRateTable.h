@@ -0,0 +1,99 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#pragma once
+
+#include <array>
+#include <stdint.h>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/modules/utility/ConstsPhy.h"
+
+namespace veins {
+
+/**
+ * Precomputed chunk success rates of the NIST error rate model.
+ *
+ * For every MCS, the BER after decoding is tabulated over the SNR in dB as
+ * log(-log(1 - BER)), which changes smoothly with the SNR, and interpolated
+ * linearly in between. The chunk success rate of nbits bits then is
+ * exp(-nbits * exp(value)). As the BER falls with the SNR, the interpolated
+ * success rate rises monotonically with it.
+ *
+ * The tables are checked against the analytic model when they are built:
+ * intervals in which the interpolated success rate of any chunk of up to
+ * maxBits bits could deviate by more than maxError (close to the SNR below
+ * which nothing can be decoded) are marked, and there, as well as for
+ * longer chunks, the analytic model is evaluated instead.
+ */
+class VEINS_API NistErrorRateTable {
+public:
+    /** @brief Distance of the tabulated SNR values in dB */
+    static constexpr double step_dB = 0.05;
+    /** @brief Maximum absolute deviation of a looked up chunk success rate from the analytic model */
+    static constexpr double maxError = 1e-4;
+    /** @brief Longest chunk the tables are used for, longer ones are evaluated analytically */
+    static constexpr uint32_t maxBits = 65536;
+
+    /** @brief Returns the tables, building them on first use */
+    static const NistErrorRateTable& getInstance();
+
+    /** @brief Returns the chunk success rate, see NistErrorRate::getChunkSuccessRate() */
+    double getChunkSuccessRate(unsigned int datarate, enum Bandwidth bw, double snr_mW, uint32_t nbits) const;
+
+    /** @brief Returns the chunk success rate of nbits bits sent with the given MCS at the given SNR */
+    double getChunkSuccessRate(MCS mcs, double snr_mW, uint32_t nbits) const;
+
+    /** @brief Returns the number of tabulated intervals in which the analytic model is evaluated instead */
+    size_t getNumExactIntervals() const;
+
+private:
+    NistErrorRateTable();
+
+    /** @brief log(-log(1 - BER)) at the start of an interval and its increase per step */
+    struct Interval {
+        double logRate;
+        double slope; ///< NaN if the analytic model is to be used
+    };
+
+    struct McsTable {
+        double minSnr_dB; ///< nothing is decoded below, the BER is negligible after the last interval
+        std::vector<Interval> intervals;
+    };
+
+    /** @brief Returns the chunk success rate of the analytic model */
+    static double getExactChunkSuccessRate(MCS mcs, double snr_mW, uint32_t nbits);
+
+    /** @brief Returns log(-log(1 - BER)) of the analytic model at the given SNR in dB */
+    static double getLogRate(MCS mcs, double snr_dB);
+
+    /** @brief Returns true if the interpolation from start to end is accurate enough over [snr_dB, snr_dB + step_dB] */
+    static bool isAccurate(MCS mcs, double snr_dB, double start, double end);
+
+    static constexpr size_t numMcs = 8;
+    std::array<McsTable, numMcs> tables;
+};
+
+} // namespace veins
@@ -53,6 +53,7 @@ void PhyLayer80211p::initialize(int stage)
         ccaThreshold = pow(10, par("ccaThreshold").doubleValue() / 10);
         allowTxDuringRx = par("allowTxDuringRx").boolValue();
         collectCollisionStatistics = par("collectCollisionStatistics").boolValue();
+        useErrorRateTable = par("useErrorRateTable").boolValue();
 
         // Create frequency mappings and initialize spectrum for signal representation
         Spectrum::Frequencies freqs;
@@ -254,7 +255,7 @@ unique_ptr<AnalogueModel> PhyLayer80211p::initializeVehicleObstacleShadowing(Par
 unique_ptr<Decider> PhyLayer80211p::initializeDecider80211p(ParameterMap& params)
 {
     double centerFreq = params["centerFrequency"];
-    auto dec = make_unique<Decider80211p>(this, this, minPowerLevel, ccaThreshold, allowTxDuringRx, centerFreq, findHost()->getIndex(), collectCollisionStatistics);
+    auto dec = make_unique<Decider80211p>(this, this, minPowerLevel, ccaThreshold, allowTxDuringRx, centerFreq, findHost()->getIndex(), collectCollisionStatistics, useErrorRateTable);
     dec->setPath(getParentModule()->getFullPath());
     return unique_ptr<Decider>(std::move(dec));
 }
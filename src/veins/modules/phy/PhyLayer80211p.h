@@ -73,6 +73,9 @@ protected:
     /** @brief enable/disable detection of packet collisions */
     bool collectCollisionStatistics;
 
+    /** @brief look up success rates in precomputed tables. See Decider80211p for details */
+    bool useErrorRateTable;
+
     /** @brief allows/disallows interruption of current reception for txing
      *
      * See detailed description in Decider80211p
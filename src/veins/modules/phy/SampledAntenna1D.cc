@@ -21,6 +21,8 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
+#include <algorithm>
+
 #include "veins/modules/phy/SampledAntenna1D.h"
 #include "veins/base/utils/FWMath.h"
 
@@ -118,6 +120,11 @@ double SampledAntenna1D::getGain(Coord ownPos, Coord ownOrient, Coord otherPos)
     return FWMath::dBm2mW(gainValue);
 }
 
+double SampledAntenna1D::getMaxGain()
+{
+    return FWMath::dBm2mW(*std::max_element(antennaGains.begin(), antennaGains.end()));
+}
+
 double SampledAntenna1D::getLastAngle()
 {
     return lastAngle / M_PI * 180.0;
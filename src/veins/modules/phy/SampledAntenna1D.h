@@ -100,6 +100,11 @@ public:
 
     double getLastAngle() override;
 
+    /**
+     * @brief Returns the largest sample, gains interpolated between samples never exceed it.
+     */
+    double getMaxGain() override;
+
 private:
     /**
      * @brief Used to store the antenna's samples.
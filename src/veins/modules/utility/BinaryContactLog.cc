@@ -0,0 +1,326 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/modules/utility/BinaryContactLog.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "veins/modules/utility/BufferedLogSink.h"
+
+using namespace veins::BinaryContactLog;
+
+namespace {
+
+const char headerMagic[4] = {'V', 'C', 'L', 'H'};
+const char blockMagic[4] = {'V', 'C', 'L', 'B'};
+const uint32_t formatVersion = 1;
+const size_t blockHeaderSize = 16;
+
+void putUint32(std::string& out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++) out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+void putUint64(std::string& out, uint64_t value)
+{
+    for (int i = 0; i < 8; i++) out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+void putDouble(std::string& out, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putUint64(out, bits);
+}
+
+void putString(std::string& out, const std::string& value)
+{
+    putUint32(out, value.size());
+    out.append(value);
+}
+
+void putVarint(std::string& out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+uint64_t zigzag(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+void padTo8(std::string& out, size_t start)
+{
+    while ((out.size() - start) % 8) out.push_back('\0');
+}
+
+/**
+ * Bounds-checked reading of little endian values from a byte buffer.
+ */
+class Cursor {
+public:
+    Cursor(const std::string& data, const std::string& path)
+        : data(data)
+        , path(path)
+        , pos(0)
+    {
+    }
+
+    uint32_t getUint32()
+    {
+        require(4);
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++) value |= static_cast<uint32_t>(static_cast<uint8_t>(data[pos++])) << (8 * i);
+        return value;
+    }
+
+    uint64_t getUint64()
+    {
+        require(8);
+        uint64_t value = 0;
+        for (int i = 0; i < 8; i++) value |= static_cast<uint64_t>(static_cast<uint8_t>(data[pos++])) << (8 * i);
+        return value;
+    }
+
+    double getDouble()
+    {
+        uint64_t bits = getUint64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    uint64_t getVarint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            require(1);
+            uint8_t byte = static_cast<uint8_t>(data[pos++]);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw cRuntimeError("BinaryContactLog: malformed varint in \"%s\"", path.c_str());
+    }
+
+    size_t getPos() const
+    {
+        return pos;
+    }
+
+private:
+    void require(size_t bytes)
+    {
+        if (pos + bytes > data.size()) throw cRuntimeError("BinaryContactLog: truncated data in \"%s\"", path.c_str());
+    }
+
+    const std::string& data;
+    const std::string& path;
+    size_t pos;
+};
+
+} // namespace
+
+double Record::getContactDuration(int32_t scaleExponent) const
+{
+    return contactDurationRaw * std::pow(10.0, scaleExponent);
+}
+
+std::string veins::BinaryContactLog::formatRawTime(int64_t raw, int32_t scaleExponent)
+{
+    std::string sign = raw < 0 ? "-" : "";
+    uint64_t value = raw < 0 ? -static_cast<uint64_t>(raw) : raw;
+    if (scaleExponent >= 0) {
+        std::string digits = std::to_string(value);
+        if (value != 0) digits.append(scaleExponent, '0');
+        return sign + digits;
+    }
+
+    uint64_t scale = 1;
+    for (int i = 0; i < -scaleExponent; i++) scale *= 10;
+    std::string result = sign + std::to_string(value / scale);
+    uint64_t fraction = value % scale;
+    if (fraction == 0) return result;
+
+    std::string fractionDigits = std::to_string(fraction);
+    fractionDigits.insert(0, -scaleExponent - fractionDigits.size(), '0');
+    fractionDigits.erase(fractionDigits.find_last_not_of('0') + 1);
+    return result + "." + fractionDigits;
+}
+
+Writer::Writer(BufferedLogFile& file, const Header& header, size_t rowsPerBlock)
+    : file(file)
+    , header(header)
+    , rowsPerBlock(rowsPerBlock)
+    , headerWritten(false)
+{
+    ASSERT(rowsPerBlock > 0);
+    rows.reserve(rowsPerBlock);
+}
+
+void Writer::setHeader(const Header& header)
+{
+    ASSERT(!headerWritten);
+    this->header = header;
+}
+
+void Writer::add(const Record& record)
+{
+    rows.push_back(record);
+    if (rows.size() >= rowsPerBlock) flush();
+}
+
+void Writer::flush()
+{
+    if (rows.empty()) return;
+
+    encoded.clear();
+
+    if (!headerWritten) {
+        encoded.append(headerMagic, sizeof(headerMagic));
+        putUint32(encoded, formatVersion);
+        putUint32(encoded, header.seed);
+        putUint32(encoded, header.scaleExponent);
+        putDouble(encoded, header.laneMaxSpeed);
+        putDouble(encoded, header.txPower);
+        putString(encoded, header.scenarioName);
+        putString(encoded, header.dateTime);
+        padTo8(encoded, 0);
+        headerWritten = true;
+    }
+
+    size_t blockStart = encoded.size();
+    encoded.append(blockMagic, sizeof(blockMagic));
+    putUint32(encoded, rows.size());
+    size_t varintSizePos = encoded.size();
+    putUint32(encoded, 0);
+    putUint32(encoded, 0);
+
+    for (auto& row : rows) putUint64(encoded, row.contactDurationRaw);
+
+    size_t varintStart = encoded.size();
+    int64_t previous = 0;
+    for (auto& row : rows) {
+        putVarint(encoded, zigzag(row.simTime - previous));
+        previous = row.simTime;
+    }
+    previous = 0;
+    for (auto& row : rows) {
+        putVarint(encoded, zigzag(row.myId - previous));
+        previous = row.myId;
+    }
+    previous = 0;
+    for (auto& row : rows) {
+        putVarint(encoded, zigzag(row.nbId - previous));
+        previous = row.nbId;
+    }
+    uint32_t varintSize = encoded.size() - varintStart;
+    for (int i = 0; i < 4; i++) encoded[varintSizePos + i] = static_cast<char>((varintSize >> (8 * i)) & 0xff);
+    padTo8(encoded, blockStart);
+
+    file.write(encoded.data(), encoded.size());
+    rows.clear();
+}
+
+Reader::Reader(const std::string& path)
+    : path(path)
+    , stream(path, std::ios::binary)
+    , numRuns(0)
+{
+    if (!stream.is_open()) throw cRuntimeError("BinaryContactLog: cannot open \"%s\"", path.c_str());
+}
+
+bool Reader::readBlock(std::vector<Record>& records)
+{
+    while (true) {
+        char magic[4];
+        if (!stream.read(magic, sizeof(magic))) {
+            if (stream.gcount() == 0) return false;
+            throw cRuntimeError("BinaryContactLog: truncated data in \"%s\"", path.c_str());
+        }
+
+        if (std::memcmp(magic, headerMagic, sizeof(magic)) == 0) {
+            // fixed part: version, seed, scale exponent, laneMaxSpeed, txPower, length of scenario name
+            block.resize(32);
+            if (!stream.read(&block[0], block.size())) throw cRuntimeError("BinaryContactLog: truncated header in \"%s\"", path.c_str());
+            Cursor fixed(block, path);
+            uint32_t version = fixed.getUint32();
+            if (version != formatVersion) throw cRuntimeError("BinaryContactLog: unsupported version %u of \"%s\"", version, path.c_str());
+            header.seed = static_cast<int32_t>(fixed.getUint32());
+            header.scaleExponent = static_cast<int32_t>(fixed.getUint32());
+            header.laneMaxSpeed = fixed.getDouble();
+            header.txPower = fixed.getDouble();
+            uint32_t scenarioLength = fixed.getUint32();
+
+            header.scenarioName.resize(scenarioLength);
+            char lengthBytes[4];
+            if (!stream.read(&header.scenarioName[0], scenarioLength) || !stream.read(lengthBytes, sizeof(lengthBytes))) {
+                throw cRuntimeError("BinaryContactLog: truncated header in \"%s\"", path.c_str());
+            }
+            uint32_t dateTimeLength = 0;
+            for (int i = 0; i < 4; i++) dateTimeLength |= static_cast<uint32_t>(static_cast<uint8_t>(lengthBytes[i])) << (8 * i);
+            header.dateTime.resize(dateTimeLength);
+            if (!stream.read(&header.dateTime[0], dateTimeLength)) throw cRuntimeError("BinaryContactLog: truncated header in \"%s\"", path.c_str());
+
+            size_t headerSize = 4 + 32 + scenarioLength + 4 + dateTimeLength;
+            stream.ignore((8 - headerSize % 8) % 8);
+            numRuns++;
+            continue;
+        }
+
+        if (std::memcmp(magic, blockMagic, sizeof(magic)) != 0) throw cRuntimeError("BinaryContactLog: malformed data in \"%s\"", path.c_str());
+        if (numRuns == 0) throw cRuntimeError("BinaryContactLog: block without header in \"%s\"", path.c_str());
+
+        block.resize(blockHeaderSize - sizeof(magic));
+        if (!stream.read(&block[0], block.size())) throw cRuntimeError("BinaryContactLog: truncated block in \"%s\"", path.c_str());
+        Cursor blockHeader(block, path);
+        uint32_t numRows = blockHeader.getUint32();
+        uint32_t varintSize = blockHeader.getUint32();
+
+        size_t payloadSize = 8 * static_cast<size_t>(numRows) + varintSize;
+        size_t paddedSize = payloadSize + (8 - (blockHeaderSize + payloadSize) % 8) % 8;
+        block.resize(paddedSize);
+        if (paddedSize > 0 && !stream.read(&block[0], paddedSize)) throw cRuntimeError("BinaryContactLog: truncated block in \"%s\"", path.c_str());
+
+        records.resize(numRows);
+        Cursor payload(block, path);
+        for (auto& record : records) record.contactDurationRaw = static_cast<int64_t>(payload.getUint64());
+        int64_t previous = 0;
+        for (auto& record : records) previous = record.simTime = previous + unzigzag(payload.getVarint());
+        previous = 0;
+        for (auto& record : records) previous = record.myId = previous + unzigzag(payload.getVarint());
+        previous = 0;
+        for (auto& record : records) previous = record.nbId = previous + unzigzag(payload.getVarint());
+        if (payload.getPos() != payloadSize) throw cRuntimeError("BinaryContactLog: malformed block in \"%s\"", path.c_str());
+
+        return true;
+    }
+}
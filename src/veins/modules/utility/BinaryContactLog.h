@@ -0,0 +1,164 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+class BufferedLogFile;
+
+/**
+ * Compact binary columnar format of the per-second neighbor contact duration log.
+ *
+ * A file is a sequence of runs, so that several runs can append to the same file
+ * just like they do to the csv logs. Each run starts with a header holding all
+ * values that are constant during the run, followed by any number of blocks of rows.
+ * All integers are little endian, and every header and block starts at a multiple
+ * of 8 bytes, so a file can be mapped into memory and its columns accessed in place.
+ *
+ * Run header:
+ *   char[4] magic "VCLH", uint32 version, int32 seed, int32 simtime scale exponent,
+ *   float64 laneMaxSpeed, float64 txPower,
+ *   uint32 length + bytes of scenario name, uint32 length + bytes of date time,
+ *   zero padding to a multiple of 8 bytes
+ *
+ * Block:
+ *   char[4] magic "VCLB", uint32 number of rows n, uint32 size of the varint section, uint32 reserved,
+ *   int64[n] contact durations as raw simtime values (exact, see the scale exponent),
+ *   varint section: n simTime values, then n myIds, then n nbIds,
+ *   each zigzag-encoded as the difference to the previous value of its column in the block (the first to 0),
+ *   zero padding to a multiple of 8 bytes
+ *
+ * Since every block restarts the delta encoding, blocks can be decoded independently.
+ */
+namespace BinaryContactLog {
+
+/**
+ * Values that are constant during a run.
+ */
+struct VEINS_API Header {
+    int32_t seed = 0;
+    int32_t scaleExponent = -12; ///< simtime resolution of the raw contact durations, in powers of 10 seconds
+    double laneMaxSpeed = 0;
+    double txPower = 0;
+    std::string scenarioName;
+    std::string dateTime;
+};
+
+/**
+ * One row of the log, i.e., one neighbor of one vehicle at one second.
+ */
+struct VEINS_API Record {
+    int64_t simTime; ///< in whole seconds
+    int64_t myId;
+    int64_t nbId;
+    int64_t contactDurationRaw; ///< in units of 10^scaleExponent seconds
+
+    double getContactDuration(int32_t scaleExponent) const;
+};
+
+/**
+ * Formats a raw simtime value as decimal seconds, the same way omnetpp::SimTime is printed.
+ */
+VEINS_API std::string formatRawTime(int64_t raw, int32_t scaleExponent);
+
+/**
+ * Collects rows into blocks and appends them to a log file of the BufferedLogSink.
+ *
+ * The run header is written in front of the first block.
+ */
+class VEINS_API Writer {
+public:
+    Writer(BufferedLogFile& file, const Header& header, size_t rowsPerBlock = 65536);
+
+    /**
+     * Adds one row, writing a block once rowsPerBlock rows have been collected.
+     */
+    void add(const Record& record);
+
+    /**
+     * Writes all collected rows as a (possibly smaller) block.
+     */
+    void flush();
+
+    /**
+     * Updates the run header. Only allowed before the first block has been written.
+     */
+    void setHeader(const Header& header);
+
+private:
+    BufferedLogFile& file;
+    Header header;
+    size_t rowsPerBlock;
+    bool headerWritten;
+    std::vector<Record> rows;
+    std::string encoded; ///< re-used encoding buffer
+};
+
+/**
+ * Reads a log file block by block, with memory bounded by the size of one block.
+ */
+class VEINS_API Reader {
+public:
+    explicit Reader(const std::string& path);
+
+    /**
+     * Reads the next block of rows into records, replacing its contents.
+     *
+     * @return false at the end of the file
+     */
+    bool readBlock(std::vector<Record>& records);
+
+    /**
+     * Returns the header of the run the last block read belongs to.
+     */
+    const Header& getHeader() const
+    {
+        return header;
+    }
+
+    /**
+     * Returns the number of runs (headers) read so far.
+     */
+    size_t getNumRuns() const
+    {
+        return numRuns;
+    }
+
+private:
+    std::string path;
+    std::ifstream stream;
+    Header header;
+    size_t numRuns;
+    std::string block; ///< re-used read buffer
+};
+
+} // namespace BinaryContactLog
+
+} // namespace veins
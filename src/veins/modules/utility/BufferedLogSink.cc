@@ -0,0 +1,207 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/modules/utility/BufferedLogSink.h"
+
+using veins::BufferedLogFile;
+using veins::BufferedLogSink;
+
+BufferedLogFile::BufferedLogFile(BufferedLogSink* sink, const std::string& path)
+    : sink(sink)
+    , path(path)
+    , stream(path, std::ios::app | std::ios::binary)
+{
+    if (!stream.is_open()) {
+        throw cRuntimeError("BufferedLogSink: cannot open log file \"%s\"", path.c_str());
+    }
+}
+
+BufferedLogFile& BufferedLogFile::operator<<(std::ostream& (*manipulator)(std::ostream&))
+{
+    if (manipulator == static_cast<std::ostream& (*) (std::ostream&)>(std::endl)) {
+        endRow();
+    }
+    else {
+        manipulator(buffer);
+    }
+    return *this;
+}
+
+void BufferedLogFile::endRow()
+{
+    buffer << '\n';
+    if (static_cast<size_t>(buffer.tellp()) >= sink->bufferSize) {
+        sink->submit(this);
+    }
+}
+
+void BufferedLogFile::write(const char* data, size_t size)
+{
+    buffer.write(data, size);
+    if (static_cast<size_t>(buffer.tellp()) >= sink->bufferSize) {
+        sink->submit(this);
+    }
+}
+
+BufferedLogSink& BufferedLogSink::getInstance()
+{
+    static BufferedLogSink instance;
+    return instance;
+}
+
+BufferedLogSink::BufferedLogSink()
+    : bufferSize(1 << 20)
+    , maxPendingBytes(64 << 20)
+    , pendingBytes(0)
+    , writing(false)
+    , stopping(false)
+{
+}
+
+BufferedLogSink::~BufferedLogSink()
+{
+    try {
+        close();
+    }
+    catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
+
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        workAvailable.notify_one();
+        writer.join();
+    }
+}
+
+BufferedLogFile& BufferedLogSink::getFile(const std::string& path)
+{
+    auto i = files.find(path);
+    if (i != files.end()) return *i->second;
+
+    std::unique_ptr<BufferedLogFile> file(new BufferedLogFile(this, path));
+    BufferedLogFile& ref = *file;
+    files[path] = std::move(file);
+    return ref;
+}
+
+void BufferedLogSink::setBufferSize(size_t bytes)
+{
+    bufferSize = bytes;
+}
+
+void BufferedLogSink::setMaxPendingBytes(size_t bytes)
+{
+    maxPendingBytes = bytes;
+}
+
+void BufferedLogSink::submit(BufferedLogFile* file)
+{
+    enqueue(file);
+    checkError();
+}
+
+void BufferedLogSink::enqueue(BufferedLogFile* file)
+{
+    PendingWrite write = {file, file->buffer.str()};
+    file->buffer.str("");
+    file->buffer.clear();
+    if (write.data.empty()) return;
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!writer.joinable()) {
+            writer = std::thread(&BufferedLogSink::run, this);
+        }
+        // back-pressure: wait for the writer thread to catch up, but always accept at least one buffer
+        workDone.wait(lock, [this, &write]() { return pendingBytes == 0 || pendingBytes + write.data.size() <= maxPendingBytes; });
+        pendingBytes += write.data.size();
+        queue.push_back(std::move(write));
+    }
+    workAvailable.notify_one();
+}
+
+void BufferedLogSink::flush()
+{
+    for (auto& file : files) {
+        enqueue(file.second.get());
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        workDone.wait(lock, [this]() { return queue.empty() && !writing; });
+    }
+
+    checkError();
+}
+
+void BufferedLogSink::close()
+{
+    // flush() only throws once the writer thread is idle, so the files can safely be closed in either case
+    try {
+        flush();
+    }
+    catch (...) {
+        files.clear();
+        throw;
+    }
+    files.clear();
+}
+
+void BufferedLogSink::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        workAvailable.wait(lock, [this]() { return stopping || !queue.empty(); });
+        if (queue.empty()) break;
+
+        PendingWrite write = std::move(queue.front());
+        queue.pop_front();
+        writing = true;
+        lock.unlock();
+
+        write.file->stream.write(write.data.data(), write.data.size());
+        write.file->stream.flush();
+        bool failed = !write.file->stream;
+
+        lock.lock();
+        writing = false;
+        pendingBytes -= write.data.size();
+        if (failed && error.empty()) {
+            error = "BufferedLogSink: cannot write to log file \"" + write.file->getPath() + "\"";
+        }
+        workDone.notify_all();
+    }
+}
+
+void BufferedLogSink::checkError()
+{
+    std::string message;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        message.swap(error);
+    }
+    if (!message.empty()) throw cRuntimeError("%s", message.c_str());
+}
@@ -0,0 +1,174 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+class BufferedLogSink;
+
+/**
+ * A log file of the BufferedLogSink.
+ *
+ * Rows are formatted with operator<< exactly as they would be into a std::ofstream,
+ * but into an in-memory buffer. Each row is ended by endRow() or by streaming std::endl,
+ * which do not flush: once the buffer exceeds the buffer size of the sink, it is
+ * handed over to the sink's background thread as a whole.
+ *
+ * Obtain instances from BufferedLogSink::getFile().
+ */
+class VEINS_API BufferedLogFile {
+public:
+    template <typename T>
+    BufferedLogFile& operator<<(const T& value)
+    {
+        buffer << value;
+        return *this;
+    }
+
+    /**
+     * Applies a stream manipulator. std::endl ends the current row.
+     */
+    BufferedLogFile& operator<<(std::ostream& (*manipulator)(std::ostream&));
+
+    /**
+     * Ends the current row.
+     */
+    void endRow();
+
+    /**
+     * Appends raw bytes, e.g., of a binary log format.
+     */
+    void write(const char* data, size_t size);
+
+    const std::string& getPath() const
+    {
+        return path;
+    }
+
+private:
+    friend class BufferedLogSink;
+
+    BufferedLogFile(BufferedLogSink* sink, const std::string& path);
+
+    BufferedLogSink* sink; ///< the sink owning this file
+    std::string path; ///< path of the file on disk
+    std::ostringstream buffer; ///< rows not yet handed to the sink, only accessed by the simulation thread
+    std::ofstream stream; ///< the open file, only accessed by the writer thread (or while it is idle)
+};
+
+/**
+ * Process-wide sink for log (csv) files that takes file I/O off the event loop.
+ *
+ * Every file is opened (in binary append mode) once and kept open until close().
+ * Rows are collected in large per-file buffers, full buffers are written by a single
+ * background thread in the order they were handed over.
+ * The amount of memory held by buffers waiting to be written is bounded:
+ * if it exceeds the configured limit, the simulation thread blocks until the
+ * writer thread has caught up.
+ */
+class VEINS_API BufferedLogSink {
+public:
+    static BufferedLogSink& getInstance();
+
+    ~BufferedLogSink();
+
+    /**
+     * Returns the log file at the given path, opening it in append mode if it is not yet open.
+     *
+     * The returned reference stays valid until close() is called.
+     */
+    BufferedLogFile& getFile(const std::string& path);
+
+    /**
+     * Sets the size (in bytes) above which a file buffer is handed to the writer thread.
+     */
+    void setBufferSize(size_t bytes);
+
+    /**
+     * Sets the maximum number of bytes waiting to be written before the simulation thread blocks.
+     */
+    void setMaxPendingBytes(size_t bytes);
+
+    /**
+     * Hands over all buffered rows and waits until they have been written to disk.
+     */
+    void flush();
+
+    /**
+     * Flushes and closes all open files.
+     *
+     * The files are closed even if writing them failed, the error is thrown afterwards.
+     */
+    void close();
+
+private:
+    friend class BufferedLogFile;
+
+    struct PendingWrite {
+        BufferedLogFile* file;
+        std::string data;
+    };
+
+    BufferedLogSink();
+
+    /** @brief hand the buffer of the given file to the writer thread and throw any write error */
+    void submit(BufferedLogFile* file);
+
+    /** @brief hand the buffer of the given file to the writer thread, blocking if too many bytes are pending */
+    void enqueue(BufferedLogFile* file);
+
+    /** @brief main loop of the writer thread */
+    void run();
+
+    /** @brief throw any error that was encountered by the writer thread */
+    void checkError();
+
+    size_t bufferSize;
+    size_t maxPendingBytes;
+
+    std::map<std::string, std::unique_ptr<BufferedLogFile>> files; ///< only accessed by the simulation thread
+
+    std::mutex mutex; ///< protects all members below
+    std::condition_variable workAvailable;
+    std::condition_variable workDone;
+    std::deque<PendingWrite> queue;
+    size_t pendingBytes;
+    bool writing;
+    bool stopping;
+    std::string error;
+    std::thread writer;
+};
+
+} // namespace veins
@@ -0,0 +1,68 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/SimpleAddress.h"
+#include "veins/modules/utility/NeighborTable.h"
+
+namespace veins {
+
+/**
+ * One step of the beacon-free (geometric) contact detection of a vehicle.
+ *
+ * Every neighbor in inRange is observed, starting a new contact or extending the current one.
+ * Afterwards, the contacts with all neighbors in current which are not in range any more are ended,
+ * in ascending order of their addresses, so the result does not depend on the layout of the table.
+ *
+ * @param current   the neighbors the vehicle is currently in contact with, updated by observe and end
+ * @param inRange   addresses of the neighbors in range at this step (sorted in place)
+ * @param ended     re-used buffer
+ * @param observe   called with the address of each neighbor in range
+ * @param end       called with the address of each neighbor which is no longer in range
+ */
+template <typename Value, typename Observe, typename End>
+void updateGeometricContacts(const NeighborTable<Value>& current, std::vector<LAddress::L2Type>& inRange, std::vector<LAddress::L2Type>& ended, Observe observe, End end)
+{
+    for (LAddress::L2Type nbId : inRange) {
+        observe(nbId);
+    }
+    std::sort(inRange.begin(), inRange.end());
+
+    ended.clear();
+    for (auto& nb : current) {
+        if (!std::binary_search(inRange.begin(), inRange.end(), nb.key)) {
+            ended.push_back(nb.key);
+        }
+    }
+    std::sort(ended.begin(), ended.end());
+    for (LAddress::L2Type nbId : ended) {
+        end(nbId);
+    }
+}
+
+} // namespace veins
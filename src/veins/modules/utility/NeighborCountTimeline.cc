@@ -0,0 +1,101 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/modules/utility/NeighborCountTimeline.h"
+
+#include <algorithm>
+#include <cmath>
+
+using veins::NeighborCountTimeline;
+using veins::PerSecondAggregate;
+
+NeighborCountTimeline::NeighborCountTimeline()
+    : firstSecond(0)
+{
+}
+
+void NeighborCountTimeline::start(double startTime, int count)
+{
+    firstSecond = static_cast<int64_t>(std::ceil(startTime));
+    runs.clear();
+    runs.push_back({0, count});
+}
+
+void NeighborCountTimeline::set(double time, int count)
+{
+    ASSERT(!runs.empty());
+
+    // a change at time t is first seen by the sample of second ceil(t)
+    int64_t second = std::max(static_cast<int64_t>(std::ceil(time)), firstSecond);
+    uint32_t offset = static_cast<uint32_t>(second - firstSecond);
+    ASSERT(offset >= runs.back().offset);
+
+    if (offset == runs.back().offset) {
+        // the run was never sampled, so it is replaced
+        runs.back().count = count;
+        if (runs.size() > 1 && runs[runs.size() - 2].count == count) runs.pop_back();
+    }
+    else if (runs.back().count != count) {
+        runs.push_back({offset, count});
+    }
+}
+
+void NeighborCountTimeline::mergeInto(PerSecondAggregate& aggregate, double endTime) const
+{
+    int64_t lastSecond = static_cast<int64_t>(std::floor(endTime));
+
+    for (size_t i = 0; i < runs.size(); i++) {
+        int64_t runStart = firstSecond + runs[i].offset;
+        int64_t runEnd = (i + 1 < runs.size()) ? firstSecond + runs[i + 1].offset - 1 : lastSecond;
+        runEnd = std::min(runEnd, lastSecond);
+        if (runEnd < runStart) break;
+        aggregate.collect(runStart, runs[i].count, runEnd - runStart + 1);
+    }
+}
+
+void PerSecondAggregate::clear()
+{
+    seconds.clear();
+}
+
+void PerSecondAggregate::collect(int64_t firstSecond, int value, uint64_t numSeconds)
+{
+    ASSERT(firstSecond >= 0);
+    if (numSeconds == 0) return;
+
+    size_t end = static_cast<size_t>(firstSecond + numSeconds);
+    if (end > seconds.size()) seconds.resize(end);
+
+    for (size_t s = firstSecond; s < end; s++) {
+        Second& second = seconds[s];
+        if (second.count == 0 || value < second.min) second.min = value;
+        if (second.count == 0 || value > second.max) second.max = value;
+        second.count++;
+        second.sum += value;
+    }
+}
+
+double PerSecondAggregate::getMean(size_t second) const
+{
+    if (seconds[second].count == 0) return 0;
+    return static_cast<double>(seconds[second].sum) / seconds[second].count;
+}
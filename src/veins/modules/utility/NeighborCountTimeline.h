@@ -0,0 +1,148 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+class PerSecondAggregate;
+
+/**
+ * Run-length encoded number of neighbors of one node over its lifetime.
+ *
+ * The count is sampled at whole seconds, i.e., the sample of second s is the
+ * count in effect at time s (as set by the last change at or before s).
+ * Only changes of the sampled count are stored, as runs relative to the first
+ * second sampled after the node started, so the memory footprint depends on
+ * how often the count changes and not on the simulated time.
+ */
+class VEINS_API NeighborCountTimeline {
+public:
+    NeighborCountTimeline();
+
+    /**
+     * Discards all runs and starts a new timeline at the given time (in seconds).
+     */
+    void start(double startTime, int count = 0);
+
+    /**
+     * Records that the count changed to the given value at the given time (in seconds).
+     *
+     * Times must not decrease.
+     */
+    void set(double time, int count);
+
+    /**
+     * Adds the samples of all whole seconds from the start up to and including endTime to the aggregate.
+     */
+    void mergeInto(PerSecondAggregate& aggregate, double endTime) const;
+
+    /**
+     * Returns the first second sampled by this timeline.
+     */
+    int64_t getFirstSecond() const
+    {
+        return firstSecond;
+    }
+
+    /**
+     * Returns the number of runs currently stored.
+     */
+    size_t getNumRuns() const
+    {
+        return runs.size();
+    }
+
+private:
+    struct Run {
+        uint32_t offset; ///< first second of the run, relative to firstSecond
+        int32_t count;
+    };
+
+    int64_t firstSecond;
+    std::vector<Run> runs;
+};
+
+/**
+ * Count, sum, minimum and maximum of the samples of many nodes per whole second.
+ *
+ * Seconds are allocated on demand, so memory only grows with the latest second sampled.
+ */
+class VEINS_API PerSecondAggregate {
+public:
+    /**
+     * Discards all samples.
+     */
+    void clear();
+
+    /**
+     * Adds the sample value to each of the seconds [firstSecond, firstSecond + numSeconds).
+     */
+    void collect(int64_t firstSecond, int value, uint64_t numSeconds = 1);
+
+    /**
+     * Returns the number of seconds covered, i.e., the latest second sampled + 1.
+     */
+    size_t getNumSeconds() const
+    {
+        return seconds.size();
+    }
+
+    uint64_t getCount(size_t second) const
+    {
+        return seconds[second].count;
+    }
+    int64_t getSum(size_t second) const
+    {
+        return seconds[second].sum;
+    }
+    int getMin(size_t second) const
+    {
+        return seconds[second].min;
+    }
+    int getMax(size_t second) const
+    {
+        return seconds[second].max;
+    }
+
+    /**
+     * Returns the mean of the given second, 0 if it has no samples.
+     */
+    double getMean(size_t second) const;
+
+private:
+    struct Second {
+        uint64_t count = 0;
+        int64_t sum = 0;
+        int min = 0;
+        int max = 0;
+    };
+
+    std::vector<Second> seconds;
+};
+
+} // namespace veins
@@ -0,0 +1,245 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "veins/veins.h"
+
+#include "veins/base/utils/SimpleAddress.h"
+
+namespace veins {
+
+/**
+ * Flat hash table of per-neighbor state, keyed by L2 address.
+ *
+ * Entries are stored inline in one array (open addressing with linear probing),
+ * so looking up, inserting or updating a neighbor is a single probe sequence over
+ * contiguous memory and does not allocate, except when the table grows.
+ * Erasing uses backward shift deletion, so no tombstones accumulate.
+ *
+ * Iteration visits all entries in an unspecified (but deterministic) order.
+ * Inserting or erasing invalidates pointers to entries and running iterations.
+ */
+template <typename Value>
+class NeighborTable {
+public:
+    using Key = LAddress::L2Type;
+
+    struct Entry {
+        Key key;
+        Value value;
+    };
+
+    template <typename EntryType, typename TablePtr>
+    class IteratorBase {
+    public:
+        IteratorBase(TablePtr table, size_t slot)
+            : table(table)
+            , slot(slot)
+        {
+            skipEmpty();
+        }
+        EntryType& operator*() const
+        {
+            return table->entries[slot];
+        }
+        EntryType* operator->() const
+        {
+            return &table->entries[slot];
+        }
+        IteratorBase& operator++()
+        {
+            ++slot;
+            skipEmpty();
+            return *this;
+        }
+        bool operator!=(const IteratorBase& other) const
+        {
+            return slot != other.slot;
+        }
+        bool operator==(const IteratorBase& other) const
+        {
+            return slot == other.slot;
+        }
+
+    private:
+        void skipEmpty()
+        {
+            while (slot < table->entries.size() && !table->occupied[slot]) ++slot;
+        }
+
+        TablePtr table;
+        size_t slot;
+    };
+
+    using iterator = IteratorBase<Entry, NeighborTable*>;
+    using const_iterator = IteratorBase<const Entry, const NeighborTable*>;
+
+    NeighborTable()
+        : numEntries(0)
+    {
+    }
+
+    /**
+     * Returns the value of the given neighbor, nullptr if it is not in the table.
+     */
+    Value* find(Key key)
+    {
+        size_t slot;
+        return findSlot(key, slot) ? &entries[slot].value : nullptr;
+    }
+
+    const Value* find(Key key) const
+    {
+        size_t slot;
+        return findSlot(key, slot) ? &entries[slot].value : nullptr;
+    }
+
+    bool contains(Key key) const
+    {
+        return find(key) != nullptr;
+    }
+
+    /**
+     * Returns the value of the given neighbor, inserting a value-initialized one if it is not in the table.
+     *
+     * @return the value and whether it was inserted
+     */
+    std::pair<Value*, bool> insert(Key key)
+    {
+        if (4 * (numEntries + 1) > 3 * entries.size()) grow();
+
+        size_t slot;
+        if (findSlot(key, slot)) return std::make_pair(&entries[slot].value, false);
+
+        occupied[slot] = true;
+        entries[slot].key = key;
+        entries[slot].value = Value();
+        numEntries++;
+        return std::make_pair(&entries[slot].value, true);
+    }
+
+    /**
+     * Removes the given neighbor.
+     *
+     * @return whether it was in the table
+     */
+    bool erase(Key key)
+    {
+        size_t hole;
+        if (!findSlot(key, hole)) return false;
+
+        // shift back the following entries of the probe sequence which may not be found behind the hole any more
+        size_t mask = entries.size() - 1;
+        for (size_t next = (hole + 1) & mask; occupied[next]; next = (next + 1) & mask) {
+            size_t home = homeSlot(entries[next].key);
+            bool homeInRange = (hole <= next) ? (hole < home && home <= next) : (hole < home || home <= next);
+            if (homeInRange) continue;
+            entries[hole] = std::move(entries[next]);
+            hole = next;
+        }
+
+        occupied[hole] = false;
+        entries[hole].value = Value();
+        numEntries--;
+        return true;
+    }
+
+    void clear()
+    {
+        entries.clear();
+        occupied.clear();
+        numEntries = 0;
+    }
+
+    size_t size() const
+    {
+        return numEntries;
+    }
+
+    bool empty() const
+    {
+        return numEntries == 0;
+    }
+
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+    iterator end()
+    {
+        return iterator(this, entries.size());
+    }
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+    const_iterator end() const
+    {
+        return const_iterator(this, entries.size());
+    }
+
+private:
+    size_t homeSlot(Key key) const
+    {
+        // Fibonacci hashing spreads consecutive addresses over the whole table
+        uint64_t hash = static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ULL;
+        return static_cast<size_t>(hash >> 32) & (entries.size() - 1);
+    }
+
+    /** @brief finds the slot of the key, or the empty slot where it would be inserted */
+    bool findSlot(Key key, size_t& slot) const
+    {
+        if (entries.empty()) return false;
+        size_t mask = entries.size() - 1;
+        for (slot = homeSlot(key); occupied[slot]; slot = (slot + 1) & mask) {
+            if (entries[slot].key == key) return true;
+        }
+        return false;
+    }
+
+    void grow()
+    {
+        std::vector<Entry> oldEntries(entries.empty() ? 16 : 2 * entries.size());
+        std::vector<bool> oldOccupied(oldEntries.size(), false);
+        oldEntries.swap(entries);
+        oldOccupied.swap(occupied);
+
+        for (size_t i = 0; i < oldEntries.size(); i++) {
+            if (!oldOccupied[i]) continue;
+            size_t slot;
+            findSlot(oldEntries[i].key, slot);
+            occupied[slot] = true;
+            entries[slot] = std::move(oldEntries[i]);
+        }
+    }
+
+    std::vector<Entry> entries;
+    std::vector<bool> occupied;
+    size_t numEntries;
+};
+
+} // namespace veins
@@ -0,0 +1,162 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/modules/utility/QuantileSketch.h"
+
+#include <algorithm>
+#include <cmath>
+
+using veins::QuantileSketch;
+
+namespace {
+
+const uint64_t initialRandomState = 0x9e3779b97f4a7c15ULL;
+
+} // namespace
+
+QuantileSketch::QuantileSketch(size_t k)
+{
+    configure(k);
+}
+
+void QuantileSketch::configure(size_t k)
+{
+    if (k < 8) throw cRuntimeError("QuantileSketch: k must be at least 8, got %d", static_cast<int>(k));
+    this->k = k;
+    clear();
+}
+
+void QuantileSketch::clear()
+{
+    levels.assign(1, std::vector<double>());
+    count = 0;
+    min = 0;
+    max = 0;
+    randomState = initialRandomState;
+}
+
+void QuantileSketch::collect(double value)
+{
+    if (count == 0 || value < min) min = value;
+    if (count == 0 || value > max) max = value;
+    count++;
+
+    levels[0].push_back(value);
+    if (levels[0].size() >= getCapacity(0)) compress();
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+    if (other.count == 0) return;
+    if (count == 0 || other.min < min) min = other.min;
+    if (count == 0 || other.max > max) max = other.max;
+    count += other.count;
+
+    if (other.levels.size() > levels.size()) levels.resize(other.levels.size());
+    for (size_t level = 0; level < other.levels.size(); level++) {
+        levels[level].insert(levels[level].end(), other.levels[level].begin(), other.levels[level].end());
+    }
+    compress();
+}
+
+double QuantileSketch::getQuantile(double q) const
+{
+    if (count == 0) return 0;
+    if (q <= 0) return min;
+    if (q >= 1) return max;
+
+    std::vector<std::pair<double, uint64_t>> weighted;
+    weighted.reserve(getNumRetained());
+    uint64_t totalWeight = 0;
+    for (size_t level = 0; level < levels.size(); level++) {
+        for (double value : levels[level]) weighted.push_back(std::make_pair(value, uint64_t(1) << level));
+        totalWeight += levels[level].size() << level;
+    }
+    std::sort(weighted.begin(), weighted.end());
+
+    // smallest retained sample whose cumulative weight reaches the rank
+    double rank = q * totalWeight;
+    uint64_t cumulativeWeight = 0;
+    for (auto& sample : weighted) {
+        cumulativeWeight += sample.second;
+        if (cumulativeWeight >= rank) return sample.first;
+    }
+    return max;
+}
+
+size_t QuantileSketch::getNumRetained() const
+{
+    size_t retained = 0;
+    for (auto& level : levels) retained += level.size();
+    return retained;
+}
+
+size_t QuantileSketch::getCapacity(size_t level) const
+{
+    size_t depth = levels.size() - 1 - level;
+    return std::max<size_t>(2, static_cast<size_t>(std::ceil(k * std::pow(2.0 / 3.0, depth))));
+}
+
+void QuantileSketch::compress()
+{
+    while (true) {
+        size_t totalCapacity = 0;
+        for (size_t level = 0; level < levels.size(); level++) totalCapacity += getCapacity(level);
+        if (getNumRetained() < totalCapacity) return;
+
+        // compact the lowest level that is full
+        for (size_t level = 0; level < levels.size(); level++) {
+            if (levels[level].size() >= getCapacity(level)) {
+                compact(level);
+                break;
+            }
+        }
+    }
+}
+
+void QuantileSketch::compact(size_t level)
+{
+    if (level + 1 == levels.size()) levels.emplace_back();
+    std::vector<double>& from = levels[level];
+    std::vector<double>& to = levels[level + 1];
+
+    std::sort(from.begin(), from.end());
+
+    // an odd sample out stays on this level
+    bool keepLast = from.size() % 2 == 1;
+    double last = keepLast ? from.back() : 0;
+    size_t numPairs = from.size() / 2;
+
+    size_t offset = nextBit() ? 1 : 0;
+    for (size_t i = 0; i < numPairs; i++) to.push_back(from[2 * i + offset]);
+
+    from.clear();
+    if (keepLast) from.push_back(last);
+}
+
+bool QuantileSketch::nextBit()
+{
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 7;
+    randomState ^= randomState << 17;
+    return (randomState >> 32) & 1;
+}
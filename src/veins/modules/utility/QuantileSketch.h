@@ -0,0 +1,117 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * Mergeable quantile sketch of a stream of samples (KLL sketch).
+ *
+ * Samples are kept in a hierarchy of compactors: level h holds samples of weight 2^h.
+ * Whenever the sketch exceeds its capacity, a full level is sorted and every other
+ * sample (starting at a pseudo-random offset) is promoted to the next level, the others are dropped.
+ * The capacity of the levels decreases geometrically from the top, so memory is O(k)
+ * regardless of the number of samples, while the rank error of a quantile is
+ * about 1.7% (at 99% confidence) for the default k = 200, and shrinks roughly as 1/k.
+ *
+ * The offsets are drawn from an internal generator with a fixed seed,
+ * so the results are reproducible and independent of the simulation's RNGs.
+ * Count, minimum and maximum are exact.
+ */
+class VEINS_API QuantileSketch {
+public:
+    /**
+     * Creates an empty sketch with accuracy parameter k (at least 8).
+     */
+    explicit QuantileSketch(size_t k = 200);
+
+    /**
+     * Discards all samples and sets a new accuracy parameter.
+     */
+    void configure(size_t k);
+
+    /**
+     * Discards all samples.
+     */
+    void clear();
+
+    /**
+     * Adds one sample.
+     */
+    void collect(double value);
+
+    /**
+     * Adds all samples of other to this sketch.
+     */
+    void merge(const QuantileSketch& other);
+
+    /**
+     * Returns the (approximate) q-quantile of all samples, 0 <= q <= 1, or 0 if the sketch is empty.
+     */
+    double getQuantile(double q) const;
+
+    uint64_t getCount() const
+    {
+        return count;
+    }
+    double getMin() const
+    {
+        return min;
+    }
+    double getMax() const
+    {
+        return max;
+    }
+
+    /**
+     * Returns the number of samples currently retained.
+     */
+    size_t getNumRetained() const;
+
+private:
+    /** @brief capacity of the given level, given the current number of levels */
+    size_t getCapacity(size_t level) const;
+
+    /** @brief compact levels until the sketch fits into its capacity */
+    void compress();
+
+    /** @brief promote every other sample of the given level to the next one */
+    void compact(size_t level);
+
+    /** @brief pseudo-random bit (xorshift) */
+    bool nextBit();
+
+    size_t k;
+    std::vector<std::vector<double>> levels;
+    uint64_t count;
+    double min;
+    double max;
+    uint64_t randomState;
+};
+
+} // namespace veins
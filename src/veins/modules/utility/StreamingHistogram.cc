@@ -0,0 +1,117 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "veins/modules/utility/StreamingHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+using veins::StreamingHistogram;
+
+StreamingHistogram::StreamingHistogram()
+    : StreamingHistogram(1, 0, 0)
+{
+}
+
+StreamingHistogram::StreamingHistogram(double binWidth, size_t numBins, double origin)
+{
+    configure(binWidth, numBins, origin);
+}
+
+void StreamingHistogram::configure(double binWidth, size_t numBins, double origin)
+{
+    if (!(binWidth > 0)) throw cRuntimeError("StreamingHistogram: bin width must be positive, got %f", binWidth);
+    this->binWidth = binWidth;
+    this->origin = origin;
+    bins.assign(numBins, 0);
+    bins.shrink_to_fit();
+    clear();
+}
+
+void StreamingHistogram::clear()
+{
+    std::fill(bins.begin(), bins.end(), 0);
+    underflow = 0;
+    overflow = 0;
+    count = 0;
+    sum = 0;
+    min = 0;
+    max = 0;
+}
+
+void StreamingHistogram::collect(double value, uint64_t weight)
+{
+    if (weight == 0) return;
+
+    if (count == 0) {
+        min = value;
+        max = value;
+    }
+    else {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    count += weight;
+    sum += value * weight;
+
+    double pos = std::floor((value - origin) / binWidth);
+    if (pos < 0) {
+        underflow += weight;
+    }
+    else if (pos >= bins.size()) {
+        overflow += weight;
+    }
+    else {
+        bins[static_cast<size_t>(pos)] += weight;
+    }
+}
+
+void StreamingHistogram::merge(const StreamingHistogram& other)
+{
+    if (other.binWidth != binWidth || other.origin != origin || other.bins.size() != bins.size()) {
+        throw cRuntimeError("StreamingHistogram: cannot merge histograms of different bin layout");
+    }
+    if (other.count == 0) return;
+
+    if (count == 0) {
+        min = other.min;
+        max = other.max;
+    }
+    else {
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+    for (size_t i = 0; i < bins.size(); i++) {
+        bins[i] += other.bins[i];
+    }
+    underflow += other.underflow;
+    overflow += other.overflow;
+    count += other.count;
+    sum += other.sum;
+}
+
+size_t StreamingHistogram::getUsedBins() const
+{
+    size_t used = bins.size();
+    while (used > 0 && bins[used - 1] == 0) used--;
+    return used;
+}
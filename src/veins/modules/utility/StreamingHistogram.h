@@ -0,0 +1,175 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "veins/veins.h"
+
+namespace veins {
+
+/**
+ * Fixed-memory histogram that is updated one sample at a time.
+ *
+ * Samples are counted into numBins bins of equal width, starting at origin.
+ * Samples below origin are counted in an underflow bucket, samples at or above
+ * origin + numBins * binWidth in an overflow bucket, so no sample is ever lost
+ * and the memory footprint never changes after construction.
+ * Counts are exact; sum, minimum and maximum are tracked alongside.
+ *
+ * Two histograms with the same layout can be merged, e.g., to combine the
+ * partial results of several vehicles or runs.
+ *
+ * To count samples to their nearest multiple of binWidth (as round() would),
+ * pass origin = -binWidth / 2; bin k then represents the value k * binWidth.
+ */
+class VEINS_API StreamingHistogram {
+public:
+    /**
+     * Creates an empty histogram without any bins.
+     *
+     * Every sample is counted as overflow until configure() is called.
+     */
+    StreamingHistogram();
+
+    /**
+     * Creates an empty histogram of numBins bins of width binWidth, starting at origin.
+     */
+    StreamingHistogram(double binWidth, size_t numBins, double origin = 0);
+
+    /**
+     * Discards all samples and sets a new bin layout.
+     */
+    void configure(double binWidth, size_t numBins, double origin = 0);
+
+    /**
+     * Discards all samples, keeping the bin layout.
+     */
+    void clear();
+
+    /**
+     * Counts the given sample weight times.
+     */
+    void collect(double value, uint64_t weight = 1);
+
+    /**
+     * Adds all samples of other to this histogram.
+     *
+     * Throws if the bin layout of both histograms differs.
+     */
+    void merge(const StreamingHistogram& other);
+
+    double getBinWidth() const
+    {
+        return binWidth;
+    }
+    double getOrigin() const
+    {
+        return origin;
+    }
+    size_t getNumBins() const
+    {
+        return bins.size();
+    }
+
+    /**
+     * Returns the lower edge of bin i.
+     */
+    double getBinStart(size_t i) const
+    {
+        return origin + i * binWidth;
+    }
+
+    uint64_t getBinCount(size_t i) const
+    {
+        return bins.at(i);
+    }
+    uint64_t getUnderflowCount() const
+    {
+        return underflow;
+    }
+    uint64_t getOverflowCount() const
+    {
+        return overflow;
+    }
+
+    /**
+     * Returns the number of samples in all bins, including under- and overflow.
+     */
+    uint64_t getCount() const
+    {
+        return count;
+    }
+
+    /**
+     * Returns the index one past the last non-empty bin, or 0 if all bins are empty.
+     */
+    size_t getUsedBins() const;
+
+    double getSum() const
+    {
+        return sum;
+    }
+    double getMean() const
+    {
+        return count ? sum / count : 0;
+    }
+
+    /**
+     * Returns the smallest sample collected so far (0 if empty).
+     */
+    double getMin() const
+    {
+        return count ? min : 0;
+    }
+
+    /**
+     * Returns the largest sample collected so far (0 if empty).
+     */
+    double getMax() const
+    {
+        return count ? max : 0;
+    }
+
+    /**
+     * Returns the share of samples in bin i, in percent of all samples.
+     */
+    double getBinPercentage(size_t i) const
+    {
+        return count ? 100.0 * bins.at(i) / count : 0;
+    }
+
+private:
+    double binWidth;
+    double origin;
+    std::vector<uint64_t> bins;
+    uint64_t underflow;
+    uint64_t overflow;
+    uint64_t count;
+    double sum;
+    double min;
+    double max;
+};
+
+} // namespace veins
@@ -0,0 +1,139 @@
+//
+// Copyright (C) 2018-2019 Dominik S. Buse <buse@ccs-labs.org>
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+
+#include "veins/base/phyLayer/BasePhyLayer.h"
+#include "veins/base/connectionManager/NicEntry.h"
+#include "veins/base/utils/FWMath.h"
+#include "veins/modules/analogueModel/SimplePathlossModel.h"
+#include "testutils/Simulation.h"
+#include "testutils/AirFrame.h"
+
+using namespace veins;
+
+namespace {
+
+class TestPhyLayer : public BasePhyLayer {
+public:
+    TestPhyLayer(Coord pos, double interferenceFloor_dBm)
+    {
+        cullFanOut = true;
+        interferenceFloor = FWMath::dBm2mW(interferenceFloor_dBm);
+        antenna = std::make_shared<Antenna>();
+        antennaPosition = AntennaPosition(-1, pos, Coord(0, 0, 0), simTime());
+        analogueModels.push_back(AnalogueModelList::value_type(new SimplePathlossModel(this, 2.2, false, {0, 0, 0})));
+    }
+
+    using BasePhyLayer::canReach;
+
+    void setCullFanOut(bool cull)
+    {
+        cullFanOut = cull;
+    }
+
+    void setInterferenceFloor(double floor)
+    {
+        interferenceFloor = floor;
+    }
+
+    /** @brief largest receive power of the given frame (over all frequencies) after the analogue models of this phy */
+    double getMaxReceivePower(AirFrame& frame, const TestPhyLayer& sender)
+    {
+        Signal s = frame.getSignal();
+        s.setSenderPoa({sender.antennaPosition, {}, sender.antenna});
+        s.setReceiverPoa({antennaPosition, {}, antenna});
+        for (auto& analogueModel : analogueModels) {
+            analogueModel->filterSignal(&s);
+        }
+        double maxPower = 0;
+        for (size_t i = 0; i < s.getNumValues(); i++) {
+            maxPower = std::max(maxPower, s.at(i));
+        }
+        return maxPower;
+    }
+};
+
+class TestNicEntry : public NicEntry {
+public:
+    TestNicEntry(ChannelAccess* chAccess)
+        : NicEntry(chAccess)
+    {
+        this->chAccess = chAccess;
+    }
+
+    void connectTo(NicEntry*) override
+    {
+    }
+
+    void disconnectFrom(NicEntry*) override
+    {
+    }
+};
+
+} // namespace
+
+SCENARIO("BasePhyLayer culls the fan-out below the interference floor", "[phyLayer]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+
+    GIVEN("A sender and a receiver 800 m apart and a frame sent with 20 mW")
+    {
+        TestPhyLayer sender(Coord(0, 0, 2), -110);
+        TestPhyLayer receiver(Coord(800, 0, 2), -110);
+        TestNicEntry receiverNic(&receiver);
+        AirFrame frame = createAirframe(5.89e9, 10e6, 0, 0.001, 20);
+        const double receivePower = receiver.getMaxReceivePower(frame, sender);
+
+        WHEN("the receive power is exactly the interference floor of the receiver")
+        {
+            receiver.setInterferenceFloor(receivePower);
+
+            THEN("the receiver is not culled")
+            {
+                REQUIRE(sender.canReach(&frame, &receiverNic));
+            }
+        }
+
+        WHEN("the receive power is below the interference floor of the receiver")
+        {
+            receiver.setInterferenceFloor(receivePower * 1.01);
+
+            THEN("the receiver is culled")
+            {
+                REQUIRE_FALSE(sender.canReach(&frame, &receiverNic));
+            }
+
+            AND_WHEN("culling is disabled at the sender")
+            {
+                sender.setCullFanOut(false);
+
+                THEN("the receiver is not culled")
+                {
+                    REQUIRE(sender.canReach(&frame, &receiverNic));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,112 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <cstdio>
+
+#include "veins/modules/utility/BinaryContactLog.h"
+#include "veins/modules/utility/BufferedLogSink.h"
+
+using namespace veins;
+
+SCENARIO("BinaryContactLog", "[binaryContactLog]")
+{
+    const std::string path = "BinaryContactLogTest.bin";
+    std::remove(path.c_str());
+
+    GIVEN("Two runs of records written to the same file")
+    {
+        BinaryContactLog::Header first;
+        first.seed = 3;
+        first.scenarioName = "IrelandNationalN7-FreeFlow";
+        first.laneMaxSpeed = 33.33;
+        first.txPower = 0.2;
+        first.dateTime = "2020-01-01.12:00:00";
+
+        BinaryContactLog::Header second = first;
+        second.seed = 4;
+        second.scenarioName = "odd";
+
+        std::vector<BinaryContactLog::Record> written;
+        for (int64_t t = 1; t <= 10; t++) {
+            for (int64_t id = 16; id < 26; id++) {
+                written.push_back({t, id, 52 - id, t * 1000000000000 + id * 7});
+            }
+        }
+        written.push_back({11, 1, 99, -5});
+
+        BufferedLogFile& file = BufferedLogSink::getInstance().getFile(path);
+        BinaryContactLog::Writer writer1(file, first, 7);
+        for (auto& record : written) writer1.add(record);
+        writer1.flush();
+        BinaryContactLog::Writer writer2(file, second);
+        writer2.add({12, 2, 3, 4});
+        writer2.flush();
+        BufferedLogSink::getInstance().close();
+
+        WHEN("reading the file")
+        {
+            BinaryContactLog::Reader reader(path);
+            std::vector<BinaryContactLog::Record> block;
+            std::vector<BinaryContactLog::Record> read;
+            while (reader.readBlock(block) && reader.getNumRuns() == 1) {
+                REQUIRE(reader.getHeader().seed == 3);
+                read.insert(read.end(), block.begin(), block.end());
+            }
+
+            THEN("all records of the first run are read back unchanged")
+            {
+                REQUIRE(reader.getHeader().scenarioName == "odd");
+                REQUIRE(reader.getHeader().laneMaxSpeed == 33.33);
+                REQUIRE(read.size() == written.size());
+                for (size_t i = 0; i < read.size(); i++) {
+                    REQUIRE(read[i].simTime == written[i].simTime);
+                    REQUIRE(read[i].myId == written[i].myId);
+                    REQUIRE(read[i].nbId == written[i].nbId);
+                    REQUIRE(read[i].contactDurationRaw == written[i].contactDurationRaw);
+                }
+            }
+
+            THEN("the second run follows the first")
+            {
+                REQUIRE(reader.getNumRuns() == 2);
+                REQUIRE(block.size() == 1);
+                REQUIRE(block[0].nbId == 3);
+                REQUIRE_FALSE(reader.readBlock(block));
+            }
+        }
+    }
+
+    std::remove(path.c_str());
+}
+
+SCENARIO("BinaryContactLog raw time formatting", "[binaryContactLog]")
+{
+    THEN("raw times are printed like SimTime")
+    {
+        REQUIRE(BinaryContactLog::formatRawTime(0, -12) == "0");
+        REQUIRE(BinaryContactLog::formatRawTime(12500000000000, -12) == "12.5");
+        REQUIRE(BinaryContactLog::formatRawTime(1000000001, -12) == "0.001000000001");
+        REQUIRE(BinaryContactLog::formatRawTime(-3000000000000, -12) == "-3");
+    }
+}
@@ -0,0 +1,140 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "veins/modules/utility/BufferedLogSink.h"
+
+using namespace veins;
+
+namespace {
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+} // namespace
+
+SCENARIO("BufferedLogSink", "[bufferedLogSink]")
+{
+    const std::string path = "BufferedLogSinkTest.csv";
+    std::remove(path.c_str());
+
+    BufferedLogSink& sink = BufferedLogSink::getInstance();
+
+    GIVEN("A sink which hands over buffers of 64 bytes and holds at most 256 pending bytes")
+    {
+        sink.setBufferSize(64);
+        sink.setMaxPendingBytes(256);
+        BufferedLogFile& file = sink.getFile(path);
+
+        WHEN("a row shorter than the buffer size is written")
+        {
+            file << "a," << 1 << std::endl;
+
+            THEN("it only reaches the file once the sink is flushed")
+            {
+                REQUIRE(readFile(path) == "");
+                sink.flush();
+                REQUIRE(readFile(path) == "a,1\n");
+            }
+        }
+
+        WHEN("far more rows than the pending limit are written")
+        {
+            std::ostringstream expected;
+            for (int i = 0; i < 10000; i++) {
+                file << i << "," << i * 0.5 << std::endl;
+                expected << i << "," << i * 0.5 << "\n";
+            }
+            std::string large(1000, 'x');
+            file.write(large.data(), large.size());
+            file.endRow();
+            expected << large << "\n";
+            sink.flush();
+
+            THEN("the writer catches up and all rows reach the file in order")
+            {
+                REQUIRE(readFile(path) == expected.str());
+            }
+        }
+
+        WHEN("the sink is closed and the file is used again")
+        {
+            file << "first" << std::endl;
+            sink.close();
+            REQUIRE(readFile(path) == "first\n");
+            sink.getFile(path) << "second" << std::endl;
+            sink.close();
+
+            THEN("the rows of both uses are appended in order")
+            {
+                REQUIRE(readFile(path) == "first\nsecond\n");
+            }
+        }
+
+        sink.close();
+    }
+
+    GIVEN("A file which cannot be written")
+    {
+        sink.setBufferSize(64);
+        sink.setMaxPendingBytes(256);
+        BufferedLogFile& full = sink.getFile("/dev/full");
+        BufferedLogFile& file = sink.getFile(path);
+        full << "lost" << std::endl;
+        file << "kept" << std::endl;
+
+        THEN("close reports the error to the caller, but still writes and closes all files")
+        {
+            REQUIRE_THROWS_AS(sink.close(), cRuntimeError);
+            REQUIRE(readFile(path) == "kept\n");
+
+            AND_THEN("the error is reported only once")
+            {
+                REQUIRE_NOTHROW(sink.close());
+            }
+        }
+
+        sink.close();
+    }
+
+    GIVEN("A file which cannot be opened")
+    {
+        THEN("the error is reported to the caller")
+        {
+            REQUIRE_THROWS_AS(sink.getFile("no-such-directory/BufferedLogSinkTest.csv"), cRuntimeError);
+        }
+    }
+
+    sink.setBufferSize(1 << 20);
+    sink.setMaxPendingBytes(64 << 20);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,225 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include "veins/base/phyLayer/ChannelInfo.h"
+
+using namespace veins;
+
+namespace {
+
+AirFrame* makeAirFrame(simtime_t duration)
+{
+    AirFrame* frame = new AirFrame();
+    frame->setDuration(duration);
+    return frame;
+}
+
+std::vector<AirFrame*> getAirFrames(const ChannelInfo& channelInfo, simtime_t from, simtime_t to)
+{
+    ChannelInfo::AirFrameVector out;
+    channelInfo.getAirFrames(from, to, out);
+    return std::vector<AirFrame*>(out.begin(), out.end());
+}
+
+} // namespace
+
+SCENARIO("ChannelInfo", "[phyLayer]")
+{
+    GIVEN("An empty ChannelInfo")
+    {
+        ChannelInfo channelInfo;
+
+        THEN("there is nothing on the channel")
+        {
+            REQUIRE(channelInfo.isChannelEmpty());
+            REQUIRE(channelInfo.getEarliestInfoPoint() == -1);
+            REQUIRE(getAirFrames(channelInfo, 0, 100).empty());
+        }
+
+        WHEN("overlapping AirFrames are added")
+        {
+            // a: [0, 10], b: [2, 4], c: [6, 12]
+            AirFrame* a = makeAirFrame(10);
+            AirFrame* b = makeAirFrame(2);
+            channelInfo.addAirFrame(a, 0);
+            channelInfo.addAirFrame(b, 2);
+
+            THEN("intersections include the bounds of the intervals")
+            {
+                REQUIRE(getAirFrames(channelInfo, 0, 100) == std::vector<AirFrame*>({a, b}));
+                REQUIRE(getAirFrames(channelInfo, 4, 5) == std::vector<AirFrame*>({a, b}));
+                REQUIRE(getAirFrames(channelInfo, 0, 1) == std::vector<AirFrame*>({a}));
+                REQUIRE(getAirFrames(channelInfo, 5, 5) == std::vector<AirFrame*>({a}));
+                REQUIRE(getAirFrames(channelInfo, 11, 20).empty());
+                REQUIRE(channelInfo.getEarliestInfoPoint() == 0);
+            }
+
+            AND_WHEN("an AirFrame ends while another one is still active")
+            {
+                REQUIRE(channelInfo.removeAirFrame(b) == 0);
+                AirFrame* c = makeAirFrame(6);
+                channelInfo.addAirFrame(c, 6);
+
+                THEN("it is still returned for the intervals it intersects with")
+                {
+                    REQUIRE(getAirFrames(channelInfo, 3, 3) == std::vector<AirFrame*>({a, b}));
+                    REQUIRE(getAirFrames(channelInfo, 5, 7) == std::vector<AirFrame*>({a, c}));
+                }
+
+                AND_WHEN("the AirFrame it intersected with ends")
+                {
+                    REQUIRE(channelInfo.removeAirFrame(a) == 0);
+
+                    THEN("it is discarded, while the ended AirFrame intersecting with an active one is kept")
+                    {
+                        REQUIRE(getAirFrames(channelInfo, 0, 100) == std::vector<AirFrame*>({a, c}));
+                    }
+
+                    AND_WHEN("the last AirFrame ends")
+                    {
+                        REQUIRE(channelInfo.removeAirFrame(c) == -1);
+
+                        THEN("the channel is empty")
+                        {
+                            REQUIRE(channelInfo.isChannelEmpty());
+                            REQUIRE(getAirFrames(channelInfo, 0, 100).empty());
+                        }
+                    }
+                }
+            }
+
+            AND_WHEN("the channel is recorded")
+            {
+                channelInfo.startRecording(1);
+                channelInfo.removeAirFrame(b);
+                AirFrame* c = makeAirFrame(6);
+                channelInfo.addAirFrame(c, 6);
+                channelInfo.removeAirFrame(a);
+
+                THEN("AirFrames of the recorded period are kept")
+                {
+                    REQUIRE(getAirFrames(channelInfo, 0, 100) == std::vector<AirFrame*>({a, b, c}));
+                }
+
+                AND_WHEN("recording stops")
+                {
+                    channelInfo.stopRecording();
+
+                    THEN("only those intersecting with an active AirFrame are kept")
+                    {
+                        REQUIRE(getAirFrames(channelInfo, 0, 100) == std::vector<AirFrame*>({a, c}));
+                    }
+                }
+            }
+
+            for (auto frame : getAirFrames(channelInfo, 0, 100)) {
+                delete frame;
+            }
+        }
+
+        WHEN("AirFrames starting at the same time are added in a different order than they were created")
+        {
+            AirFrame* a = makeAirFrame(2);
+            AirFrame* b = makeAirFrame(4);
+            AirFrame* c = makeAirFrame(1);
+            AirFrame* d = makeAirFrame(3);
+            AirFrame* e = makeAirFrame(1);
+            REQUIRE(a->getId() < b->getId());
+            REQUIRE(b->getId() < c->getId());
+            REQUIRE(c->getId() < d->getId());
+            channelInfo.addAirFrame(c, 1);
+            channelInfo.addAirFrame(b, 1);
+            channelInfo.addAirFrame(e, 2);
+            channelInfo.addAirFrame(d, 2);
+            channelInfo.addAirFrame(a, 2);
+
+            THEN("they are returned in the order of their start times, and by id for equal start times")
+            {
+                REQUIRE(getAirFrames(channelInfo, 0, 100) == std::vector<AirFrame*>({b, c, a, d, e}));
+                REQUIRE(getAirFrames(channelInfo, 2, 2) == std::vector<AirFrame*>({b, c, a, d, e}));
+                REQUIRE(getAirFrames(channelInfo, 2.5, 2.5) == std::vector<AirFrame*>({b, a, d, e}));
+            }
+
+            AND_WHEN("the same AirFrames are added in yet another order")
+            {
+                ChannelInfo other;
+                other.addAirFrame(b, 1);
+                other.addAirFrame(c, 1);
+                other.addAirFrame(a, 2);
+                other.addAirFrame(e, 2);
+                other.addAirFrame(d, 2);
+
+                THEN("they are returned in the same order")
+                {
+                    REQUIRE(getAirFrames(other, 0, 100) == getAirFrames(channelInfo, 0, 100));
+                }
+            }
+
+            for (auto frame : getAirFrames(channelInfo, 0, 100)) {
+                delete frame;
+            }
+        }
+
+        WHEN("many more AirFrames are added than fit into the initial buffer")
+        {
+            AirFrame* longFrame = makeAirFrame(1000);
+            channelInfo.addAirFrame(longFrame, 0);
+            std::vector<AirFrame*> shortFrames;
+            for (int i = 1; i <= 100; ++i) {
+                AirFrame* frame = makeAirFrame(1);
+                channelInfo.addAirFrame(frame, i);
+                shortFrames.push_back(frame);
+                if (i % 2 == 0) {
+                    channelInfo.removeAirFrame(shortFrames[i - 2]);
+                    channelInfo.removeAirFrame(shortFrames[i - 1]);
+                }
+            }
+
+            THEN("every AirFrame is still found")
+            {
+                REQUIRE(getAirFrames(channelInfo, 0, 1000).size() == 101);
+                REQUIRE(getAirFrames(channelInfo, 50.5, 50.5) == std::vector<AirFrame*>({longFrame, shortFrames[49]}));
+            }
+
+            AND_WHEN("the long AirFrame ends")
+            {
+                channelInfo.removeAirFrame(longFrame);
+
+                THEN("all are discarded")
+                {
+                    REQUIRE(channelInfo.isChannelEmpty());
+                }
+            }
+            for (auto frame : getAirFrames(channelInfo, 0, 1000)) {
+                delete frame;
+            }
+        }
+    }
+}
@@ -0,0 +1,98 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "catch2/catch.hpp"
+
+#include <sstream>
+
+#include "veins/base/connectionManager/ConnectionManagerStatistics.h"
+
+using veins::ConnectionManagerStatistics;
+
+SCENARIO("ConnectionManagerStatistics", "[connectionManager]")
+{
+
+    GIVEN("Statistics counting fan-outs of up to 4 receivers")
+    {
+        ConnectionManagerStatistics s;
+        s.configureFanOut(4);
+
+        WHEN("transmissions to 0, 2, 2 and 7 receivers are collected")
+        {
+            s.collectTransmission(0, 1);
+            s.collectTransmission(2, 0);
+            s.collectTransmission(2, 3);
+            s.collectTransmission(7, 0);
+
+            THEN("the fan-out is counted per number of receivers")
+            {
+                REQUIRE(s.getFanOut().getCount() == 4);
+                REQUIRE(s.getFanOut().getBinCount(0) == 1);
+                REQUIRE(s.getFanOut().getBinCount(1) == 0);
+                REQUIRE(s.getFanOut().getBinCount(2) == 2);
+                REQUIRE(s.getFanOut().getOverflowCount() == 1);
+                REQUIRE(s.getFanOut().getSum() == 11);
+                REQUIRE(s.getFanOutCulled() == 4);
+            }
+
+            THEN("the report holds the fan-out up to the largest bin used")
+            {
+                std::ostringstream os;
+                s.writeJson(os, 10);
+                std::string report = os.str();
+                REQUIRE(report.find("\"fanOut\": {\"transmissions\": 4, \"frames\": 11, \"culled\": 4") != std::string::npos);
+                REQUIRE(report.find("\"counts\": [1, 0, 2]") != std::string::npos);
+            }
+        }
+
+        WHEN("phases are timed")
+        {
+            {
+                ConnectionManagerStatistics::PhaseTimer timer(&s, ConnectionManagerStatistics::APPLY_DIFFS);
+            }
+            {
+                ConnectionManagerStatistics::PhaseTimer timer(nullptr, ConnectionManagerStatistics::APPLY_DIFFS);
+            }
+
+            THEN("only timers with statistics count")
+            {
+                REQUIRE(s.getPhaseCalls(ConnectionManagerStatistics::APPLY_DIFFS) == 1);
+                REQUIRE(s.getPhaseSeconds(ConnectionManagerStatistics::APPLY_DIFFS) >= 0);
+                REQUIRE(s.getPhaseCalls(ConnectionManagerStatistics::COMPUTE_DIFFS) == 0);
+            }
+
+            THEN("the report lists every phase and counter")
+            {
+                s.connects = 3;
+                std::ostringstream os;
+                s.writeJson(os, 10);
+                std::string report = os.str();
+                REQUIRE(report.find("\"wallClockSeconds\": 10") != std::string::npos);
+                REQUIRE(report.find("\"connects\": 3") != std::string::npos);
+                REQUIRE(report.find("\"applyDiffs\": {\"calls\": 1") != std::string::npos);
+                REQUIRE(report.find("\"positionUpdate\": {\"calls\": 0, \"seconds\": 0}") != std::string::npos);
+                REQUIRE(report.find("\"counts\": []") != std::string::npos);
+            }
+        }
+    }
+}
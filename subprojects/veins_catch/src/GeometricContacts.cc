@@ -0,0 +1,115 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "veins/modules/utility/GeometricContacts.h"
+
+using veins::LAddress;
+using veins::NeighborTable;
+
+namespace {
+
+struct Contact {
+    double startTime;
+    double lastSeen;
+};
+
+using EndedContact = std::tuple<LAddress::L2Type, double, double, double>; // nbId, startTime, lastSeen, time it ended
+
+} // namespace
+
+SCENARIO("Geometric contact detection", "[geometricContacts]")
+{
+    GIVEN("A scripted trace of three vehicles on a road and a contact range of 100 m")
+    {
+        // vehicle 1 stands at 0 m, vehicle 2 passes it, vehicle 3 stands at 80 m but is out of range at t = 3, 4 and 9
+        const double range = 100;
+        const std::vector<std::map<LAddress::L2Type, double>> trace = {
+            {{1, 0}, {2, 300}, {3, 80}},
+            {{1, 0}, {2, 250}, {3, 80}},
+            {{1, 0}, {2, 200}, {3, 80}},
+            {{1, 0}, {2, 150}, {3, 500}},
+            {{1, 0}, {2, 100}, {3, 500}},
+            {{1, 0}, {2, 50}, {3, 80}},
+            {{1, 0}, {2, 0}, {3, 80}},
+            {{1, 0}, {2, -50}, {3, 80}},
+            {{1, 0}, {2, -100}, {3, 80}},
+            {{1, 0}, {2, -150}, {3, 500}},
+        };
+
+        WHEN("vehicle 1 evaluates its contacts at every step")
+        {
+            NeighborTable<Contact> current;
+            std::vector<LAddress::L2Type> inRange;
+            std::vector<LAddress::L2Type> ended;
+            std::vector<EndedContact> endedContacts;
+            std::vector<size_t> numContacts;
+
+            for (size_t t = 0; t < trace.size(); t++) {
+                const double now = t;
+                inRange.clear();
+                // in the order of the connection manager's gate list, i.e., descending here
+                for (auto nb = trace[t].rbegin(); nb != trace[t].rend(); ++nb) {
+                    double distance = nb->second - trace[t].at(1);
+                    if (nb->first != 1 && distance * distance <= range * range) inRange.push_back(nb->first);
+                }
+
+                veins::updateGeometricContacts(current, inRange, ended,
+                    [&](LAddress::L2Type nbId) {
+                        auto inserted = current.insert(nbId);
+                        if (inserted.second) inserted.first->startTime = now;
+                        inserted.first->lastSeen = now;
+                    },
+                    [&](LAddress::L2Type nbId) {
+                        const Contact* contact = current.find(nbId);
+                        REQUIRE(contact);
+                        endedContacts.emplace_back(nbId, contact->startTime, contact->lastSeen, now);
+                        current.erase(nbId);
+                    });
+                numContacts.push_back(current.size());
+            }
+
+            THEN("contacts start at the first step in range and end at the first step out of range")
+            {
+                REQUIRE(endedContacts.size() == 3);
+                REQUIRE(endedContacts[0] == EndedContact(3, 0, 2, 3));
+                REQUIRE(endedContacts[1] == EndedContact(2, 4, 8, 9));
+                REQUIRE(endedContacts[2] == EndedContact(3, 5, 8, 9));
+            }
+
+            THEN("contacts ending at the same step end in ascending order of the neighbors' addresses")
+            {
+                REQUIRE(std::get<0>(endedContacts[1]) < std::get<0>(endedContacts[2]));
+            }
+
+            THEN("the number of current contacts follows the trace")
+            {
+                REQUIRE(numContacts == std::vector<size_t>({1, 1, 1, 0, 1, 2, 2, 2, 2, 0}));
+            }
+        }
+    }
+}
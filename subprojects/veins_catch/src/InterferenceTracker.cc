@@ -0,0 +1,148 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+
+
+#include "catch2/catch.hpp"
+
+#include "veins/base/phyLayer/InterferenceTracker.h"
+#include "veins/base/toolbox/Signal.h"
+#include "veins/base/toolbox/Spectrum.h"
+
+using namespace veins;
+
+namespace {
+
+Signal makeSignal(const Spectrum& spectrum, double power, simtime_t start, simtime_t duration)
+{
+    Signal signal(spectrum, start, duration);
+    for (size_t i = 0; i < signal.getNumValues(); ++i) {
+        signal.at(i) = power * (i + 1);
+    }
+    signal.setDataStart(0);
+    signal.setDataNumValues(signal.getNumValues());
+    return signal;
+}
+
+} // namespace
+
+SCENARIO("InterferenceTracker", "[phyLayer]")
+{
+    GIVEN("A tracker and three overlapping signals")
+    {
+        Spectrum spectrum({5.89e9, 5.90e9, 5.91e9});
+        InterferenceTracker tracker;
+
+        // a: [0, 10), b: [2, 4), c: [6, 12)
+        Signal a = makeSignal(spectrum, 1, 0, 10);
+        Signal b = makeSignal(spectrum, 10, 2, 2);
+        Signal c = makeSignal(spectrum, 100, 6, 6);
+
+        tracker.addSignal(&a, 0);
+        tracker.addSignal(&b, 2);
+        tracker.removeSignal(&b, 4);
+        tracker.addSignal(&c, 6);
+
+        THEN("the current power is the sum of the active signals")
+        {
+            REQUIRE_FALSE(tracker.isChannelEmpty());
+            REQUIRE(tracker.isActive(&a));
+            REQUIRE_FALSE(tracker.isActive(&b));
+            REQUIRE(tracker.getPowerAt(0) == Approx(101));
+            REQUIRE(tracker.getPowerAt(2) == Approx(303));
+            REQUIRE(tracker.getPowerAt(1, &c) == Approx(2));
+            REQUIRE(tracker.getPowerAt(1, &b) == Approx(202));
+        }
+
+        THEN("the maximum interference covers exactly the signals overlapping the interval")
+        {
+            Signal whole = tracker.getMaxInterference(&a, 0, 10);
+            REQUIRE(whole.at(0) == Approx(100));
+            REQUIRE(whole.at(2) == Approx(300));
+
+            Signal early = tracker.getMaxInterference(&a, 1, 6);
+            REQUIRE(early.at(0) == Approx(10));
+
+            Signal late = tracker.getMaxInterference(&a, 3, 6);
+            REQUIRE(late.at(0) == Approx(10));
+
+            Signal gap = tracker.getMaxInterference(&a, 4, 6);
+            REQUIRE(gap.at(0) == Approx(0).margin(1e-12));
+        }
+
+        THEN("the minimum SINR uses the maximum interference plus noise")
+        {
+            REQUIRE(tracker.getMinSINR(&a, 0, 10, 1) == Approx(1.0 / 101));
+            REQUIRE(tracker.getMinSINR(&c, 6, 12, 1) == Approx(100.0 / 2));
+        }
+
+        WHEN("the earliest signal ends")
+        {
+            tracker.removeSignal(&a, 10);
+
+            THEN("totals from before the start of the remaining signal are dropped")
+            {
+                REQUIRE(tracker.getHistorySize() == 2);
+                REQUIRE(tracker.getMinSINR(&c, 6, 12, 1) == Approx(100.0 / 2));
+                REQUIRE(tracker.getMinSINR(&c, 10, 12, 1) == Approx(100.0 / 1));
+            }
+
+            AND_WHEN("the last signal ends")
+            {
+                tracker.removeSignal(&c, 12);
+
+                THEN("the channel is empty")
+                {
+                    REQUIRE(tracker.isChannelEmpty());
+                    REQUIRE(tracker.getHistorySize() == 0);
+                    REQUIRE(tracker.getPowerAt(0) == 0);
+                }
+            }
+        }
+    }
+
+    GIVEN("Signals starting and ending at the same time")
+    {
+        Spectrum spectrum({5.9e9});
+        InterferenceTracker tracker;
+        Signal a = makeSignal(spectrum, 1, 0, 5);
+        Signal b = makeSignal(spectrum, 2, 5, 5);
+        Signal c = makeSignal(spectrum, 4, 0, 10);
+
+        tracker.addSignal(&a, 0);
+        tracker.addSignal(&c, 0);
+        tracker.removeSignal(&a, 5);
+        tracker.addSignal(&b, 5);
+
+        THEN("only one total is recorded per point in time")
+        {
+            REQUIRE(tracker.getHistorySize() == 2);
+        }
+
+        THEN("a signal ending when another starts does not interfere with it")
+        {
+            REQUIRE(tracker.getMaxInterference(&b, 5, 10).at(0) == Approx(4));
+            REQUIRE(tracker.getMaxInterference(&c, 0, 10).at(0) == Approx(2));
+        }
+    }
+}
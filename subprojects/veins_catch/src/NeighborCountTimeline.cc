@@ -0,0 +1,124 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/utility/NeighborCountTimeline.h"
+
+using veins::NeighborCountTimeline;
+using veins::PerSecondAggregate;
+
+SCENARIO("NeighborCountTimeline", "[timeline]")
+{
+
+    GIVEN("A timeline started at 2.5s without neighbors")
+    {
+        NeighborCountTimeline t;
+        t.start(2.5);
+        PerSecondAggregate a;
+
+        THEN("its first sample is at 3s")
+        {
+            REQUIRE(t.getFirstSecond() == 3);
+            REQUIRE(t.getNumRuns() == 1);
+        }
+
+        WHEN("the count changes at 3.2s, 4.1s, 4.7s and 7s")
+        {
+            t.set(3.2, 1);
+            t.set(4.1, 3);
+            t.set(4.7, 2);
+            t.set(7, 0);
+            t.mergeInto(a, 8.9);
+
+            THEN("every second samples the count in effect at that second")
+            {
+                REQUIRE(a.getNumSeconds() == 9);
+                REQUIRE(a.getCount(2) == 0);
+                int expected[] = {0, 1, 2, 2, 0, 0};
+                for (int s = 3; s <= 8; s++) {
+                    REQUIRE(a.getCount(s) == 1);
+                    REQUIRE(a.getSum(s) == expected[s - 3]);
+                }
+            }
+
+            THEN("changes between two samples only keep the last value")
+            {
+                REQUIRE(t.getNumRuns() == 4);
+            }
+        }
+
+        WHEN("the count changes and changes back before the next sample")
+        {
+            t.set(3.2, 1);
+            t.set(4.1, 2);
+            t.set(4.9, 1);
+            t.mergeInto(a, 5);
+
+            THEN("the runs are merged")
+            {
+                REQUIRE(t.getNumRuns() == 2);
+                REQUIRE(a.getSum(4) == 1);
+                REQUIRE(a.getSum(5) == 1);
+            }
+        }
+
+        WHEN("it ends before its first sample")
+        {
+            t.set(2.7, 4);
+            t.mergeInto(a, 2.9);
+
+            THEN("nothing is aggregated")
+            {
+                REQUIRE(a.getNumSeconds() == 0);
+            }
+        }
+    }
+
+    GIVEN("Timelines of two overlapping nodes")
+    {
+        NeighborCountTimeline first;
+        NeighborCountTimeline second;
+        PerSecondAggregate a;
+
+        first.start(0, 2);
+        first.set(2, 5);
+        second.start(1, 1);
+        first.mergeInto(a, 3);
+        second.mergeInto(a, 2);
+
+        THEN("count, sum, min and max are aggregated per second")
+        {
+            REQUIRE(a.getNumSeconds() == 4);
+            REQUIRE(a.getCount(0) == 1);
+            REQUIRE(a.getCount(1) == 2);
+            REQUIRE(a.getCount(2) == 2);
+            REQUIRE(a.getCount(3) == 1);
+            REQUIRE(a.getMin(1) == 1);
+            REQUIRE(a.getMax(1) == 2);
+            REQUIRE(a.getMin(2) == 1);
+            REQUIRE(a.getMax(2) == 5);
+            REQUIRE(a.getMean(2) == 3);
+            REQUIRE(a.getSum(3) == 5);
+        }
+    }
+}
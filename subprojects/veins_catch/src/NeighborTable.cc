@@ -0,0 +1,134 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "catch2/catch.hpp"
+
+#include <map>
+#include <random>
+
+#include "veins/modules/utility/NeighborTable.h"
+
+using veins::NeighborTable;
+
+namespace {
+
+struct Details {
+    long nbId;
+    double lastSeen;
+};
+
+} // namespace
+
+SCENARIO("NeighborTable", "[neighbortable]")
+{
+
+    GIVEN("An empty table")
+    {
+        NeighborTable<Details> t;
+
+        THEN("it finds nothing")
+        {
+            REQUIRE(t.size() == 0);
+            REQUIRE(t.empty());
+            REQUIRE(t.find(7) == nullptr);
+            REQUIRE_FALSE(t.erase(7));
+            REQUIRE(t.begin() == t.end());
+        }
+
+        WHEN("a neighbor is inserted")
+        {
+            std::pair<Details*, bool> inserted = t.insert(7);
+            inserted.first->nbId = 7;
+            inserted.first->lastSeen = 1.5;
+
+            THEN("it is found and updated in place")
+            {
+                REQUIRE(inserted.second);
+                REQUIRE(t.size() == 1);
+                REQUIRE(t.contains(7));
+                REQUIRE(t.find(7)->lastSeen == 1.5);
+
+                std::pair<Details*, bool> again = t.insert(7);
+                REQUIRE_FALSE(again.second);
+                REQUIRE(again.first == inserted.first);
+                again.first->lastSeen = 2.5;
+                REQUIRE(t.find(7)->lastSeen == 2.5);
+                REQUIRE(t.size() == 1);
+            }
+
+            THEN("erasing it empties the table, and re-inserting it yields a fresh value")
+            {
+                REQUIRE(t.erase(7));
+                REQUIRE(t.empty());
+                REQUIRE(t.find(7) == nullptr);
+                REQUIRE(t.insert(7).first->lastSeen == 0);
+            }
+        }
+    }
+
+    GIVEN("A table with many random insertions and erasures")
+    {
+        NeighborTable<Details> t;
+        std::map<long, double> reference;
+        std::mt19937 rng(42);
+
+        for (int i = 0; i < 20000; i++) {
+            long id = std::uniform_int_distribution<long>(0, 300)(rng) * 16; // clustered keys stress the probe sequences
+            if (rng() % 3 == 0) {
+                REQUIRE(t.erase(id) == (reference.erase(id) == 1));
+            }
+            else {
+                Details& d = *t.insert(id).first;
+                d.nbId = id;
+                d.lastSeen = i;
+                reference[id] = i;
+            }
+        }
+
+        THEN("it holds the same neighbors as a std::map")
+        {
+            REQUIRE(t.size() == reference.size());
+            for (auto& entry : reference) {
+                const Details* d = t.find(entry.first);
+                REQUIRE(d != nullptr);
+                REQUIRE(d->nbId == entry.first);
+                REQUIRE(d->lastSeen == entry.second);
+            }
+
+            size_t visited = 0;
+            for (auto& entry : t) {
+                REQUIRE(reference.count(entry.key) == 1);
+                REQUIRE(entry.value.nbId == entry.key);
+                visited++;
+            }
+            REQUIRE(visited == reference.size());
+        }
+
+        THEN("clearing it removes all neighbors")
+        {
+            t.clear();
+            REQUIRE(t.empty());
+            REQUIRE(t.find(reference.begin()->first) == nullptr);
+        }
+    }
+}
@@ -0,0 +1,171 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+#include <memory>
+
+#include "veins/base/connectionManager/NicEntry.h"
+#include "testutils/Simulation.h"
+#include "testutils/Component.h"
+
+using namespace veins;
+
+namespace {
+
+using GateList = NicEntry::GateList;
+
+class TestNicEntry : public NicEntry {
+public:
+    TestNicEntry(cComponent* owner, int nicId)
+        : NicEntry(owner)
+    {
+        this->nicId = nicId;
+        module.addGate("radioIn", cGate::INPUT);
+    }
+
+    void connectTo(NicEntry*) override
+    {
+    }
+
+    void disconnectFrom(NicEntry*) override
+    {
+    }
+
+    GateList::Entry entry()
+    {
+        return GateList::Entry(this, module.gate("radioIn"));
+    }
+
+private:
+    cModule module;
+};
+
+std::vector<int> nicIds(const GateList& gateList)
+{
+    std::vector<int> ids;
+    for (const auto& entry : gateList) ids.push_back(entry.nic->nicId);
+    return ids;
+}
+
+} // namespace
+
+SCENARIO("NicEntry::GateList batched updates", "[connectionManager]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    DummyComponent owner(&ds);
+
+    std::vector<std::unique_ptr<TestNicEntry>> nics;
+    for (int nicId = 0; nicId < 10; nicId++) nics.emplace_back(new TestNicEntry(&owner, nicId));
+
+    GIVEN("A gate list connected to nics 1, 4 and 7")
+    {
+        GateList gateList;
+        gateList.insert({nics[1]->entry(), nics[4]->entry(), nics[7]->entry()});
+        REQUIRE(nicIds(gateList) == std::vector<int>({1, 4, 7}));
+
+        WHEN("nics before, between and after the connected ones are added")
+        {
+            gateList.insert({nics[0]->entry(), nics[2]->entry(), nics[3]->entry(), nics[5]->entry(), nics[9]->entry()});
+
+            THEN("the gate list stays sorted by nicId and keeps all connections")
+            {
+                REQUIRE(nicIds(gateList) == std::vector<int>({0, 1, 2, 3, 4, 5, 7, 9}));
+                for (const auto& entry : gateList) {
+                    REQUIRE(gateList.find(entry.nic) == &entry);
+                }
+            }
+        }
+
+        WHEN("nothing is added")
+        {
+            gateList.insert(std::vector<GateList::Entry>());
+
+            THEN("the gate list is unchanged")
+            {
+                REQUIRE(nicIds(gateList) == std::vector<int>({1, 4, 7}));
+            }
+        }
+
+        WHEN("an already connected nic is added")
+        {
+            THEN("the batch is rejected and the gate list is unchanged")
+            {
+                REQUIRE_THROWS_AS(gateList.insert({nics[2]->entry(), nics[4]->entry()}), cRuntimeError);
+                REQUIRE(nicIds(gateList) == std::vector<int>({1, 4, 7}));
+            }
+        }
+
+        WHEN("a nic is added twice in the same batch")
+        {
+            THEN("the batch is rejected and the gate list is unchanged")
+            {
+                REQUIRE_THROWS_AS(gateList.insert({nics[2]->entry(), nics[2]->entry()}), cRuntimeError);
+                REQUIRE(nicIds(gateList) == std::vector<int>({1, 4, 7}));
+            }
+        }
+
+        WHEN("an unsorted batch is added")
+        {
+            THEN("the batch is rejected and the gate list is unchanged")
+            {
+                REQUIRE_THROWS_AS(gateList.insert({nics[5]->entry(), nics[2]->entry()}), cRuntimeError);
+                REQUIRE(nicIds(gateList) == std::vector<int>({1, 4, 7}));
+            }
+        }
+
+        WHEN("connected and absent nics are removed")
+        {
+            gateList.erase(std::vector<NicEntry*>({nics[0].get(), nics[1].get(), nics[5].get(), nics[7].get(), nics[8].get()}));
+
+            THEN("only the connected ones are gone")
+            {
+                REQUIRE(nicIds(gateList) == std::vector<int>({4}));
+                REQUIRE(gateList.find(nics[1].get()) == nullptr);
+                REQUIRE(gateList.find(nics[4].get()) != nullptr);
+            }
+        }
+
+        WHEN("only absent nics are removed")
+        {
+            gateList.erase(std::vector<NicEntry*>({nics[0].get(), nics[2].get(), nics[9].get()}));
+
+            THEN("the gate list is unchanged")
+            {
+                REQUIRE(nicIds(gateList) == std::vector<int>({1, 4, 7}));
+            }
+        }
+
+        WHEN("all nics are removed")
+        {
+            std::vector<NicEntry*> all;
+            for (auto& nic : nics) all.push_back(nic.get());
+            gateList.erase(all);
+
+            THEN("the gate list is empty")
+            {
+                REQUIRE(gateList.empty());
+            }
+        }
+    }
+}
@@ -0,0 +1,290 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+#include <random>
+
+#include "veins/base/connectionManager/NicGrid.h"
+
+using veins::Coord;
+using veins::NicGrid;
+
+namespace {
+
+std::vector<int> neighborCells(const NicGrid& grid, int cell)
+{
+    NicGrid::CellSet set;
+    grid.addNeighborCells(cell, set);
+    std::vector<int> result;
+    for (size_t i = 0; i < set.size(); i++) result.push_back(set[i]);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// every pair of nics within the reach has to be found in the neighborhood of the cell of either nic
+void requireNeighborsFound(const NicGrid& grid, const std::vector<int>& slots, double reach)
+{
+    for (int slot : slots) {
+        std::vector<int> cells = neighborCells(grid, grid.getCell(slot));
+        for (int other : slots) {
+            if (grid.sqrDist(slot, other) > reach * reach) continue;
+            REQUIRE(std::binary_search(cells.begin(), cells.end(), grid.getCell(other)));
+        }
+    }
+}
+
+} // namespace
+
+SCENARIO("NicGrid", "[connectionManager]")
+{
+
+    GIVEN("A 1000m x 500m playground with cells of at least 100m")
+    {
+        NicGrid grid;
+        grid.configure(Coord(1000, 500, 0), 100, false);
+
+        THEN("it has 10 x 5 x 1 cells")
+        {
+            REQUIRE(grid.getDimX() == 10);
+            REQUIRE(grid.getDimY() == 5);
+            REQUIRE(grid.getDimZ() == 1);
+            REQUIRE(grid.getCellForCoordinate(Coord(0, 0, 0)) == 0);
+            REQUIRE(grid.getCellForCoordinate(Coord(1000, 500, 0)) == 49);
+        }
+
+        THEN("corner cells have 4 neighbors (including themselves), inner cells 9")
+        {
+            REQUIRE(neighborCells(grid, 0) == std::vector<int>({0, 1, 10, 11}));
+            REQUIRE(neighborCells(grid, grid.getCellForCoordinate(Coord(550, 250, 0))).size() == 9);
+        }
+
+        WHEN("nics are inserted, moved and removed")
+        {
+            int a = grid.insert(1, Coord(50, 50, 0));
+            int b = grid.insert(2, Coord(60, 50, 0));
+            int c = grid.insert(3, Coord(70, 50, 0));
+            grid.move(a, Coord(950, 450, 0));
+            grid.remove(b);
+            int d = grid.insert(4, Coord(80, 50, 0));
+
+            THEN("cells and positions are kept up to date")
+            {
+                REQUIRE(grid.size() == 3);
+                REQUIRE(d == b);
+                REQUIRE(grid.getNicId(d) == 4);
+                REQUIRE(grid.getCell(a) == 49);
+                REQUIRE(grid.getCellSlots(49) == std::vector<int>({a}));
+                std::vector<int> cell0 = grid.getCellSlots(0);
+                std::sort(cell0.begin(), cell0.end());
+                REQUIRE(cell0 == std::vector<int>({std::min(c, d), std::max(c, d)}));
+                REQUIRE(grid.sqrDist(c, d) == Approx(100));
+            }
+        }
+    }
+
+    GIVEN("Nics in the cells of a 1000m x 1000m playground")
+    {
+        NicGrid grid;
+        grid.configure(Coord(1000, 1000, 0), 100, false);
+        int a = grid.insert(1, Coord(50, 50, 0));
+        int b = grid.insert(2, Coord(150, 150, 0));
+        int c = grid.insert(3, Coord(250, 50, 0));
+        int d = grid.insert(4, Coord(950, 50, 0));
+
+        THEN("spatial keys follow a Z-order curve over the cells")
+        {
+            REQUIRE(grid.getSpatialKey(a) == 0);
+            REQUIRE(grid.getSpatialKey(b) == 3);
+            REQUIRE(grid.getSpatialKey(c) == 8);
+            // the 2x2 block of cells around b comes before the next cell of the first row
+            REQUIRE(grid.getSpatialKey(b) < grid.getSpatialKey(c));
+            REQUIRE(grid.getSpatialKey(c) < grid.getSpatialKey(d));
+        }
+    }
+
+    GIVEN("A torus playground of 1000m x 1000m with cells of at least 100m")
+    {
+        NicGrid grid;
+        grid.configure(Coord(1000, 1000, 0), 100, true);
+
+        THEN("corner cells wrap around")
+        {
+            REQUIRE(neighborCells(grid, 0) == std::vector<int>({0, 1, 9, 10, 11, 19, 90, 91, 99}));
+        }
+
+        THEN("distances are measured along the torus")
+        {
+            int a = grid.insert(1, Coord(10, 10, 0));
+            int b = grid.insert(2, Coord(990, 10, 0));
+            REQUIRE(grid.sqrDist(a, b) == Approx(400));
+        }
+    }
+
+    GIVEN("A playground of at most 3 x 3 cells")
+    {
+        NicGrid grid;
+        grid.configure(Coord(300, 300, 0), 100, false);
+
+        THEN("it is reduced to a single cell")
+        {
+            REQUIRE(grid.getDimX() == 1);
+            REQUIRE(grid.getDimY() == 1);
+            REQUIRE(grid.getCellForCoordinate(Coord(300, 300, 0)) == 0);
+            REQUIRE(neighborCells(grid, 0) == std::vector<int>({0}));
+        }
+    }
+
+    GIVEN("Many random movements")
+    {
+        NicGrid grid;
+        grid.configure(Coord(2000, 2000, 0), 100, false);
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<double> coord(0, 2000);
+
+        std::vector<int> slots;
+        std::vector<Coord> positions;
+        for (int i = 0; i < 200; i++) {
+            positions.push_back(Coord(coord(rng), coord(rng), 0));
+            slots.push_back(grid.insert(i, positions.back()));
+        }
+        for (int step = 0; step < 5000; step++) {
+            size_t i = rng() % slots.size();
+            positions[i] = Coord(coord(rng), coord(rng), 0);
+            grid.move(slots[i], positions[i]);
+        }
+
+        THEN("every nic is in exactly the cell of its position")
+        {
+            size_t total = 0;
+            for (int cell = 0; cell < grid.getDimX() * grid.getDimY(); cell++) {
+                for (int slot : grid.getCellSlots(cell)) {
+                    REQUIRE(grid.getCell(slot) == cell);
+                    REQUIRE(grid.getCellForCoordinate(positions[grid.getNicId(slot)]) == cell);
+                }
+                total += grid.getCellSlots(cell).size();
+            }
+            REQUIRE(total == slots.size());
+        }
+    }
+
+    GIVEN("A 2000m x 2000m playground with cells of a quarter of the reach of 400m")
+    {
+        NicGrid grid;
+        grid.configure(Coord(2000, 2000, 0), 400, false, 0.25);
+
+        THEN("neighborhoods follow the disk around a cell")
+        {
+            REQUIRE(grid.getDimX() == 20);
+            int cell = grid.getCellForCoordinate(Coord(1050, 1050, 0));
+            std::vector<int> cells = neighborCells(grid, cell);
+            // cells at offset 4 are 3 cells away, but not the corners
+            REQUIRE(cells.size() < 9 * 9);
+            REQUIRE(std::binary_search(cells.begin(), cells.end(), cell + 4));
+            REQUIRE(std::binary_search(cells.begin(), cells.end(), cell + 3 + 3 * 20));
+            REQUIRE_FALSE(std::binary_search(cells.begin(), cells.end(), cell + 4 + 4 * 20));
+            REQUIRE_FALSE(std::binary_search(cells.begin(), cells.end(), cell + 5));
+        }
+
+        THEN("nics outside of a neighborhood are beyond the reach")
+        {
+            REQUIRE(grid.getMinOutsideDistance() >= 400);
+            REQUIRE(grid.getMinOutsideDistance() < 500);
+        }
+    }
+
+    GIVEN("Random nics on torus and subdivided playgrounds")
+    {
+        std::mt19937 rng(2);
+        std::uniform_real_distribution<double> coord(0, 2000);
+        std::normal_distribution<double> cluster(500, 30);
+
+        for (bool useTorus : {false, true}) {
+            for (int subdivisions : {1, 4}) {
+                NicGrid grid;
+                grid.configure(Coord(2000, 2000, 0), 300, useTorus, 0.5);
+                grid.configureSubdivision(subdivisions, 16);
+
+                // a dense cluster and sparse nics elsewhere
+                std::vector<int> slots;
+                for (int i = 0; i < 300; i++) {
+                    Coord pos = i < 100 ? Coord(coord(rng), coord(rng), 0) : Coord(cluster(rng), cluster(rng), 0);
+                    slots.push_back(grid.insert(i, pos));
+                }
+                requireNeighborsFound(grid, slots, 300);
+                if (subdivisions > 1) REQUIRE(grid.getNumSubdividedCells() > 0);
+
+                // disperse the cluster
+                for (int slot : slots) {
+                    grid.move(slot, Coord(coord(rng), coord(rng), 0));
+                    grid.rebalance();
+                }
+                requireNeighborsFound(grid, slots, 300);
+
+                size_t total = 0;
+                for (int cell = 0; cell < grid.getNumCells(); cell++) {
+                    for (int slot : grid.getCellSlots(cell)) {
+                        REQUIRE(grid.getCell(slot) == cell);
+                    }
+                    total += grid.getCellSlots(cell).size();
+                }
+                REQUIRE(total == slots.size());
+            }
+        }
+    }
+
+    GIVEN("A subdivided cell")
+    {
+        NicGrid grid;
+        grid.configure(Coord(2000, 2000, 0), 500, false);
+        grid.configureSubdivision(4, 2);
+        int a = grid.insert(1, Coord(10, 10, 0));
+        int b = grid.insert(2, Coord(20, 10, 0));
+        int c = grid.insert(3, Coord(480, 480, 0));
+
+        THEN("its nics are in sub-cells numbered after the coarse cells")
+        {
+            REQUIRE(grid.getNumSubdividedCells() == 1);
+            REQUIRE(grid.getCell(a) >= grid.getDimX() * grid.getDimY());
+            REQUIRE(grid.getCell(a) == grid.getCell(b));
+            REQUIRE(grid.getCell(a) != grid.getCell(c));
+            REQUIRE(grid.getCellSlots(0).empty());
+            REQUIRE(grid.getMinOutsideDistance() == Approx(500));
+        }
+
+        WHEN("it becomes sparse")
+        {
+            grid.remove(b);
+            grid.remove(c);
+            grid.rebalance();
+
+            THEN("it is merged again")
+            {
+                REQUIRE(grid.getNumSubdividedCells() == 0);
+                REQUIRE(grid.getCell(a) == 0);
+                REQUIRE(grid.getCellSlots(0) == std::vector<int>({a}));
+            }
+        }
+    }
+}
@@ -0,0 +1,127 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "veins/modules/phy/NistErrorRate.h"
+#include "veins/modules/phy/NistErrorRateTable.h"
+
+using namespace veins;
+
+namespace {
+
+const std::vector<MCS> allMcs = {MCS::ofdm_bpsk_r_1_2, MCS::ofdm_bpsk_r_3_4, MCS::ofdm_qpsk_r_1_2, MCS::ofdm_qpsk_r_3_4, MCS::ofdm_qam16_r_1_2, MCS::ofdm_qam16_r_3_4, MCS::ofdm_qam64_r_2_3, MCS::ofdm_qam64_r_3_4};
+
+const std::vector<unsigned int> allDatarates = {3000000, 4500000, 6000000, 9000000, 12000000, 18000000, 24000000, 27000000};
+
+double dB2ratio(double dB)
+{
+    return std::pow(10, dB / 10);
+}
+
+} // namespace
+
+SCENARIO("NistErrorRateTable", "[phy]")
+{
+    GIVEN("The precomputed tables")
+    {
+        const NistErrorRateTable& table = NistErrorRateTable::getInstance();
+
+        THEN("only few intervals fall back to the analytic model")
+        {
+            REQUIRE(table.getNumExactIntervals() > 0);
+            REQUIRE(table.getNumExactIntervals() < 200);
+        }
+
+        THEN("looked up success rates match the analytic model within the guaranteed error")
+        {
+            for (size_t i = 0; i < allDatarates.size(); ++i) {
+                for (uint32_t nbits : {1u, 24u, 100u, 1000u, 10000u, 65536u}) {
+                    double maxError = 0;
+                    for (double snr_dB = -5; snr_dB < 40; snr_dB += 0.0013) {
+                        double exact = NistErrorRate::getChunkSuccessRate(allDatarates[i], Bandwidth::ofdm_10_mhz, dB2ratio(snr_dB), nbits);
+                        double tabulated = table.getChunkSuccessRate(allDatarates[i], Bandwidth::ofdm_10_mhz, dB2ratio(snr_dB), nbits);
+                        maxError = std::max(maxError, std::abs(exact - tabulated));
+                    }
+                    INFO("datarate " << allDatarates[i] << ", " << nbits << " bits");
+                    REQUIRE(maxError <= NistErrorRateTable::maxError);
+                }
+            }
+        }
+
+        THEN("looked up success rates rise with the SNR")
+        {
+            for (auto mcs : allMcs) {
+                double previous = 0;
+                for (double snr_dB = -5; snr_dB < 40; snr_dB += 0.0013) {
+                    double tabulated = table.getChunkSuccessRate(mcs, dB2ratio(snr_dB), 1000);
+                    REQUIRE(tabulated >= previous - 1e-12);
+                    previous = tabulated;
+                }
+            }
+        }
+
+        THEN("the analytic model is used outside of the tables")
+        {
+            for (auto mcs : allMcs) {
+                REQUIRE(table.getChunkSuccessRate(mcs, 0, 100) == 0);
+                REQUIRE(table.getChunkSuccessRate(mcs, dB2ratio(60), 100) == 1);
+                REQUIRE(table.getChunkSuccessRate(mcs, dB2ratio(60), 0) == 1);
+                REQUIRE(table.getChunkSuccessRate(mcs, std::numeric_limits<double>::infinity(), 100) == 1);
+            }
+            double exact = NistErrorRate::getChunkSuccessRate(3000000, Bandwidth::ofdm_10_mhz, dB2ratio(2), 100000);
+            REQUIRE(table.getChunkSuccessRate(MCS::ofdm_bpsk_r_1_2, dB2ratio(2), 100000) == exact);
+        }
+    }
+}
+
+TEST_CASE("NistErrorRateTable benchmark", "[.][benchmark]")
+{
+    const NistErrorRateTable& table = NistErrorRateTable::getInstance();
+    std::vector<double> snrs;
+    for (double snr_dB = 0; snr_dB < 30; snr_dB += 0.01) {
+        snrs.push_back(dB2ratio(snr_dB));
+    }
+
+    double sum = 0;
+    BENCHMARK("analytic model")
+    {
+        for (double snr : snrs) {
+            sum += NistErrorRate::getChunkSuccessRate(6000000, Bandwidth::ofdm_10_mhz, snr, 2000);
+        }
+    }
+    BENCHMARK("precomputed tables")
+    {
+        for (double snr : snrs) {
+            sum += table.getChunkSuccessRate(6000000, Bandwidth::ofdm_10_mhz, snr, 2000);
+        }
+    }
+    REQUIRE(sum > 0);
+}
@@ -0,0 +1,128 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+// the results command of veins_logtool is not part of the veins library, so it is compiled into this test
+#include "../../veins_tools/src/ProcessResults.cc"
+
+namespace {
+
+void writeFile(const std::string& path, const std::string& content)
+{
+    std::ofstream out(path, std::ios::binary);
+    out << content;
+}
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+} // namespace
+
+SCENARIO("veins_logtool results rounds like Python", "[logtool]")
+{
+    THEN("halfway cases are rounded to even")
+    {
+        REQUIRE(roundHalfEven(0.5) == 0);
+        REQUIRE(roundHalfEven(1.5) == 2);
+        REQUIRE(roundHalfEven(2.5) == 2);
+        REQUIRE(roundHalfEven(3.5) == 4);
+        REQUIRE(roundHalfEven(2.4999) == 2);
+        REQUIRE(roundHalfEven(2.5001) == 3);
+    }
+}
+
+SCENARIO("veins_logtool results", "[logtool]")
+{
+    const std::string contactsPath = "ProcessResultsTest-indvContactDurationLog.csv";
+    const std::string perSecondPath = "ProcessResultsTest-perSecondNumVehiclesAndNumAvgNbs.csv";
+
+    GIVEN("A contact duration log and a per-second log of two seeds")
+    {
+        // seed 1: vehicle 1 has a mean contact duration of 2.5 s, vehicle 2 of 3.5 s, vehicle 3 of 4 s, vehicle 4 of 0.5 s
+        // seed 2: vehicle 1 (a different vehicle than vehicle 1 of seed 1) has a mean contact duration of 6 s
+        writeFile(contactsPath,
+            "seed,scenario,maxSpeed,txPower,myId,nbId,startTime,endTime,contactDuration,datetime\n"
+            "1,S,33.33,0.2,1,2,0,2,2,x\n"
+            "1,S,33.33,0.2,2,1,0,3,3,x\n"
+            "1,S,33.33,0.2,3,1,0,4,4,x\n"
+            "1,S,33.33,0.2,4,3,1,1.5,0.5,x\n"
+            "1,S,33.33,0.2,2,3,5,9,4,x\n"
+            "1,S,33.33,0.2,1,3,10,13,3,x\n"
+            "2,S,33.33,0.2,1,5,0,6,6,x\n");
+        writeFile(perSecondPath,
+            "seed,scenario,totalVehicles,maxSpeed,txPower,simTime,numVehicles,numAvgNbs,datetime\n"
+            "1,S,10,33.33,0.2,0,2,1,x\n"
+            "1,S,10,33.33,0.2,1,3,1.5,x\n"
+            "2,S,10,33.33,0.2,0,4,2,x\n");
+
+        WHEN("processing them with minimum contact durations of 0 s and 3 s")
+        {
+            REQUIRE(veins_logtool::processResults({"-j", "2", "-t", "0,3", ".", contactsPath, perSecondPath}) == 0);
+
+            THEN("the mean contact durations of the vehicles of each seed are rounded half to even and counted")
+            {
+                REQUIRE(readFile("contactDurationDistribution.csv") ==
+                    "scenario,txPower,minContactDuration,contactDuration,numVehicles,percentVehicles,cumPercentVehiclesLessOrEqual,cumPercentVehiclesMoreOrEqual\n"
+                    "S,0.2,0,0,1,20,20,100\n"
+                    "S,0.2,0,2,1,20,40,80\n"
+                    "S,0.2,0,4,2,40,80,60\n"
+                    "S,0.2,0,6,1,20,100,20\n"
+                    "S,0.2,3,3,1,25,25,100\n"
+                    "S,0.2,3,4,2,50,75,75\n"
+                    "S,0.2,3,6,1,25,100,25\n");
+            }
+
+            THEN("the mean times between two new neighbors are counted for vehicles with at least two contacts")
+            {
+                REQUIRE(readFile("meetingTimeDistribution.csv") ==
+                    "scenario,txPower,minContactDuration,meetingTime,numVehicles,percentVehicles,cumPercentVehiclesLessOrEqual,cumPercentVehiclesMoreOrEqual\n"
+                    "S,0.2,0,5,1,50,50,100\n"
+                    "S,0.2,0,10,1,50,100,50\n"
+                    "S,0.2,3,5,1,100,100,100\n");
+            }
+
+            THEN("the per-second values are averaged over the seeds")
+            {
+                REQUIRE(readFile("perSecondNumVehiclesAndNumNbs.csv") ==
+                    "scenario,txPower,simTime,numRuns,meanNumVehicles,meanNumAvgNbs,meanNbDegree\n"
+                    "S,0.2,0,2,3,1.5,\n"
+                    "S,0.2,1,1,3,1.5,\n");
+            }
+        }
+    }
+
+    std::remove(contactsPath.c_str());
+    std::remove(perSecondPath.c_str());
+    std::remove("contactDurationDistribution.csv");
+    std::remove("meetingTimeDistribution.csv");
+    std::remove("perSecondNumVehiclesAndNumNbs.csv");
+}
@@ -0,0 +1,99 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include <algorithm>
+
+#include "veins/modules/utility/QuantileSketch.h"
+
+using veins::QuantileSketch;
+
+SCENARIO("QuantileSketch", "[quantile]")
+{
+
+    GIVEN("An empty sketch")
+    {
+        QuantileSketch s;
+
+        THEN("it reports zero")
+        {
+            REQUIRE(s.getCount() == 0);
+            REQUIRE(s.getQuantile(0.5) == 0);
+        }
+    }
+
+    GIVEN("A sketch of few samples")
+    {
+        QuantileSketch s;
+        for (double v : {5.0, 1.0, 4.0, 2.0, 3.0}) s.collect(v);
+
+        THEN("quantiles are exact")
+        {
+            REQUIRE(s.getCount() == 5);
+            REQUIRE(s.getQuantile(0) == 1);
+            REQUIRE(s.getQuantile(0.5) == 3);
+            REQUIRE(s.getQuantile(0.9) == 5);
+            REQUIRE(s.getQuantile(1) == 5);
+        }
+    }
+
+    GIVEN("A sketch of a million shuffled samples 0..999999")
+    {
+        const int n = 1000000;
+        std::vector<double> values(n);
+        for (int i = 0; i < n; i++) values[i] = (i * 7919LL) % n; // a permutation, as 7919 is prime
+        QuantileSketch s;
+        for (double v : values) s.collect(v);
+
+        THEN("memory stays bounded and count, min and max are exact")
+        {
+            REQUIRE(s.getNumRetained() < 1000);
+            REQUIRE(s.getCount() == n);
+            REQUIRE(s.getMin() == 0);
+            REQUIRE(s.getMax() == n - 1);
+        }
+
+        THEN("the rank error of p50, p90 and p99 is within 2%")
+        {
+            for (double q : {0.5, 0.9, 0.99}) {
+                REQUIRE(std::abs(s.getQuantile(q) / n - q) < 0.02);
+            }
+        }
+
+        WHEN("merging it with a sketch of the samples n..2n-1")
+        {
+            QuantileSketch other;
+            for (double v : values) other.collect(v + n);
+            s.merge(other);
+
+            THEN("the quantiles are those of all samples")
+            {
+                REQUIRE(s.getCount() == 2 * n);
+                REQUIRE(s.getMax() == 2 * n - 1);
+                REQUIRE(std::abs(s.getQuantile(0.5) / (2 * n) - 0.5) < 0.02);
+                REQUIRE(std::abs(s.getQuantile(0.99) / (2 * n) - 0.99) < 0.02);
+                REQUIRE(s.getNumRetained() < 1000);
+            }
+        }
+    }
+}
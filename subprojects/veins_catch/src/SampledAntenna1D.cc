@@ -22,6 +22,8 @@
 
 #include "catch2/catch.hpp"
 
+#include <algorithm>
+
 #include "veins/modules/phy/SampledAntenna1D.h"
 #include "testutils/Simulation.h"
 #include "veins/base/utils/FWMath.h"
@@ -66,3 +68,40 @@ SCENARIO("Using SampledAntenna1D", "[toolbox]")
         }
     }
 }
+
+SCENARIO("SampledAntenna1D bounds its gain", "[toolbox]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
+
+    GIVEN("SampledAntenna1Ds with regular, irregular and flat patterns")
+    {
+        std::vector<std::vector<double>> patterns = {
+            {FWMath::mW2dBm(1), FWMath::mW2dBm(2), FWMath::mW2dBm(3), FWMath::mW2dBm(4)},
+            {3.1, -7.25, 0.5, 3.1000001, -20, 2.9, 3.0999999},
+            {-3, -3, -3},
+        };
+        std::string offsetType = "";
+        std::vector<double> offsetParams;
+        std::string rotationType = "";
+        std::vector<double> rotationParams;
+        cRNG* rng = nullptr;
+
+        THEN("getMaxGain is the largest sample, and getGain never exceeds it in any direction and orientation")
+        {
+            for (auto& values : patterns) {
+                double maxSample = *std::max_element(values.begin(), values.end());
+                auto p = SampledAntenna1D(values, offsetType, offsetParams, rotationType, rotationParams, rng);
+                REQUIRE(p.getMaxGain() == Approx(FWMath::dBm2mW(maxSample)));
+
+                for (double orientation = 0; orientation < 360; orientation += 30) {
+                    Coord ownOrient(cos(orientation * M_PI / 180), sin(orientation * M_PI / 180), 0);
+                    for (double angle = 0; angle < 360; angle += 0.25) {
+                        Coord otherPos(100 * cos(angle * M_PI / 180), 100 * sin(angle * M_PI / 180), 0);
+                        INFO("pattern with maximum " << maxSample << " dBm, orientation " << orientation << " deg, angle " << angle << " deg");
+                        REQUIRE(p.getGain(Coord(0, 0, 0), ownOrient, otherPos) <= p.getMaxGain());
+                    }
+                }
+            }
+        }
+    }
+}
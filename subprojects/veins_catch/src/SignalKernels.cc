@@ -0,0 +1,148 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+
+#include "catch2/catch.hpp"
+
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "veins/base/toolbox/SignalKernels.h"
+
+using namespace veins::SignalKernels;
+
+namespace {
+
+double reference(Operation op, double lhs, double rhs)
+{
+    switch (op) {
+    case Operation::add:
+        return lhs + rhs;
+    case Operation::subtract:
+        return lhs - rhs;
+    case Operation::multiply:
+        return lhs * rhs;
+    case Operation::divide:
+        return lhs / rhs;
+    }
+    return 0;
+}
+
+bool bitIdentical(const std::vector<double>& a, const std::vector<double>& b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+}
+
+} // namespace
+
+SCENARIO("SignalKernels", "[toolbox]")
+{
+    const InstructionSet defaultInstructionSet = getInstructionSet();
+    const std::vector<InstructionSet> allInstructionSets = {InstructionSet::scalar, InstructionSet::sse2, InstructionSet::avx};
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> power(-10, 10);
+    std::uniform_real_distribution<double> positivePower(1e-12, 1e-3);
+
+    GIVEN("Random values of every length up to 37, not aligned to vectors")
+    {
+        for (InstructionSet instructionSet : allInstructionSets) {
+            if (!isSupported(instructionSet)) continue;
+            setInstructionSet(instructionSet);
+            INFO("instruction set " << static_cast<int>(instructionSet));
+            for (size_t size = 0; size <= 37; size++) {
+                std::vector<double> lhs(size + 1), rhs(size + 1);
+                for (size_t i = 0; i <= size; i++) {
+                    lhs[i] = power(rng);
+                    rhs[i] = power(rng);
+                }
+
+                for (Operation op : {Operation::add, Operation::subtract, Operation::multiply, Operation::divide}) {
+                    std::vector<double> expected(size), result(size), expectedScalar(size), resultScalar(size);
+                    for (size_t i = 0; i < size; i++) {
+                        expected[i] = reference(op, lhs[i + 1], rhs[i + 1]);
+                        expectedScalar[i] = reference(op, lhs[i + 1], rhs[0]);
+                    }
+                    apply(op, lhs.data() + 1, rhs.data() + 1, result.data(), size);
+                    apply(op, lhs.data() + 1, rhs[0], resultScalar.data(), size);
+                    REQUIRE(bitIdentical(result, expected));
+                    REQUIRE(bitIdentical(resultScalar, expectedScalar));
+
+                    // in place
+                    std::vector<double> inPlace(lhs.begin() + 1, lhs.end());
+                    apply(op, inPlace.data(), rhs.data() + 1, inPlace.data(), size);
+                    REQUIRE(bitIdentical(inPlace, expected));
+                }
+
+                double expectedMin = std::numeric_limits<double>::infinity();
+                double expectedMax = -std::numeric_limits<double>::infinity();
+                for (size_t i = 1; i <= size; i++) {
+                    expectedMin = std::min(expectedMin, lhs[i]);
+                    expectedMax = std::max(expectedMax, lhs[i]);
+                }
+                REQUIRE(min(lhs.data() + 1, size) == expectedMin);
+                REQUIRE(max(lhs.data() + 1, size) == expectedMax);
+            }
+        }
+        setInstructionSet(defaultInstructionSet);
+    }
+
+    GIVEN("A signal, interference and noise")
+    {
+        for (InstructionSet instructionSet : allInstructionSets) {
+            if (!isSupported(instructionSet)) continue;
+            setInstructionSet(instructionSet);
+            INFO("instruction set " << static_cast<int>(instructionSet));
+            for (size_t size = 0; size <= 37; size++) {
+                std::vector<double> signal(size), interference(size);
+                for (size_t i = 0; i < size; i++) {
+                    signal[i] = positivePower(rng);
+                    interference[i] = positivePower(rng);
+                }
+                double noise = 1e-9;
+
+                double expected = std::numeric_limits<double>::infinity();
+                for (size_t i = 0; i < size; i++) expected = std::min(expected, signal[i] / (interference[i] + noise));
+                REQUIRE(minQuotient(signal.data(), interference.data(), noise, size) == expected);
+            }
+        }
+        setInstructionSet(defaultInstructionSet);
+    }
+
+    THEN("the scalar kernels are always available and the default is the best one supported")
+    {
+        REQUIRE(isSupported(InstructionSet::scalar));
+        if (isSupported(InstructionSet::avx)) REQUIRE(getInstructionSet() == InstructionSet::avx);
+    }
+
+    THEN("selecting an unsupported instruction set fails and keeps the current one")
+    {
+        for (InstructionSet instructionSet : allInstructionSets) {
+            if (isSupported(instructionSet)) continue;
+            INFO("instruction set " << static_cast<int>(instructionSet));
+            REQUIRE_THROWS_AS(setInstructionSet(instructionSet), omnetpp::cRuntimeError);
+            REQUIRE(getInstructionSet() == defaultInstructionSet);
+        }
+    }
+}
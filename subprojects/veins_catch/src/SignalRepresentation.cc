@@ -22,6 +22,8 @@
 
 #include "catch2/catch.hpp"
 
+#include <cstdint>
+
 #include "veins/base/phyLayer/DeciderToPhyInterface.h"
 #include "veins/base/toolbox/Spectrum.h"
 #include "veins/base/toolbox/Signal.h"
@@ -677,6 +679,91 @@ SCENARIO("Signal Compound Assignment Operators (Two Signals)", "[toolbox]")
     }
 }
 
+SCENARIO("Signal Copies", "[toolbox]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
+    GIVEN("A spectrum with frequencies (1,2,3) and a signal (1,2,3)")
+    {
+        Spectrum::Frequencies freqs = {1, 2, 3};
+
+        Spectrum spectrum(freqs);
+
+        Signal signal(spectrum);
+        signal.at(0) = 1;
+        signal.at(1) = 2;
+        signal.at(2) = 3;
+        const Signal& constSignal = signal;
+
+        WHEN("the signal is copied")
+        {
+            Signal copy(signal);
+            const Signal& constCopy = copy;
+            THEN("both share their values")
+            {
+                REQUIRE(&constCopy.at(0) == &constSignal.at(0));
+            }
+            WHEN("the copy is changed")
+            {
+                copy.at(1) = 5;
+                copy *= 2;
+                THEN("only the copy holds the new values")
+                {
+                    REQUIRE(&constCopy.at(0) != &constSignal.at(0));
+                    REQUIRE(copy.at(0) == 2);
+                    REQUIRE(copy.at(1) == 10);
+                    REQUIRE(copy.at(2) == 6);
+                    REQUIRE(signal.at(0) == 1);
+                    REQUIRE(signal.at(1) == 2);
+                    REQUIRE(signal.at(2) == 3);
+                }
+            }
+            WHEN("the original is multiplied with its shared copy")
+            {
+                signal *= copy;
+                THEN("the original holds the squares and the copy the old values")
+                {
+                    REQUIRE(signal.at(0) == 1);
+                    REQUIRE(signal.at(1) == 4);
+                    REQUIRE(signal.at(2) == 9);
+                    REQUIRE(copy.at(0) == 1);
+                    REQUIRE(copy.at(1) == 2);
+                    REQUIRE(copy.at(2) == 3);
+                }
+            }
+        }
+        WHEN("an AirFrame holding the signal is duplicated")
+        {
+            AirFrame frame;
+            frame.setSignal(signal);
+            std::unique_ptr<AirFrame> copy(frame.dup());
+            THEN("both frames share the values of the signal until one is changed")
+            {
+                const Signal& frameSignal = frame.getSignal();
+                const Signal& copySignal = copy->getSignal();
+                REQUIRE(&copySignal.at(0) == &frameSignal.at(0));
+                copy->getSignal() /= 2;
+                REQUIRE(copySignal.at(2) == 1.5);
+                REQUIRE(frameSignal.at(2) == 3);
+            }
+        }
+        WHEN("a signal of the same spectrum is created after one was destroyed")
+        {
+            const double* released;
+            {
+                Signal temporary(spectrum);
+                released = &static_cast<const Signal&>(temporary).at(0);
+            }
+            Signal next(spectrum);
+            THEN("it re-uses the storage, with aligned values")
+            {
+                REQUIRE(&static_cast<const Signal&>(next).at(0) == released);
+                REQUIRE(reinterpret_cast<uintptr_t>(released) % 16 == 0);
+                REQUIRE(next.at(2) == 0);
+            }
+        }
+    }
+}
+
 SCENARIO("Signal Thresholding (smaller)", "[toolbox]")
 {
     DummySimulation ds(new cNullEnvir(0, nullptr, nullptr)); // necessary so simtime_t works
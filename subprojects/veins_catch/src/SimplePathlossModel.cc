@@ -152,3 +152,39 @@ SCENARIO("SimplePathlossModel with alpha = 2.2", "[analogueModel]")
         }
     }
 }
+
+SCENARIO("SimplePathlossModel bounds its power factor", "[analogueModel]")
+{
+    DummySimulation ds(new cNullEnvir(0, nullptr, nullptr));
+    DummyComponent dc(&ds);
+    std::vector<double> freqs;
+    for (double freq = 2.4e9; freq <= 6.0e9; freq += 0.1e9) freqs.push_back(freq);
+    Spectrum spec(freqs);
+    const Coord senderPos(0, 0, 2);
+
+    GIVEN("SimplePathlossModels with alpha = 2, 2.2 and 3.5")
+    {
+        THEN("getMaxPowerFactor is never below the factor filterSignal applies, for all distances, directions and frequencies")
+        {
+            for (double alpha : {2.0, 2.2, 3.5}) {
+                SimplePathlossModel spm(&dc, alpha, false, {0, 0, 0});
+                for (double distance : {0.0, 0.5, 1.0, 1.5, 2.0, 7.3, 10.0, 99.9, 250.0, 1000.0, 2599.9}) {
+                    for (double angle = 0; angle < 360; angle += 15) {
+                        Coord receiverPos = senderPos + Coord(distance * cos(angle * M_PI / 180), distance * sin(angle * M_PI / 180), 0);
+
+                        Signal s(spec);
+                        s = 1;
+                        s.setSenderPoa({createDummyAntennaPosition(senderPos), {}, nullptr});
+                        s.setReceiverPoa({createDummyAntennaPosition(receiverPos), {}, nullptr});
+                        spm.filterSignal(&s);
+
+                        for (uint16_t i = 0; i < s.getNumValues(); i++) {
+                            INFO("alpha " << alpha << ", distance " << distance << " m, angle " << angle << " deg, frequency " << spec.freqAt(i) << " Hz");
+                            REQUIRE(spm.getMaxPowerFactor(senderPos, receiverPos, spec.freqAt(i)) >= s.at(i));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
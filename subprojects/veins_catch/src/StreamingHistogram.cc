@@ -0,0 +1,126 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include "catch2/catch.hpp"
+
+#include "veins/modules/utility/StreamingHistogram.h"
+
+using veins::StreamingHistogram;
+
+SCENARIO("StreamingHistogram", "[histogram]")
+{
+
+    GIVEN("A histogram of 5 bins of width 1s centered on whole seconds")
+    {
+        StreamingHistogram h(1, 5, -0.5);
+
+        THEN("it is empty")
+        {
+            REQUIRE(h.getCount() == 0);
+            REQUIRE(h.getUsedBins() == 0);
+            REQUIRE(h.getMax() == 0);
+        }
+
+        WHEN("collecting 0.2, 0.7, 1.4, 3.5 and 4.49")
+        {
+            for (double v : {0.2, 0.7, 1.4, 3.5, 4.49}) h.collect(v);
+
+            THEN("every sample is counted in the bin it rounds to")
+            {
+                REQUIRE(h.getBinCount(0) == 1);
+                REQUIRE(h.getBinCount(1) == 2);
+                REQUIRE(h.getBinCount(2) == 0);
+                REQUIRE(h.getBinCount(3) == 0);
+                REQUIRE(h.getBinCount(4) == 2);
+                REQUIRE(h.getUsedBins() == 5);
+            }
+
+            THEN("count, min, max and mean are exact")
+            {
+                REQUIRE(h.getCount() == 5);
+                REQUIRE(h.getMin() == 0.2);
+                REQUIRE(h.getMax() == 4.49);
+                REQUIRE(h.getMean() == Approx((0.2 + 0.7 + 1.4 + 3.5 + 4.49) / 5));
+                REQUIRE(h.getBinPercentage(1) == Approx(40));
+            }
+        }
+
+        WHEN("collecting values outside the range")
+        {
+            h.collect(-1);
+            h.collect(4.5);
+            h.collect(1000, 3);
+
+            THEN("they are counted as under- and overflow")
+            {
+                REQUIRE(h.getUnderflowCount() == 1);
+                REQUIRE(h.getOverflowCount() == 4);
+                REQUIRE(h.getCount() == 5);
+                REQUIRE(h.getUsedBins() == 0);
+                REQUIRE(h.getMax() == 1000);
+            }
+        }
+
+        WHEN("merging a histogram of the same layout")
+        {
+            StreamingHistogram other(1, 5, -0.5);
+            h.collect(1);
+            other.collect(1);
+            other.collect(2);
+            other.collect(7);
+            h.merge(other);
+
+            THEN("it holds the samples of both")
+            {
+                REQUIRE(h.getCount() == 4);
+                REQUIRE(h.getBinCount(1) == 2);
+                REQUIRE(h.getBinCount(2) == 1);
+                REQUIRE(h.getOverflowCount() == 1);
+                REQUIRE(h.getMin() == 1);
+                REQUIRE(h.getMax() == 7);
+            }
+        }
+
+        WHEN("merging a histogram of a different layout")
+        {
+            StreamingHistogram other(2, 5, -0.5);
+
+            THEN("an error is raised")
+            {
+                REQUIRE_THROWS(h.merge(other));
+            }
+        }
+
+        WHEN("clearing it")
+        {
+            h.collect(2);
+            h.clear();
+
+            THEN("it is empty but keeps its layout")
+            {
+                REQUIRE(h.getCount() == 0);
+                REQUIRE(h.getNumBins() == 5);
+                REQUIRE(h.getBinCount(2) == 0);
+            }
+        }
+    }
+}
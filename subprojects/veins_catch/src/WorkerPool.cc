@@ -0,0 +1,98 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+
+#include "catch2/catch.hpp"
+
+#include <atomic>
+#include <stdexcept>
+
+#include "veins/base/utils/WorkerPool.h"
+
+using veins::WorkerPool;
+
+SCENARIO("WorkerPool", "[workerpool]")
+{
+
+    GIVEN("A pool of 4 threads")
+    {
+        WorkerPool pool;
+        pool.start(4);
+
+        THEN("every task runs once on every thread")
+        {
+            REQUIRE(pool.getNumThreads() == 4);
+            for (int round = 0; round < 100; round++) {
+                std::atomic<int> calls[4];
+                for (auto& c : calls) c = 0;
+                pool.run([&](size_t threadIndex) { calls[threadIndex]++; });
+                for (auto& c : calls) REQUIRE(c == 1);
+            }
+        }
+
+        THEN("work handed out dynamically is done exactly once")
+        {
+            std::vector<int> done(10000, 0);
+            std::atomic<size_t> next(0);
+            pool.run([&](size_t) {
+                for (size_t i = next++; i < done.size(); i = next++) done[i]++;
+            });
+            for (int d : done) REQUIRE(d == 1);
+        }
+
+        THEN("exceptions are rethrown and the pool remains usable")
+        {
+            REQUIRE_THROWS_AS(pool.run([](size_t threadIndex) {
+                if (threadIndex == 2) throw std::runtime_error("failed");
+            }),
+                std::runtime_error);
+
+            std::atomic<int> calls(0);
+            pool.run([&](size_t) { calls++; });
+            REQUIRE(calls == 4);
+        }
+
+        THEN("it can be restarted with another number of threads")
+        {
+            pool.start(2);
+            std::atomic<int> calls(0);
+            pool.run([&](size_t) { calls++; });
+            REQUIRE(calls == 2);
+        }
+    }
+
+    GIVEN("A pool of a single thread")
+    {
+        WorkerPool pool;
+        pool.start(1);
+
+        THEN("tasks run on the calling thread")
+        {
+            int calls = 0;
+            pool.run([&](size_t threadIndex) {
+                REQUIRE(threadIndex == 0);
+                calls++;
+            });
+            REQUIRE(calls == 1);
+        }
+    }
+}
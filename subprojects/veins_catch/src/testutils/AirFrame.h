@@ -25,7 +25,7 @@
 
 #include "veins/base/messages/AirFrame_m.h"
 
-veins::AirFrame createAirframe(double centerFreq, double bandwidth, omnetpp::simtime_t start, omnetpp::simtime_t length, double power)
+inline veins::AirFrame createAirframe(double centerFreq, double bandwidth, omnetpp::simtime_t start, omnetpp::simtime_t length, double power)
 {
     veins::Signal s(veins::Spectrum({centerFreq - 5e6, centerFreq, centerFreq + 5e6}), start, length);
     s.atFrequency(centerFreq - 5e6) = power;
@@ -0,0 +1,68 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+#include <fstream>
+#include <iostream>
+
+#include "LogTool.h"
+#include "veins/modules/utility/BinaryContactLog.h"
+
+using namespace veins;
+
+int veins_logtool::exportCsv(const std::vector<std::string>& args)
+{
+    if (args.empty() || args.size() > 2) {
+        std::cerr << "usage: veins_logtool export-csv IN.bin [OUT.csv]" << std::endl;
+        return 2;
+    }
+
+    std::ofstream file;
+    if (args.size() == 2) {
+        file.open(args[1]);
+        if (!file.is_open()) throw std::runtime_error("cannot open \"" + args[1] + "\"");
+    }
+    std::ostream& out = args.size() == 2 ? file : std::cout;
+
+    BinaryContactLog::Reader reader(args[0]);
+    std::vector<BinaryContactLog::Record> records;
+
+    // same columns as the csv variant of the log written by MetricsAnalysisRSUApp
+    out << "seed,scenario,maxSpeed,txPower,simTime,myId,nbId,contactDuration,datetime" << "\n";
+    while (reader.readBlock(records)) {
+        const BinaryContactLog::Header& header = reader.getHeader();
+        for (auto& record : records) {
+            out << header.seed
+                << "," << header.scenarioName
+                << "," << header.laneMaxSpeed
+                << "," << header.txPower
+                << "," << record.simTime
+                << "," << record.myId
+                << "," << record.nbId
+                << "," << BinaryContactLog::formatRawTime(record.contactDurationRaw, header.scaleExponent)
+                << "," << header.dateTime
+                << "\n";
+        }
+    }
+
+    out.flush();
+    return out ? 0 : 1;
+}
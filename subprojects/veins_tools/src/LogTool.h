@@ -0,0 +1,43 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace veins_logtool {
+
+/**
+ * Converts a binary per-second neighbor contact duration log to csv.
+ *
+ * Arguments: IN.bin [OUT.csv], writing to stdout if no output file is given.
+ */
+int exportCsv(const std::vector<std::string>& args);
+
+/**
+ * Computes the aggregated results of any number of csv and binary logs in one pass, using several threads.
+ *
+ * Arguments: [-j THREADS] [-t MINCONTACTDURATIONS] OUTDIR LOG...
+ */
+int processResults(const std::vector<std::string>& args);
+
+} // namespace veins_logtool
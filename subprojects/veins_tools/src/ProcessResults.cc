@@ -0,0 +1,516 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+// Computes the aggregated tables of scripts/process-log-files-and-generate-results.py in one pass over the logs.
+// Unlike the script, the mean values of the vehicles are computed per run (scenario, txPower, seed) instead of pooling
+// all seeds of a log by myId, no maximum contact duration (80 s) or meeting time (20 s) is applied,
+// and percentages are not rounded.
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+#include "LogTool.h"
+#include "veins/modules/utility/BinaryContactLog.h"
+
+using namespace veins;
+
+namespace {
+
+/**
+ * Identifies one simulation run, i.e., one shard of the input.
+ */
+struct RunKey {
+    std::string scenario;
+    std::string txPower;
+    std::string seed;
+
+    bool operator<(const RunKey& other) const
+    {
+        return std::tie(scenario, txPower, seed) < std::tie(other.scenario, other.txPower, other.seed);
+    }
+};
+
+/**
+ * Identifies the runs that are averaged into one table (all seeds of a scenario and txPower).
+ */
+using GroupKey = std::pair<std::string, std::string>;
+
+struct Contact {
+    double startTime;
+    double duration;
+};
+
+struct PerSecondRecord {
+    double numVehicles;
+    double numAvgNbs;
+};
+
+/**
+ * Neighbor degree of one second, from the per-second neighbor contact duration log.
+ */
+struct DegreeRecord {
+    uint64_t numRows = 0;
+    uint64_t numVehicles = 0;
+};
+
+/**
+ * Everything read from the logs of one run.
+ */
+struct RunData {
+    std::map<int64_t, PerSecondRecord> perSecond;
+    std::unordered_map<int64_t, std::vector<Contact>> contacts; ///< per vehicle (myId)
+    std::map<int64_t, DegreeRecord> degree;
+
+    void merge(RunData& other)
+    {
+        perSecond.insert(other.perSecond.begin(), other.perSecond.end());
+        for (auto& vehicle : other.contacts) {
+            auto& mine = contacts[vehicle.first];
+            mine.insert(mine.end(), vehicle.second.begin(), vehicle.second.end());
+        }
+        for (auto& second : other.degree) {
+            degree[second.first].numRows += second.second.numRows;
+            degree[second.first].numVehicles += second.second.numVehicles;
+        }
+    }
+};
+
+using Runs = std::map<RunKey, RunData>;
+
+/**
+ * Distribution of per-vehicle values (rounded to whole seconds) for each minimum contact duration.
+ */
+using Distribution = std::map<double, std::map<double, uint64_t>>;
+
+/**
+ * Results of one run, which are summed up (or averaged) over all runs of a group.
+ */
+struct RunResult {
+    Distribution contactDuration;
+    Distribution meetingTime;
+};
+
+/** @brief Python's round(): halfway cases are rounded to even, as the default floating point rounding mode does */
+double roundHalfEven(double value)
+{
+    return std::nearbyint(value);
+}
+
+std::vector<std::string> splitCsvLine(const std::string& line)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t end = line.find(',', start);
+        fields.push_back(line.substr(start, end == std::string::npos ? std::string::npos : end - start));
+        if (end == std::string::npos) break;
+        start = end + 1;
+    }
+    if (!fields.empty() && !fields.back().empty() && fields.back().back() == '\r') fields.back().pop_back();
+    return fields;
+}
+
+double toDouble(const std::string& field, const std::string& path)
+{
+    char* end;
+    double value = std::strtod(field.c_str(), &end);
+    if (end == field.c_str()) throw std::runtime_error("malformed number \"" + field + "\" in \"" + path + "\"");
+    return value;
+}
+
+std::string formatValue(double value)
+{
+    std::ostringstream os;
+    os << value;
+    return os.str();
+}
+
+/**
+ * Reads one csv log of the MetricsAnalysis apps, determining its kind from the header row.
+ */
+void readCsvLog(const std::string& path, Runs& runs)
+{
+    std::ifstream in(path);
+    if (!in.is_open()) throw std::runtime_error("cannot open \"" + path + "\"");
+
+    std::string headerLine;
+    if (!std::getline(in, headerLine)) return;
+    std::vector<std::string> header = splitCsvLine(headerLine);
+    std::map<std::string, size_t> column;
+    for (size_t i = 0; i < header.size(); i++) column[header[i]] = i;
+
+    auto has = [&column](const char* name) { return column.count(name) > 0; };
+    auto col = [&column](const char* name) { return column.count(name) ? column.at(name) : 0; };
+
+    enum { PER_SECOND, CONTACTS, PER_SECOND_CONTACTS } kind;
+    if (has("numVehicles") && has("numAvgNbs")) {
+        kind = PER_SECOND;
+    }
+    else if (has("startTime") && has("contactDuration")) {
+        kind = CONTACTS;
+    }
+    else if (has("simTime") && has("myId") && has("nbId")) {
+        kind = PER_SECOND_CONTACTS;
+    }
+    else {
+        std::cerr << "veins_logtool results: skipping \"" << path << "\" (not a per-second, contact duration or per-second contact duration log)" << std::endl;
+        return;
+    }
+
+    size_t seedCol = col("seed");
+    size_t scenarioCol = col("scenario");
+    size_t txPowerCol = col("txPower");
+    size_t simTimeCol = col("simTime");
+    size_t myIdCol = col("myId");
+    size_t numVehiclesCol = col("numVehicles");
+    size_t numAvgNbsCol = col("numAvgNbs");
+    size_t startTimeCol = col("startTime");
+    size_t contactDurationCol = col("contactDuration");
+    if (!has("seed") || !has("scenario") || !has("txPower")) throw std::runtime_error("missing seed, scenario or txPower column in \"" + path + "\"");
+
+    // rows of a run are contiguous and ordered by simTime, so the vehicles of the current second are tracked in a set
+    RunData* run = nullptr;
+    RunKey key;
+    int64_t currentSecond = -1;
+    std::set<int64_t> currentVehicles;
+    auto finishSecond = [&run, &currentSecond, &currentVehicles]() {
+        if (run && currentSecond >= 0) run->degree[currentSecond].numVehicles += currentVehicles.size();
+        currentVehicles.clear();
+    };
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line == headerLine) continue;
+        std::vector<std::string> fields = splitCsvLine(line);
+        if (fields.size() < header.size()) throw std::runtime_error("truncated row \"" + line + "\" in \"" + path + "\"");
+
+        if (!run || fields[seedCol] != key.seed || fields[scenarioCol] != key.scenario || fields[txPowerCol] != key.txPower) {
+            finishSecond();
+            key = {fields[scenarioCol], fields[txPowerCol], fields[seedCol]};
+            run = &runs[key];
+            currentSecond = -1;
+        }
+
+        switch (kind) {
+        case PER_SECOND:
+            run->perSecond[static_cast<int64_t>(toDouble(fields[simTimeCol], path))] = {toDouble(fields[numVehiclesCol], path), toDouble(fields[numAvgNbsCol], path)};
+            break;
+        case CONTACTS:
+            run->contacts[static_cast<int64_t>(toDouble(fields[myIdCol], path))].push_back({toDouble(fields[startTimeCol], path), toDouble(fields[contactDurationCol], path)});
+            break;
+        case PER_SECOND_CONTACTS: {
+            int64_t second = static_cast<int64_t>(toDouble(fields[simTimeCol], path));
+            if (second != currentSecond) {
+                finishSecond();
+                currentSecond = second;
+            }
+            run->degree[second].numRows++;
+            currentVehicles.insert(static_cast<int64_t>(toDouble(fields[myIdCol], path)));
+            break;
+        }
+        }
+    }
+    finishSecond();
+}
+
+/**
+ * Reads one binary per-second neighbor contact duration log (see BinaryContactLog).
+ */
+void readBinaryLog(const std::string& path, Runs& runs)
+{
+    BinaryContactLog::Reader reader(path);
+    std::vector<BinaryContactLog::Record> records;
+
+    size_t currentRun = 0;
+    RunData* run = nullptr;
+    int64_t currentSecond = -1;
+    std::set<int64_t> currentVehicles;
+    auto finishSecond = [&run, &currentSecond, &currentVehicles]() {
+        if (run && currentSecond >= 0) run->degree[currentSecond].numVehicles += currentVehicles.size();
+        currentVehicles.clear();
+    };
+
+    while (reader.readBlock(records)) {
+        if (reader.getNumRuns() != currentRun) {
+            finishSecond();
+            const BinaryContactLog::Header& header = reader.getHeader();
+            run = &runs[{header.scenarioName, formatValue(header.txPower), std::to_string(header.seed)}];
+            currentRun = reader.getNumRuns();
+            currentSecond = -1;
+        }
+        for (auto& record : records) {
+            if (record.simTime != currentSecond) {
+                finishSecond();
+                currentSecond = record.simTime;
+            }
+            run->degree[record.simTime].numRows++;
+            currentVehicles.insert(record.myId);
+        }
+    }
+    finishSecond();
+}
+
+void readLog(const std::string& path, Runs& runs)
+{
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".bin") == 0) {
+        readBinaryLog(path, runs);
+    }
+    else {
+        readCsvLog(path, runs);
+    }
+}
+
+/**
+ * Computes the distributions of one run, as calculateAverageContactDuration and calculateDurationOfMeetingNewNb do:
+ * for each vehicle, only its contacts lasting at least the minimum contact duration are considered,
+ * the vehicle's mean contact duration and mean time between the start of two consecutive contacts
+ * are rounded to whole seconds and counted.
+ */
+RunResult processRun(RunData& run, const std::vector<double>& minContactDurations)
+{
+    RunResult result;
+    std::vector<Contact> contacts;
+
+    for (auto& vehicle : run.contacts) {
+        std::sort(vehicle.second.begin(), vehicle.second.end(), [](const Contact& a, const Contact& b) { return a.startTime < b.startTime; });
+
+        for (double minContactDuration : minContactDurations) {
+            contacts.clear();
+            for (auto& contact : vehicle.second) {
+                if (contact.duration >= minContactDuration) contacts.push_back(contact);
+            }
+            if (contacts.empty()) continue;
+
+            double sumDuration = 0;
+            for (auto& contact : contacts) sumDuration += contact.duration;
+            result.contactDuration[minContactDuration][roundHalfEven(sumDuration / contacts.size())]++;
+
+            if (contacts.size() < 2) continue;
+            double meanMeetingTime = (contacts.back().startTime - contacts.front().startTime) / (contacts.size() - 1);
+            result.meetingTime[minContactDuration][roundHalfEven(meanMeetingTime)]++;
+        }
+    }
+
+    // the contacts are not needed any more, free their memory early
+    std::unordered_map<int64_t, std::vector<Contact>>().swap(run.contacts);
+    return result;
+}
+
+void writeDistribution(std::ostream& out, const GroupKey& group, const Distribution& distribution)
+{
+    for (auto& threshold : distribution) {
+        uint64_t total = 0;
+        for (auto& value : threshold.second) total += value.second;
+
+        uint64_t cumulative = 0;
+        for (auto& value : threshold.second) {
+            cumulative += value.second;
+            out << group.first
+                << "," << group.second
+                << "," << threshold.first
+                << "," << value.first
+                << "," << value.second
+                << "," << 100.0 * value.second / total
+                << "," << 100.0 * cumulative / total
+                << "," << 100.0 * (total - cumulative + value.second) / total
+                << "\n";
+        }
+    }
+}
+
+void openOutput(std::ofstream& out, const std::string& path)
+{
+    out.open(path);
+    if (!out.is_open()) throw std::runtime_error("cannot open \"" + path + "\"");
+}
+
+/**
+ * Runs job(i) for i in [0, n) on the given number of threads, rethrowing the first error.
+ */
+template <typename Job>
+void parallelFor(size_t n, unsigned numThreads, Job job)
+{
+    std::atomic<size_t> next(0);
+    std::mutex errorMutex;
+    std::string error;
+
+    auto worker = [&]() {
+        while (true) {
+            size_t i = next++;
+            if (i >= n) return;
+            try {
+                job(i);
+            }
+            catch (std::exception& e) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (error.empty()) error = e.what();
+                next = n;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < std::min<size_t>(numThreads, n); t++) threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads) thread.join();
+
+    if (!error.empty()) throw std::runtime_error(error);
+}
+
+} // namespace
+
+int veins_logtool::processResults(const std::vector<std::string>& args)
+{
+    unsigned numThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<double> minContactDurations = {0, 3, 10, 25, 40};
+    std::vector<std::string> paths;
+
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "-j" && i + 1 < args.size()) {
+            numThreads = std::max(1, std::atoi(args[++i].c_str()));
+        }
+        else if (args[i] == "-t" && i + 1 < args.size()) {
+            minContactDurations.clear();
+            std::istringstream thresholds(args[++i]);
+            std::string threshold;
+            while (std::getline(thresholds, threshold, ',')) minContactDurations.push_back(toDouble(threshold, "-t"));
+        }
+        else {
+            paths.push_back(args[i]);
+        }
+    }
+    if (paths.size() < 2) {
+        std::cerr << "usage: veins_logtool results [-j THREADS] [-t MINCONTACTDURATIONS] OUTDIR LOG..." << std::endl;
+        std::cerr << "unlike scripts/process-log-files-and-generate-results.py, vehicles are evaluated per run (scenario, txPower, seed)" << std::endl;
+        std::cerr << "instead of pooling all seeds by myId, and no maximum contact duration or meeting time is applied" << std::endl;
+        return 2;
+    }
+    std::string outDir = paths.front();
+    paths.erase(paths.begin());
+
+    // read all logs in parallel (one file per thread), each into its own runs
+    std::vector<Runs> runsPerFile(paths.size());
+    parallelFor(paths.size(), numThreads, [&](size_t i) { readLog(paths[i], runsPerFile[i]); });
+
+    // merge the logs of the same runs, e.g., the per-second and the contact duration log of one seed
+    Runs runs;
+    for (auto& fileRuns : runsPerFile) {
+        for (auto& run : fileRuns) runs[run.first].merge(run.second);
+        Runs().swap(fileRuns);
+    }
+
+    // process all runs in parallel
+    std::vector<Runs::iterator> shards;
+    for (auto i = runs.begin(); i != runs.end(); ++i) shards.push_back(i);
+    std::vector<RunResult> results(shards.size());
+    parallelFor(shards.size(), numThreads, [&](size_t i) { results[i] = processRun(shards[i]->second, minContactDurations); });
+
+    // reduce the runs of each group: distributions are summed up, per second values averaged over the runs
+    struct PerSecondSum {
+        uint64_t numRuns = 0;
+        double numVehicles = 0;
+        double numAvgNbs = 0;
+        uint64_t numDegreeRuns = 0;
+        double nbDegree = 0;
+    };
+    std::map<GroupKey, std::map<int64_t, PerSecondSum>> perSecond;
+    std::map<GroupKey, RunResult> groups;
+
+    for (size_t i = 0; i < shards.size(); i++) {
+        GroupKey group(shards[i]->first.scenario, shards[i]->first.txPower);
+        RunData& run = shards[i]->second;
+
+        auto& groupPerSecond = perSecond[group];
+        for (auto& second : run.perSecond) {
+            PerSecondSum& sum = groupPerSecond[second.first];
+            sum.numRuns++;
+            sum.numVehicles += second.second.numVehicles;
+            sum.numAvgNbs += second.second.numAvgNbs;
+        }
+        for (auto& second : run.degree) {
+            if (second.second.numVehicles == 0) continue;
+            PerSecondSum& sum = groupPerSecond[second.first];
+            sum.numDegreeRuns++;
+            sum.nbDegree += static_cast<double>(second.second.numRows) / second.second.numVehicles;
+        }
+
+        RunResult& groupResult = groups[group];
+        for (auto& threshold : results[i].contactDuration) {
+            for (auto& value : threshold.second) groupResult.contactDuration[threshold.first][value.first] += value.second;
+        }
+        for (auto& threshold : results[i].meetingTime) {
+            for (auto& value : threshold.second) groupResult.meetingTime[threshold.first][value.first] += value.second;
+        }
+    }
+
+    std::ofstream perSecondOut;
+    openOutput(perSecondOut, outDir + "/perSecondNumVehiclesAndNumNbs.csv");
+    perSecondOut << "scenario,txPower,simTime,numRuns,meanNumVehicles,meanNumAvgNbs,meanNbDegree\n";
+    for (auto& group : perSecond) {
+        for (auto& second : group.second) {
+            const PerSecondSum& sum = second.second;
+            perSecondOut << group.first.first
+                         << "," << group.first.second
+                         << "," << second.first
+                         << "," << sum.numRuns;
+            if (sum.numRuns > 0) {
+                perSecondOut << "," << sum.numVehicles / sum.numRuns << "," << sum.numAvgNbs / sum.numRuns;
+            }
+            else {
+                perSecondOut << ",,";
+            }
+            if (sum.numDegreeRuns > 0) {
+                perSecondOut << "," << sum.nbDegree / sum.numDegreeRuns;
+            }
+            else {
+                perSecondOut << ",";
+            }
+            perSecondOut << "\n";
+        }
+    }
+
+    std::ofstream contactDurationOut;
+    openOutput(contactDurationOut, outDir + "/contactDurationDistribution.csv");
+    contactDurationOut << "scenario,txPower,minContactDuration,contactDuration,numVehicles,percentVehicles,cumPercentVehiclesLessOrEqual,cumPercentVehiclesMoreOrEqual\n";
+    for (auto& group : groups) writeDistribution(contactDurationOut, group.first, group.second.contactDuration);
+
+    std::ofstream meetingTimeOut;
+    openOutput(meetingTimeOut, outDir + "/meetingTimeDistribution.csv");
+    meetingTimeOut << "scenario,txPower,minContactDuration,meetingTime,numVehicles,percentVehicles,cumPercentVehiclesLessOrEqual,cumPercentVehiclesMoreOrEqual\n";
+    for (auto& group : groups) writeDistribution(meetingTimeOut, group.first, group.second.meetingTime);
+
+    perSecondOut.flush();
+    contactDurationOut.flush();
+    meetingTimeOut.flush();
+    return (perSecondOut && contactDurationOut && meetingTimeOut) ? 0 : 1;
+}
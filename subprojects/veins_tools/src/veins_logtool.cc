@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2020 Yasir Saleem (www.yasirsaleem.com)
+//
+// Documentation for these modules is at http://veins.car2x.org/
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+
+// Entry point of veins_logtool, dispatching to one of the commands declared in LogTool.h
+
+#include <iostream>
+
+#include "LogTool.h"
+
+namespace {
+
+struct Command {
+    const char* name;
+    const char* usage;
+    int (*run)(const std::vector<std::string>& args);
+};
+
+const Command commands[] = {
+    {"export-csv", "IN.bin [OUT.csv]", veins_logtool::exportCsv},
+    {"results", "[-j THREADS] [-t MINCONTACTDURATIONS] OUTDIR LOG...", veins_logtool::processResults},
+};
+
+int usage()
+{
+    std::cerr << "usage: veins_logtool COMMAND [ARGS...]" << std::endl;
+    std::cerr << "commands:" << std::endl;
+    for (auto& command : commands) {
+        std::cerr << "  " << command.name << " " << command.usage << std::endl;
+    }
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) return usage();
+
+    std::string name = argv[1];
+    std::vector<std::string> args(argv + 2, argv + argc);
+    for (auto& command : commands) {
+        if (name != command.name) continue;
+        try {
+            return command.run(args);
+        }
+        catch (std::exception& e) {
+            std::cerr << "veins_logtool " << name << ": " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return usage();
+}